@@ -61,6 +61,8 @@ caQtDM_Plugins.depends = caQtDM_Lib
 !android {
    SUBDIRS += parser
    parser.file = caQtDM_Viewer/parser/parser.pro
+   SUBDIRS += compiler
+   compiler.file = caQtDM_Viewer/compiler/compiler.pro
 }
 }
 
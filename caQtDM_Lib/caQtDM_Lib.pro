@@ -45,7 +45,9 @@ SOURCES += caqtdm_lib.cpp \
     limitsDialog.cpp \
     sliderDialog.cpp \
     splashscreen.cpp \
-    loadPlugins.cpp
+    loadPlugins.cpp \
+    macroengine.cpp \
+    displaytrace.cpp
     
 HEADERS += caqtdm_lib.h\
         caQtDM_Lib_global.h \
@@ -67,6 +69,8 @@ HEADERS += caqtdm_lib.h\
     epicsExternals.h \
     inlines.h \
     loadPlugins.h \
+    macroengine.h \
+    displaytrace.h \
     caqtdm_lib_interface.h
 
 !MOBILE {
@@ -29,8 +29,8 @@ INCLUDEPATH    += $(EPICSINCLUDE)/os/Linux
 INCLUDEPATH   += $(EPICSINCLUDE)/compiler/gcc
 
 INCLUDEPATH    += $(QWTINCLUDE)
-HEADERS         = ../../controlsinterface.h archiveCA_plugin.h ../archiverCommon.h
-SOURCES         =  archiveCA_plugin.cpp ../archiverCommon.cpp
+HEADERS         = ../../controlsinterface.h archiveCA_plugin.h ../archiverCommon.h ../archiveExecutor.h ../archiveDiskCache.h
+SOURCES         =  archiveCA_plugin.cpp ../archiverCommon.cpp ../archiveExecutor.cpp ../archiveDiskCache.cpp
 TARGET          = archiveCA_plugin
 
 LIBS += -L$(EPICSLIB) -Wl,-rpath,$(EPICSLIB) -lca -lCom
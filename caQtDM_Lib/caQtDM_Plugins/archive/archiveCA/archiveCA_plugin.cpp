@@ -24,7 +24,6 @@
  */
 #include <QDebug>
 #include <QApplication>
-#include <QThread>
 #include "archiveCA_plugin.h"
 #include "archiverCommon.h"
 
@@ -44,15 +43,20 @@ ArchiveCA_Plugin::ArchiveCA_Plugin()
     qRegisterMetaType<QVector<double> >("QVector<double>");
 
     qDebug() << "ArchiveCA_Plugin: Create (epics channel archiver retrieval)";
-    archiverCommon = new ArchiverCommon();
+    archiverCommon = new ArchiverCommon(pluginName());
+
+    // the archive library is used by one retrieval at a time
+    executor = new ArchiveExecutor(1, 1);
 
     connect(archiverCommon, SIGNAL(Signal_UpdateInterface(QMap<QString, indexes>)), this,SLOT(Callback_UpdateInterface(QMap<QString, indexes>)));
+    connect(archiverCommon, SIGNAL(Signal_AbortOutstandingRequests(QString)), this,SLOT(Callback_AbortOutstandingRequests(QString)));
     connect(this, SIGNAL(Signal_StopUpdateInterface()), archiverCommon,SLOT(stopUpdateInterface()));
     connect(qApp, SIGNAL(aboutToQuit()), this, SLOT(closeEvent()));
 }
 
 void ArchiveCA_Plugin::closeEvent(){
    qDebug() << "ArchiveCA_Plugin::closeEvent ";
+   executor->cancelAll();
    emit Signal_StopUpdateInterface();
 }
 
@@ -64,12 +68,15 @@ int ArchiveCA_Plugin::initCommunicationLayer(MutexKnobData *data, MessageWindow
     return archiverCommon->initCommunicationLayer(data, messageWindow, options);
 }
 
+void ArchiveCA_Plugin::Callback_AbortOutstandingRequests(QString key)
+{
+    executor->cancel(key);
+}
+
 // this routine will be called now every 10 seconds to update the cartesianplot
 // however when many data it may take much longer, then  suppress any new request
 void ArchiveCA_Plugin::Callback_UpdateInterface( QMap<QString, indexes> listOfIndexes)
 {
-    int nbVal;
-
     precision = 5;
 
     // Index name
@@ -80,22 +87,11 @@ void ArchiveCA_Plugin::Callback_UpdateInterface( QMap<QString, indexes> listOfIn
     QMap<QString, indexes>::const_iterator i = listOfIndexes.constBegin();
 
     while (i != listOfIndexes.constEnd()) {
-        QThread *tmpThread = (QThread *) 0;
         indexes indexNew = i.value();
         //qDebug() << i.key() << ": " << indexNew.indexX << indexNew.indexY << indexNew.pv << indexNew.w << endl;
 
-        nbVal = 0;
-
-        QMap<QString, QThread *>::iterator j = listOfThreads.find(indexNew.key);
-        while (j !=listOfThreads.end() && j.key() == indexNew.key) {
-            tmpThread = (QThread *) j.value();
-            ++j;
-        }
-
-        //qDebug() << "tmpThread" << tmpThread;
-
-        if((tmpThread != (QThread *) 0) && tmpThread->isRunning()) {
-            //qDebug() << "workerthread is running" << tmpThread->isRunning();
+        if(executor->isOutstanding(indexNew.key)) {
+            //qDebug() << "retrieval is outstanding" << indexNew.key;
         } else {
 
             // Get Index name if specified for this widget
@@ -110,20 +106,14 @@ void ArchiveCA_Plugin::Callback_UpdateInterface( QMap<QString, indexes> listOfIn
                 }
             }
 
-            WorkerCA *worker = new WorkerCA;
-            QThread *tmpThread = new QThread;
-            listOfThreads.insert(i.key(), tmpThread);
-            worker->moveToThread(tmpThread);
-            connect(tmpThread, SIGNAL(finished()), worker, SLOT(workerFinish()));
-            connect(tmpThread, SIGNAL(finished()), tmpThread, SLOT(deleteLater()) );
-            connect(this, SIGNAL(operate( QWidget *, indexes, const stdString)), worker,
-                    SLOT(getFromArchive(QWidget *, indexes, stdString)));
+            WorkerCA *worker = new WorkerCA(indexNew, index_name, messagewindowP);
+            worker->key = indexNew.key;
+            worker->priority = ArchiveExecutor::priorityOf(indexNew.w);
             connect(worker, SIGNAL(resultReady(indexes, int, QVector<double>, QVector<double>, QString)), this,
                     SLOT(handleResults(indexes, int, QVector<double>, QVector<double>, QString)));
-            tmpThread->start();
 
-            //qDebug() << "CA emit operate";
-            emit operate((QWidget *) messagewindowP ,indexNew, index_name);
+            //qDebug() << "CA enqueue";
+            executor->enqueue(worker);
         }
         ++i;
     }
@@ -133,29 +123,12 @@ void ArchiveCA_Plugin::handleResults(indexes indexNew, int nbVal, QVector<double
 {
     //qDebug() << "in CA handle results" << nbVal << TimerN.count();
 
-    if(nbVal > 0) {
-        TimerN.resize(nbVal);
-        YValsN.resize(nbVal);
-        archiverCommon->updateCartesian(nbVal, indexNew, TimerN, YValsN, backend);
-        TimerN.resize(0);
-        YValsN.resize(0);
-    }
-
-    QList<QString> removeKeys;
-    removeKeys.clear();
-
-    QMap<QString, QThread *>::iterator j = listOfThreads.find(indexNew.key);
-    while (j !=listOfThreads.end() && j.key() == indexNew.key) {
-        QThread *tmpThread = (QThread*) j.value();
-        tmpThread->quit();
-        removeKeys.append(indexNew.key);
-        //qDebug() << tmpThread << "ca quit";
-        ++j;
-    }
-
-    for(int i=0; i< removeKeys.count(); i++) {
-        listOfThreads.remove(removeKeys.at(i));
-    }
+    // also without new samples, the window moves on
+    TimerN.resize(nbVal);
+    YValsN.resize(nbVal);
+    archiverCommon->updateCartesian(nbVal, indexNew, TimerN, YValsN, backend);
+    TimerN.resize(0);
+    YValsN.resize(0);
 }
 
 // define data to be called
@@ -36,6 +36,7 @@
 #include "controlsinterface.h"
 #include "archiveCA_plugin.h"
 #include "archiverCommon.h"
+#include "archiveExecutor.h"
 
 // Base
 #include <epicsVersion.h>
@@ -55,19 +56,25 @@
 static int precision;
 static RawValue::NumberFormat format = RawValue::DEFAULT;
 
-class Q_DECL_EXPORT WorkerCA : public QObject
+class Q_DECL_EXPORT WorkerCA : public archiveBlockingRetrieval
 {
     Q_OBJECT
 
 public:
-    WorkerCA() {
+    WorkerCA(indexes index, stdString indexName, MessageWindow *messageWindow) {
         qRegisterMetaType<indexes>("indexes");
         qRegisterMetaType<stdString>("stdString");
         qRegisterMetaType<QVector<double> >("QVector<double>");
+        indexNew = index;
+        index_name = indexName;
+        messagewindowP = messageWindow;
     }
 
 private:
     QVector<double>  TimerN, YValsN;
+    indexes indexNew;
+    stdString index_name;
+    MessageWindow *messagewindowP;
 
     void format_time(const epicsTime &time, stdString &text,  time_t &timeStamp)
     {
@@ -79,14 +86,10 @@ private:
         return;
     }
 
-public slots:
-
-    void workerFinish() {
-        //qDebug() << "worker finish";
-        deleteLater();
-    }
+public:
 
-    void getFromArchive(QWidget *w, indexes indexNew,  stdString index_name) {
+    // runs in a thread of the executor
+    void retrieve() {
 
         time_t timeStamp;
         struct timeb now;
@@ -95,7 +98,6 @@ public slots:
 
         format = RawValue::DECIMAL;
         time_t endSeconds, startSeconds;
-        MessageWindow *messagewindowP = (MessageWindow *) w;
 
         QMutex *mutex = indexNew.mutexP;
         mutex->lock();
@@ -104,6 +106,9 @@ public slots:
         endSeconds = (time_t) ((double) now.time + (double) now.millitm / (double)1000);
         startSeconds = (time_t) (endSeconds - indexNew.secondsPast);
 
+        // when samples are held, only the newer ones are requested
+        if(indexNew.lastSampleTime > startSeconds) startSeconds = (time_t) indexNew.lastSampleTime;
+
         timess_end = localtime(&endSeconds);
         sprintf(endTime,   "%02d/%02d/%04d %02d:%02d:%02d ", timess_end->tm_mon+1, timess_end->tm_mday, timess_end->tm_year+1900,
                 timess_end->tm_hour, timess_end->tm_min, timess_end->tm_sec);
@@ -133,6 +138,8 @@ public slots:
         if(!index.open(index_name.c_str(), error, true)) {
             if(messagewindowP != (MessageWindow *) 0) messagewindowP->postMsgEvent(QtCriticalMsg, error);
             emit resultReady(indexNew, 0, TimerN, YValsN , "");
+            mutex->unlock();
+            return;
         }
 
         // get data
@@ -161,7 +168,7 @@ public slots:
                     RawValue::getValueString( val, sheet.getType(0), sheet.getCount(0), value, &sheet.getInfo(0), format, precision);
                     QString value(val.c_str());
                     if((timeStamp - endSeconds) >= -indexNew.secondsPast) {
-                        TimerN[nbVal] = (timeStamp - endSeconds) / 3600.0;
+                        TimerN[nbVal] = timeStamp;
                         YValsN[nbVal] = value.toDouble();
                         nbVal++;
                     }
@@ -216,13 +223,13 @@ protected:
 private slots:
     void updateValues();
     void Callback_UpdateInterface( QMap<QString, indexes> listOfIndexes);
+    void Callback_AbortOutstandingRequests(QString key);
 
 public slots:
     void handleResults(indexes, int, QVector<double>, QVector<double>, QString backend);
     void closeEvent();
 
 signals:
-    void operate(QWidget*, const indexes, const stdString);
     void Signal_StopUpdateInterface();
 
 private:
@@ -230,7 +237,7 @@ private:
     MutexKnobData *mutexknobdataP;
     MessageWindow *messagewindowP;
     ArchiverCommon *archiverCommon;
-    QMap<QString, QThread*> listOfThreads;
+    ArchiveExecutor *executor;
 };
 
 #endif
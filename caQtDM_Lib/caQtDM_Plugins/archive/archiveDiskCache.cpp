@@ -0,0 +1,163 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2014
+ *
+ *  Author:
+ *    Anton Mezger
+ *  Contact details:
+ *    anton.mezger@psi.ch
+ */
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QCryptographicHash>
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include "archiveDiskCache.h"
+#include "specialFunctions.h"
+
+#define CHUNKSECONDS 3600       // time slice of a chunk
+#define CHUNKMAGIC "caQtDMc1"
+
+struct chunkHeader {char magic[8]; qint64 chunk; qint64 count;};
+
+// the cache is in the standard path of caQtDM, unless the environment variable CAQTDM_ARCHIVE_CACHE gives
+// another directory or is set to none
+ArchiveDiskCache::ArchiveDiskCache(const QString &pluginName)
+{
+    Specials specials;
+    QString path = (QString) qgetenv("CAQTDM_ARCHIVE_CACHE");
+    if(path.size() == 0) path = specials.getStdPath() + "/archiveCache";
+    enabled = (pluginName.size() > 0) && (QString::compare(path, "none", Qt::CaseInsensitive) != 0);
+    directory = path + "/" + pluginName;
+    if(enabled) enabled = QDir().mkpath(directory);
+    if(!enabled) qDebug() << "ArchivePlugin: no disk cache for" << pluginName;
+}
+
+// the series key contains the pv, the backend and the archiver url, so it is hashed for a directory name
+QString ArchiveDiskCache::seriesDirectory(const QString &series) const
+{
+    QByteArray hash = QCryptographicHash::hash(series.toUtf8(), QCryptographicHash::Sha1).toHex();
+    return directory + "/" + QString(hash);
+}
+
+QString ArchiveDiskCache::chunkFile(const QString &series, qint64 chunk) const
+{
+    return seriesDirectory(series) + "/" + QString::number(chunk) + ".chunk";
+}
+
+// appends the samples from the chunks on disk, beginning with the chunk of from and stopping at the first chunk
+// missing or reaching to; gives back the end of the last chunk read (0 when none), up to which the samples are complete
+double ArchiveDiskCache::load(const QString &series, double from, double to, archiveSamples &samples)
+{
+    double loadedUntil = 0.0;
+    if(!enabled) return loadedUntil;
+
+    for(qint64 chunk = (qint64) floor(from / CHUNKSECONDS); (double) (chunk + 1) * CHUNKSECONDS <= to; chunk++) {
+        QFile file(chunkFile(series, chunk));
+        if(!file.open(QIODevice::ReadOnly)) break;
+
+        qint64 size = file.size();
+        if(size < (qint64) sizeof(chunkHeader)) break;
+        uchar *map = file.map(0, size);
+        if(map == (uchar *) 0) break;
+
+        chunkHeader header;
+        memcpy(&header, map, sizeof(chunkHeader));
+        if((memcmp(header.magic, CHUNKMAGIC, sizeof(header.magic)) != 0) || (header.chunk != chunk) ||
+           (header.count < 0) || (size != (qint64) sizeof(chunkHeader) + header.count * 2 * (qint64) sizeof(double))) {
+            qDebug() << "ArchivePlugin: corrupt cache chunk" << file.fileName();
+            file.unmap(map);
+            file.remove();
+            break;
+        }
+
+        const double *times = (const double *) (map + sizeof(chunkHeader));
+        const double *values = times + header.count;
+        int first = std::lower_bound(times, times + header.count, from) - times;
+        for(qint64 i = first; i < header.count; i++) {
+            samples.times.append(times[i]);
+            samples.values.append(values[i]);
+        }
+        file.unmap(map);
+        loadedUntil = (double) (chunk + 1) * CHUNKSECONDS;
+    }
+    return loadedUntil;
+}
+
+// writes the chunks lying completely between from and to; gives back the end of the last chunk written (0 when none)
+double ArchiveDiskCache::store(const QString &series, const archiveSamples &samples, double from, double to)
+{
+    if(!enabled) return 0.0;
+
+    qint64 first = (qint64) ceil(from / CHUNKSECONDS);
+    qint64 last = (qint64) floor(to / CHUNKSECONDS);
+    if(first >= last) return 0.0;
+    if(!QDir().mkpath(seriesDirectory(series))) return 0.0;
+
+    const double *times = samples.times.constData();
+    const int count = samples.times.count();
+    for(qint64 chunk = first; chunk < last; chunk++) {
+        int begin = std::lower_bound(times, times + count, (double) chunk * CHUNKSECONDS) - times;
+        int end = std::lower_bound(times, times + count, (double) (chunk + 1) * CHUNKSECONDS) - times;
+
+        chunkHeader header;
+        memcpy(header.magic, CHUNKMAGIC, sizeof(header.magic));
+        header.chunk = chunk;
+        header.count = end - begin;
+
+        // written under another name first, a chunk is either complete or not there
+        QString fileName = chunkFile(series, chunk);
+        QFile file(fileName + ".tmp");
+        if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return 0.0;
+        bool ok = (file.write((const char *) &header, sizeof(chunkHeader)) == (qint64) sizeof(chunkHeader));
+        if(ok) ok = (file.write((const char *) (times + begin), header.count * sizeof(double)) == header.count * (qint64) sizeof(double));
+        if(ok) ok = (file.write((const char *) (samples.values.constData() + begin), header.count * sizeof(double)) == header.count * (qint64) sizeof(double));
+        file.close();
+        QFile::remove(fileName);
+        if(!ok || !file.rename(fileName)) {
+            file.remove();
+            return 0.0;
+        }
+    }
+    return (double) last * CHUNKSECONDS;
+}
+
+// removes the chunks older than the time given and the series left without chunks
+void ArchiveDiskCache::prune(double olderThan)
+{
+    if(!enabled) return;
+
+    QDir cache(directory);
+    QStringList seriesDirectories = cache.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    foreach(QString name, seriesDirectories) {
+        QDir dir(cache.filePath(name));
+        QFileInfoList chunks = dir.entryInfoList(QDir::Files);
+        int kept = 0;
+        foreach(QFileInfo info, chunks) {
+            bool ok;
+            qint64 chunk = info.completeBaseName().toLongLong(&ok);
+            if(ok && info.suffix() == "chunk" && ((double) (chunk + 1) * CHUNKSECONDS >= olderThan)) kept++;
+            else QFile::remove(info.filePath());
+        }
+        if(kept == 0) cache.rmdir(name);
+    }
+}
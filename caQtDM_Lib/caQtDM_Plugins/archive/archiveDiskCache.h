@@ -0,0 +1,54 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2014
+ *
+ *  Author:
+ *    Anton Mezger
+ *  Contact details:
+ *    anton.mezger@psi.ch
+ */
+
+#ifndef ArchiveDiskCache_H
+#define ArchiveDiskCache_H
+
+#include <QString>
+#include "archiverCommon.h"
+
+// the closed time chunks of the series kept on disk, so that reopening a display only requests the samples
+// of the chunks missing or still open. a chunk holds a fixed slice of time of one series and is written once,
+// when it lies completely in the samples received and is old enough for the archive to be complete; the file
+// is a small header followed by the times and the values as float64 columns, it is memory mapped for reading
+class Q_DECL_EXPORT ArchiveDiskCache
+{
+public:
+    ArchiveDiskCache(const QString &pluginName);
+
+    bool isEnabled() const {return enabled;}
+    double load(const QString &series, double from, double to, archiveSamples &samples);
+    double store(const QString &series, const archiveSamples &samples, double from, double to);
+    void prune(double olderThan);
+
+private:
+    QString seriesDirectory(const QString &series) const;
+    QString chunkFile(const QString &series, qint64 chunk) const;
+
+    QString directory;
+    bool enabled;
+};
+
+#endif
@@ -0,0 +1,137 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2014
+ *
+ *  Author:
+ *    Anton Mezger
+ *  Contact details:
+ *    anton.mezger@psi.ch
+ */
+
+#include <QDebug>
+#include <QRunnable>
+#include <QMetaObject>
+#include "archiveExecutor.h"
+
+// runs a blocking retrieval in a thread of the pool, done() is given back to the gui thread
+class archiveTask : public QRunnable
+{
+public:
+    archiveTask(archiveBlockingRetrieval *retrieval) {
+        this->retrieval = retrieval;
+    }
+
+    void run() {
+        if(!retrieval->isCancelled()) retrieval->retrieve();
+        QMetaObject::invokeMethod(retrieval, "done", Qt::QueuedConnection);
+    }
+
+private:
+    archiveBlockingRetrieval *retrieval;
+};
+
+void archiveBlockingRetrieval::start(QThreadPool *pool)
+{
+    pool->start(new archiveTask(this), priority);
+}
+
+ArchiveExecutor::ArchiveExecutor(int threads, int limit)
+{
+    pool.setMaxThreadCount(qMax(threads, 1));
+    defaultLimit = qMax(limit, 1);
+}
+
+void ArchiveExecutor::setLimit(const QString &backend, int limit)
+{
+    limits.insert(backend, qMax(limit, 1));
+}
+
+// retrievals of the same priority are started in the order they came
+void ArchiveExecutor::enqueue(archiveRetrieval *retrieval)
+{
+    int i = queued.count();
+    while(i > 0 && queued.at(i-1)->priority < retrieval->priority) --i;
+    queued.insert(i, retrieval);
+    schedule();
+}
+
+// a cancelled retrieval still running does not hold up a new one
+bool ArchiveExecutor::isOutstanding(const QString &key) const
+{
+    foreach(archiveRetrieval *retrieval, queued) if(retrieval->key == key) return true;
+    foreach(archiveRetrieval *retrieval, running) if(retrieval->key == key && !retrieval->isCancelled()) return true;
+    return false;
+}
+
+// queued retrievals are dropped, running ones are told to stop and report done() when they did
+void ArchiveExecutor::cancel(const QString &key)
+{
+    for(int i = queued.count() - 1; i >= 0; --i) {
+        if(queued.at(i)->key == key) queued.takeAt(i)->deleteLater();
+    }
+    foreach(archiveRetrieval *retrieval, running) {
+        if(retrieval->key == key) retrieval->cancel();
+    }
+}
+
+void ArchiveExecutor::cancelAll()
+{
+    while(!queued.isEmpty()) queued.takeFirst()->deleteLater();
+    foreach(archiveRetrieval *retrieval, running) retrieval->cancel();
+}
+
+// widgets not shown (hidden, in another tab, minimized window) get their data last
+int ArchiveExecutor::priorityOf(QWidget *w)
+{
+    if(w == (QWidget *) 0 || !w->isVisible()) return 0;
+    if(w->window()->isMinimized()) return 0;
+    return 1;
+}
+
+void ArchiveExecutor::schedule()
+{
+    int i = 0;
+    while(i < queued.count()) {
+        archiveRetrieval *retrieval = queued.at(i);
+        int count = runningPerBackend.value(retrieval->backend, 0);
+        if(count >= limits.value(retrieval->backend, defaultLimit)) {
+            ++i;
+            continue;
+        }
+        queued.removeAt(i);
+        running.append(retrieval);
+        runningPerBackend.insert(retrieval->backend, count + 1);
+
+        // queued, the retrieval may signal done() while being cancelled from here
+        connect(retrieval, SIGNAL(done()), this, SLOT(retrievalDone()), Qt::QueuedConnection);
+        retrieval->start(&pool);
+    }
+}
+
+void ArchiveExecutor::retrievalDone()
+{
+    archiveRetrieval *retrieval = qobject_cast<archiveRetrieval *>(sender());
+    if(retrieval == (archiveRetrieval *) 0 || !running.removeOne(retrieval)) return;
+
+    int count = runningPerBackend.value(retrieval->backend, 1) - 1;
+    if(count > 0) runningPerBackend.insert(retrieval->backend, count);
+    else runningPerBackend.remove(retrieval->backend);
+
+    retrieval->deleteLater();
+    schedule();
+}
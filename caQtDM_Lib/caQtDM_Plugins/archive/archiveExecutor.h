@@ -0,0 +1,107 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2014
+ *
+ *  Author:
+ *    Anton Mezger
+ *  Contact details:
+ *    anton.mezger@psi.ch
+ */
+
+#ifndef ArchiveExecutor_H
+#define ArchiveExecutor_H
+
+#include <QObject>
+#include <QList>
+#include <QHash>
+#include <QString>
+#include <QThreadPool>
+#include <QWidget>
+
+// one retrieval of an archive plugin, run by the executor of the plugin. start() is called in the gui thread
+// and must not block, neither must cancel(); a retrieval signals done() exactly once, also when cancelled
+class Q_DECL_EXPORT archiveRetrieval : public QObject
+{
+    Q_OBJECT
+
+public:
+    archiveRetrieval() {
+        priority = 0;
+        cancelled = false;
+    }
+    virtual ~archiveRetrieval() {}
+
+    virtual void start(QThreadPool *pool) = 0;
+    virtual void cancel() {cancelled = true;}
+    bool isCancelled() const {return cancelled;}
+
+    QString key;        // key of the index requested
+    QString backend;    // the retrievals of a backend share its limit
+    int priority;       // higher priorities are started first
+
+signals:
+    void done();
+
+protected:
+    volatile bool cancelled;
+};
+
+// a retrieval through a blocking archive library, retrieve() runs in a thread of the pool and delivers
+// its result by a signal; a retrieval cancelled while waiting for a thread is not run anymore
+class Q_DECL_EXPORT archiveBlockingRetrieval : public archiveRetrieval
+{
+    Q_OBJECT
+
+public:
+    void start(QThreadPool *pool);
+    virtual void retrieve() = 0;
+};
+
+// runs the retrievals of a plugin with a fixed number of threads instead of a thread per request;
+// the retrievals of visible widgets go first and only a limited number of them run per backend
+class Q_DECL_EXPORT ArchiveExecutor : public QObject
+{
+    Q_OBJECT
+
+public:
+    ArchiveExecutor(int threads, int limit);
+
+    void setLimit(const QString &backend, int limit);
+    void enqueue(archiveRetrieval *retrieval);
+    bool isOutstanding(const QString &key) const;
+    void cancel(const QString &key);
+    void cancelAll();
+    QThreadPool *threadPool() {return &pool;}
+
+    static int priorityOf(QWidget *w);
+
+private slots:
+    void retrievalDone();
+
+private:
+    void schedule();
+
+    QThreadPool pool;
+    int defaultLimit;
+    QHash<QString, int> limits;
+    QHash<QString, int> runningPerBackend;
+    QList<archiveRetrieval *> queued;
+    QList<archiveRetrieval *> running;
+};
+
+#endif
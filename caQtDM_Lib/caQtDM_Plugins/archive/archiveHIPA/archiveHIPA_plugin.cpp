@@ -24,7 +24,6 @@
  */
 #include <QDebug>
 #include <QApplication>
-#include <QThread>
 #include "archiveHIPA_plugin.h"
 #include "archiverCommon.h"
 
@@ -43,15 +42,20 @@ ArchiveHIPA_Plugin::ArchiveHIPA_Plugin()
     qRegisterMetaType<QVector<float> >("QVector<float>");
 
     qDebug() << "ArchiveHIPA_Plugin: Create (logging retrieval)";
-    archiverCommon = new ArchiverCommon();
+    archiverCommon = new ArchiverCommon(pluginName());
+
+    // the logging library is used by one retrieval at a time
+    executor = new ArchiveExecutor(1, 1);
 
     connect(archiverCommon, SIGNAL(Signal_UpdateInterface(QMap<QString, indexes>)), this,SLOT(Callback_UpdateInterface(QMap<QString, indexes>)));
+    connect(archiverCommon, SIGNAL(Signal_AbortOutstandingRequests(QString)), this,SLOT(Callback_AbortOutstandingRequests(QString)));
     connect(this, SIGNAL(Signal_StopUpdateInterface()), archiverCommon,SLOT(stopUpdateInterface()));
     connect(qApp, SIGNAL(aboutToQuit()), this, SLOT(closeEvent()));
 }
 
 void ArchiveHIPA_Plugin::closeEvent(){
    qDebug() << "ArchiveHIPA_Plugin::closeEvent ";
+   executor->cancelAll();
    emit Signal_StopUpdateInterface();
 }
 
@@ -63,6 +67,11 @@ int ArchiveHIPA_Plugin::initCommunicationLayer(MutexKnobData *data, MessageWindo
 }
 
 
+void ArchiveHIPA_Plugin::Callback_AbortOutstandingRequests(QString key)
+{
+    executor->cancel(key);
+}
+
 // this routine will be called now every 10 seconds to update the cartesianplot
 // however when many data it may take much longer, then  suppress any new request
 void ArchiveHIPA_Plugin::Callback_UpdateInterface( QMap<QString, indexes> listOfIndexes)
@@ -72,70 +81,36 @@ void ArchiveHIPA_Plugin::Callback_UpdateInterface( QMap<QString, indexes> listOf
     QMap<QString, indexes>::const_iterator i = listOfIndexes.constBegin();
 
     while (i != listOfIndexes.constEnd()) {
-        QThread *tmpThread = (QThread *) 0;
         indexes indexNew = i.value();
         //qDebug() <<" -------------" << i.key() << ": " << indexNew.indexX << indexNew.indexY << indexNew.pv << indexNew.w;
 
-        QMap<QString, QThread *>::iterator j = listOfThreads.find(indexNew.key);
-        while (j !=listOfThreads.end() && j.key() == indexNew.key) {
-            tmpThread = (QThread *) j.value();
-            ++j;
-        }
-
-        //qDebug() << "tmpThread" << tmpThread;
-
-        if((tmpThread != (QThread *) 0) && tmpThread->isRunning()) {
-            //qDebug() << "workerthread is running" << tmpThread->isRunning();
+        if(executor->isOutstanding(indexNew.key)) {
+            //qDebug() << "retrieval is outstanding" << indexNew.key;
         } else {
-            WorkerHIPA *worker = new WorkerHIPA;
-            QThread *tmpThread = new QThread;
-            listOfThreads.insert(i.key(), tmpThread);
-            worker->moveToThread(tmpThread);
-            connect(tmpThread, SIGNAL(finished()), worker, SLOT(workerFinish()));
-            connect(tmpThread, SIGNAL(finished()), tmpThread, SLOT(deleteLater()) );
-            connect(this, SIGNAL(operate( QWidget *, indexes)), worker,
-                          SLOT(getFromArchive(QWidget *, indexes)));
+            WorkerHIPA *worker = new WorkerHIPA(indexNew);
+            worker->key = indexNew.key;
+            worker->priority = ArchiveExecutor::priorityOf(indexNew.w);
             connect(worker, SIGNAL(resultReady(indexes, int, QVector<double>, QVector<double>, QString)), this,
                             SLOT(handleResults(indexes, int, QVector<double>, QVector<double>, QString)));
-            tmpThread->start();
 
-            //qDebug() << "HIPA emit operate";
-            emit operate((QWidget *) messagewindowP ,indexNew);
-            disconnect(worker);
+            //qDebug() << "HIPA enqueue";
+            executor->enqueue(worker);
         }
 
         ++i;
     }
-   // qDebug() << "-------------------- ArchiveHIPA_Plugin::Callback_UpdateInterface finish";
 }
 
 void ArchiveHIPA_Plugin::handleResults(indexes indexNew, int nbVal, QVector<double> TimerN, QVector<double> YValsN,  QString backend)
 {
     //qDebug() << "in HIPA handle results" << nbVal << TimerN.count();
 
-    if(nbVal > 0) {
-        TimerN.resize(nbVal);
-        YValsN.resize(nbVal);
-        archiverCommon->updateCartesian(nbVal, indexNew, TimerN, YValsN, backend);
-        TimerN.resize(0);
-        YValsN.resize(0);
-    }
-
-    QList<QString> removeKeys;
-    removeKeys.clear();
-
-    QMap<QString, QThread *>::iterator j = listOfThreads.find(indexNew.key);
-    while (j !=listOfThreads.end() && j.key() == indexNew.key) {
-        QThread *tmpThread = (QThread*) j.value();
-        tmpThread->quit();
-        removeKeys.append(indexNew.key);
-        //qDebug() << tmpThread << "hipa quit";
-        ++j;
-    }
-
-    for(int i=0; i< removeKeys.count(); i++) {
-        listOfThreads.remove(removeKeys.at(i));
-    }
+    // also without new samples, the window moves on
+    TimerN.resize(nbVal);
+    YValsN.resize(nbVal);
+    archiverCommon->updateCartesian(nbVal, indexNew, TimerN, YValsN, backend);
+    TimerN.resize(0);
+    YValsN.resize(0);
 }
 
 // define data to be called
@@ -36,31 +36,28 @@
 #include "controlsinterface.h"
 #include "archiveHIPA_plugin.h"
 #include "archiverCommon.h"
+#include "archiveExecutor.h"
 #include "hipaRetrieval.h"
 
-class Q_DECL_EXPORT WorkerHIPA : public QObject
+class Q_DECL_EXPORT WorkerHIPA : public archiveBlockingRetrieval
 {
     Q_OBJECT
 
 public:
-    WorkerHIPA() {
+    WorkerHIPA(indexes index) {
         qRegisterMetaType<indexes>("indexes");
         qRegisterMetaType<QVector<double> >("QVector<double>");
+        indexNew = index;
     }
 
 private:
     QVector<double>  TimerN, YValsN;
+    indexes indexNew;
 
-public slots:
-
-    void workerFinish() {
-        //qDebug() << "worker finish";
-        deleteLater();
-    }
-
-    void getFromArchive(QWidget *w, indexes indexNew) {
+public:
 
-        Q_UNUSED(w);
+    // runs in a thread of the executor
+    void retrieve() {
 
         QMutex *mutex = indexNew.mutexP;
         mutex->lock();
@@ -77,7 +74,16 @@ public slots:
         if(loggingServer.isEmpty() || !loggingServer.contains("HIPA")) setenv("LOGGINGSERVER", "hipa-lgexp.psi.ch", 1);
 
         qDebug() << "get from archive at " << "hipa-lgexp.psi.ch";
-        int startHours = indexNew.secondsPast / 3600;
+
+        // when samples are held, only the newer ones are requested
+        struct timeb now;
+        ftime(&now);
+        double seconds = (double) now.time + (double) now.millitm / (double)1000;
+        int windowSeconds = indexNew.secondsPast;
+        if(indexNew.lastSampleTime > 0.0) windowSeconds = qMin(windowSeconds, (int) (seconds - indexNew.lastSampleTime) + 2);
+        double windowHours = windowSeconds / 3600.0;
+
+        int startHours = windowSeconds / 3600;
         int day =  startHours/24 + 1;
         int arraySize =  3600/5 * 24 * (day+1);
 
@@ -85,7 +91,7 @@ public slots:
         YVals = (float*) malloc(arraySize * sizeof(float));
 
         strcpy(dev, qasc(key));
-        int ret = GetLogShift(indexNew.secondsPast, dev, &nbVal, Timer, YVals);
+        int ret = GetLogShift(windowSeconds, dev, &nbVal, Timer, YVals);
         if(!ret) nbVal = 0;
 
         // resize arrays
@@ -96,8 +102,9 @@ public slots:
 
         int k=0;
         for(int j=0; j<nbVal; j++) {
-            if(Timer[j] >= -startHours) {
-                TimerN[k] = Timer[j];
+            // times are delivered in hours before now
+            if(Timer[j] >= -windowHours) {
+                TimerN[k] = seconds + Timer[j] * 3600.0;
                 YValsN[k] = YVals[j];
                 ++k;
             }
@@ -154,19 +161,19 @@ public slots:
     void closeEvent();
 
 signals:
-    void operate(QWidget*, const indexes);
     void Signal_StopUpdateInterface();
 
 private slots:
     void updateValues();
     void Callback_UpdateInterface( QMap<QString, indexes> listOfIndexes);
+    void Callback_AbortOutstandingRequests(QString key);
 
 private:
     QMutex mutex;
     MutexKnobData *mutexknobdataP;
     MessageWindow *messagewindowP;
     ArchiverCommon *archiverCommon;
-    QMap<QString, QThread*> listOfThreads;
+    ArchiveExecutor *executor;
 };
 
 #endif
@@ -21,9 +21,9 @@ INCLUDEPATH    += ../../
 INCLUDEPATH    += ../../../src
 INCLUDEPATH    += ../../../../caQtDM_QtControls/src/
 INCLUDEPATH    += $(QWTINCLUDE)
-HEADERS         = ../../controlsinterface.h archivePRO_plugin.h ../archiverCommon.h \
+HEADERS         = ../../controlsinterface.h archivePRO_plugin.h ../archiverCommon.h ../archiveExecutor.h ../archiveDiskCache.h \
     proRetrieval.h
-SOURCES         =  archivePRO_plugin.cpp ../archiverCommon.cpp \
+SOURCES         =  archivePRO_plugin.cpp ../archiverCommon.cpp ../archiveExecutor.cpp ../archiveDiskCache.cpp \
     proRetrieval.c
 TARGET          = archivePRO_plugin
 
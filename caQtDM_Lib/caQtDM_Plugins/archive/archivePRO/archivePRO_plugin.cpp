@@ -23,7 +23,6 @@
  *    anton.mezger@psi.ch
  */
 #include <QDebug>
-#include <QThread>
 #include <QApplication>
 #include "archivePRO_plugin.h"
 #include "archiverCommon.h"
@@ -43,15 +42,20 @@ ArchivePRO_Plugin::ArchivePRO_Plugin()
     qRegisterMetaType<QVector<double> >("QVector<double>");
 
     qDebug() << "ArchivePro_Plugin: Create (logging retrieval)";
-    archiverCommon = new ArchiverCommon();
+    archiverCommon = new ArchiverCommon(pluginName());
+
+    // the logging library is used by one retrieval at a time
+    executor = new ArchiveExecutor(1, 1);
 
     connect(archiverCommon, SIGNAL(Signal_UpdateInterface(QMap<QString, indexes>)), this,SLOT(Callback_UpdateInterface(QMap<QString, indexes>)));
+    connect(archiverCommon, SIGNAL(Signal_AbortOutstandingRequests(QString)), this,SLOT(Callback_AbortOutstandingRequests(QString)));
     connect(this, SIGNAL(Signal_StopUpdateInterface()), archiverCommon,SLOT(stopUpdateInterface()));
     connect(qApp, SIGNAL(aboutToQuit()), this, SLOT(closeEvent()));
 }
 
 void ArchivePRO_Plugin::closeEvent(){
    qDebug() << "ArchivePRO_Plugin::closeEvent ";
+   executor->cancelAll();
    emit Signal_StopUpdateInterface();
 }
 
@@ -62,6 +66,11 @@ int ArchivePRO_Plugin::initCommunicationLayer(MutexKnobData *data, MessageWindow
     return archiverCommon->initCommunicationLayer(data, messageWindow, options);
 }
 
+void ArchivePRO_Plugin::Callback_AbortOutstandingRequests(QString key)
+{
+    executor->cancel(key);
+}
+
 // this routine will be called now every 10 seconds to update the cartesianplot
 // however when many data it may take much longer, then  suppress any new request
 void ArchivePRO_Plugin::Callback_UpdateInterface( QMap<QString, indexes> listOfIndexes)
@@ -71,36 +80,22 @@ void ArchivePRO_Plugin::Callback_UpdateInterface( QMap<QString, indexes> listOfI
     QMap<QString, indexes>::const_iterator i = listOfIndexes.constBegin();
 
     while (i != listOfIndexes.constEnd()) {
-        QThread *tmpThread = (QThread *) 0;
         indexes indexNew = i.value();
-        //qDebug() << i.key() << ": " << indexNew.indexX << indexNew.indexY << indexNew.pv << indexNew.w << endl;
-
-        QMap<QString, QThread *>::iterator j = listOfThreads.find(indexNew.key);
-        while (j !=listOfThreads.end() && j.key() == indexNew.key) {
-            tmpThread = (QThread *) j.value();
-            ++j;
-        }
-
-        //qDebug() << "tmpThread" << tmpThread;
+        //qDebug() <<" -------------" << i.key() << ": " << indexNew.indexX << indexNew.indexY << indexNew.pv << indexNew.w;
 
-        if((tmpThread != (QThread *) 0) && tmpThread->isRunning()) {
-            //qDebug() << "workerthread is running" << tmpThread->isRunning();
+        if(executor->isOutstanding(indexNew.key)) {
+            //qDebug() << "retrieval is outstanding" << indexNew.key;
         } else {
-            WorkerPRO *worker = new WorkerPRO;
-            QThread *tmpThread = new QThread;
-            listOfThreads.insert(i.key(), tmpThread);
-            worker->moveToThread(tmpThread);
-            connect(tmpThread, SIGNAL(finished()), worker, SLOT(workerFinish()));
-            connect(tmpThread, SIGNAL(finished()), tmpThread, SLOT(deleteLater()) );
-            connect(this, SIGNAL(operate( QWidget *, indexes)), worker,
-                          SLOT(getFromArchive(QWidget *, indexes)));
+            WorkerPRO *worker = new WorkerPRO(indexNew);
+            worker->key = indexNew.key;
+            worker->priority = ArchiveExecutor::priorityOf(indexNew.w);
             connect(worker, SIGNAL(resultReady(indexes, int, QVector<double>, QVector<double>, QString)), this,
                             SLOT(handleResults(indexes, int, QVector<double>, QVector<double>, QString)));
-            tmpThread->start();
 
-            //qDebug() << "PRO emit operate";
-            emit operate((QWidget *) messagewindowP ,indexNew);
+            //qDebug() << "PRO enqueue";
+            executor->enqueue(worker);
         }
+
         ++i;
     }
 }
@@ -109,29 +104,12 @@ void ArchivePRO_Plugin::handleResults(indexes indexNew, int nbVal, QVector<doubl
 {
     //qDebug() << "in PRO handle results" << nbVal << TimerN.count();
 
-    if(nbVal > 0) {
-        TimerN.resize(nbVal);
-        YValsN.resize(nbVal);
-        archiverCommon->updateCartesian(nbVal, indexNew, TimerN, YValsN, backend);
-        TimerN.resize(0);
-        YValsN.resize(0);
-    }
-
-    QList<QString> removeKeys;
-    removeKeys.clear();
-
-    QMap<QString, QThread *>::iterator j = listOfThreads.find(indexNew.key);
-    while (j !=listOfThreads.end() && j.key() == indexNew.key) {
-        QThread *tmpThread = (QThread*) j.value();
-        tmpThread->quit();
-        //qDebug() << tmpThread << "pro quit";
-        removeKeys.append(indexNew.key);
-        ++j;
-    }
-
-    for(int i=0; i< removeKeys.count(); i++) {
-        listOfThreads.remove(removeKeys.at(i));
-    }
+    // also without new samples, the window moves on
+    TimerN.resize(nbVal);
+    YValsN.resize(nbVal);
+    archiverCommon->updateCartesian(nbVal, indexNew, TimerN, YValsN, backend);
+    TimerN.resize(0);
+    YValsN.resize(0);
 }
 
 // define data to be called
@@ -24,8 +24,8 @@ INCLUDEPATH    += ../../
 INCLUDEPATH    += ../../../src
 INCLUDEPATH    += ../../../../caQtDM_QtControls/src/
 INCLUDEPATH    += $(QWTINCLUDE)
-HEADERS         = ../../controlsinterface.h archiveSF_plugin.h sfRetrieval.h ../archiverCommon.h
-SOURCES         =  archiveSF_plugin.cpp sfRetrieval.cpp ../archiverCommon.cpp
+HEADERS         = ../../controlsinterface.h archiveSF_plugin.h sfRetrieval.h sfDecoder.h ../archiverCommon.h ../archiveExecutor.h ../archiveDiskCache.h
+SOURCES         =  archiveSF_plugin.cpp sfRetrieval.cpp sfDecoder.cpp ../archiverCommon.cpp ../archiveExecutor.cpp ../archiveDiskCache.cpp
 TARGET          = archiveSF_plugin
 
 
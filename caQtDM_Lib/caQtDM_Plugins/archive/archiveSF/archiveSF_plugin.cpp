@@ -30,6 +30,9 @@
 
 #define qasc(x) x.toLatin1().constData()
 
+#define DECODETHREADS 2         // threads decoding the replies
+#define REQUESTSPERBACKEND 4    // requests running at the same time per archiver url and backend
+
 // gives the plugin name back
 QString ArchiveSF_Plugin::pluginName()
 {
@@ -39,12 +42,16 @@ QString ArchiveSF_Plugin::pluginName()
 // constructor
 ArchiveSF_Plugin::ArchiveSF_Plugin()
 {
-    suspend = false;
     qRegisterMetaType<indexes>("indexes");
     qRegisterMetaType<QVector<double> >("QVector<double>");
 
     qDebug() << "ArchiveSF_Plugin: Create (http-retrieval)";
-    archiverCommon = new ArchiverCommon();
+    archiverCommon = new ArchiverCommon(pluginName());
+    archiverCommon->setAutomaticBinning(true);
+
+    // one network manager for all requests, they run asynchronously in the gui thread
+    networkManager = new QNetworkAccessManager(this);
+    executor = new ArchiveExecutor(DECODETHREADS, REQUESTSPERBACKEND);
 
     connect(archiverCommon, SIGNAL(Signal_UpdateInterface(QMap<QString, indexes>)), this,SLOT(Callback_UpdateInterface(QMap<QString, indexes>)));
     connect(archiverCommon, SIGNAL(Signal_AbortOutstandingRequests(QString)), this,SLOT(Callback_AbortOutstandingRequests(QString)));
@@ -58,6 +65,7 @@ ArchiveSF_Plugin:: ~ArchiveSF_Plugin() {
 
 void ArchiveSF_Plugin::closeEvent(){
    //qDebug() << "ArchiveSF_Plugin::closeEvent ";
+   executor->cancelAll();
    emit Signal_StopUpdateInterface();
 }
 
@@ -69,33 +77,17 @@ int ArchiveSF_Plugin::initCommunicationLayer(MutexKnobData *data, MessageWindow
     return archiverCommon->initCommunicationLayer(data, messageWindow, options);
 }
 
+// queued requests are dropped, running ones aborted without waiting for them
 void ArchiveSF_Plugin::Callback_AbortOutstandingRequests(QString key)
 {
-    suspend = true;
     //qDebug()  << "Callback_AbortOutstandingRequests for key" << key;
-
-    myThread *tmpThread = (myThread *) 0;
-    QMap<QString, myThread *>::iterator j = listOfThreads.find(key);
-    while (j !=listOfThreads.end() && j.key() == key) {
-        tmpThread = (myThread *) j.value();
-        if(tmpThread != (myThread *) 0) {
-            sfRetrieval *retrieval = tmpThread->getArchive();
-            if(retrieval != (sfRetrieval *) 0) retrieval->cancelDownload();
-            tmpThread->quit();
-        }
-        ++j;
-    }
-
-   QApplication::processEvents();
-   suspend = false;
+    executor->cancel(key);
 }
 
 // this routine will be called now every 10 seconds to update the cartesianplot
 // however when many data it may take much longer, then  suppress any new request
 void ArchiveSF_Plugin::Callback_UpdateInterface( QMap<QString, indexes> listOfIndexes)
 {
-    if(suspend) return;
-
     // Index name (url)
     QString index_name =  "https://data-api.psi.ch/sf/query";
 
@@ -105,18 +97,11 @@ void ArchiveSF_Plugin::Callback_UpdateInterface( QMap<QString, indexes> listOfIn
 
     while (i != listOfIndexes.constEnd()) {
 
-        myThread *tmpThread = (myThread *) 0;
         indexes indexNew = i.value();
         //qDebug() <<" -------------" << i.key() << ": " << indexNew.indexX << indexNew.indexY << indexNew.pv << indexNew.w;
 
-        QMap<QString, myThread *>::iterator j = listOfThreads.find(indexNew.key);
-        while (j !=listOfThreads.end() && j.key() == indexNew.key) {
-            tmpThread = (myThread *) j.value();
-            ++j;
-        }
-
-        if((tmpThread != (myThread *) 0) && tmpThread->isRunning()) {
-            //qDebug() << "thread is running" << tmpThread << tmpThread->isRunning();
+        if(executor->isOutstanding(indexNew.key)) {
+            //qDebug() << "request is outstanding" << indexNew.key;
 
         } else {
 
@@ -129,8 +114,10 @@ void ArchiveSF_Plugin::Callback_UpdateInterface( QMap<QString, indexes> listOfIn
                     bool ok;
                     indexNew.nrOfBins = var.toInt(&ok);
                     if(!ok) indexNew.nrOfBins = -1;
+                    // the window of the request is the longest of the series, the width of the bins stays
+                    else if(indexNew.binWidth > 0.0) indexNew.nrOfBins = qMax(1, qRound(indexNew.secondsPast / indexNew.binWidth));
                 } else if(indexNew.init){
-                    QString mess("ArchiveSF plugin -- no nrOfBins defined as dynamic property in widget "  + w->objectName() + ", defaulting to maximum number of points");
+                    QString mess("ArchiveSF plugin -- no nrOfBins defined as dynamic property in widget "  + w->objectName() + ", binning automatically to the width and zoom of the plot");
                     if(messagewindowP != (MessageWindow *) 0) messagewindowP->postMsgEvent(QtWarningMsg, (char*) qasc(mess));
                 }
 
@@ -175,24 +162,15 @@ void ArchiveSF_Plugin::Callback_UpdateInterface( QMap<QString, indexes> listOfIn
                 }
             }
 
-            WorkerSF *worker = new WorkerSF;
-            myThread *tmpThread = new myThread(worker);
-            //qDebug() << "tmpThread new" << tmpThread;
-            listOfThreads.insert(i.key(), tmpThread);;
-
-            worker->moveToThread(tmpThread);
-
-            connect(tmpThread, SIGNAL(finished()), worker, SLOT(workerFinish()));
-            connect(tmpThread, SIGNAL(finished()), tmpThread, SLOT(deleteLater()) );
-            connect(this, SIGNAL(operate( QWidget *, indexes, QString, MessageWindow *)), worker,
-                          SLOT(getFromArchive(QWidget *, indexes,  QString, MessageWindow *)));
+            WorkerSF *worker = new WorkerSF(networkManager, indexNew, index_name, messagewindowP);
+            worker->key = indexNew.key;
+            worker->backend = index_name + "|" + indexNew.backend.toLower();
+            worker->priority = ArchiveExecutor::priorityOf(indexNew.w);
             connect(worker, SIGNAL(resultReady(indexes, int, QVector<double>, QVector<double>, QString)), this,
                            SLOT(handleResults(indexes, int, QVector<double>, QVector<double>, QString)));
-            tmpThread->start();
-
-            emit operate((QWidget *) messagewindowP, indexNew, index_name, messagewindowP);
+            connect(worker, SIGNAL(requestCancelled(indexes)), this, SLOT(handleCancelled(indexes)));
 
-            disconnect(worker);
+            executor->enqueue(worker);
         }
 
         ++i;
@@ -209,33 +187,21 @@ void ArchiveSF_Plugin::handleResults(indexes indexNew, int nbVal, QVector<double
     YValsN.resize(nbVal);
 
     //qDebug() << "handle cartesian";
-    if(nbVal > 0) archiverCommon->updateCartesian(nbVal, indexNew, TimerN, YValsN, backend);
+    int held = archiverCommon->updateCartesian(nbVal, indexNew, TimerN, YValsN, backend);
     TimerN.resize(0);
     YValsN.resize(0);
 
-    //qDebug() << "handle cartesian fisnished";
-    QList<QString> removeKeys;
-    removeKeys.clear();
-
-    QMap<QString, myThread *>::iterator j = listOfThreads.find(indexNew.key);
-    while (j !=listOfThreads.end() && j.key() == indexNew.key) {
-        myThread *tmpThread = (myThread*) j.value();
-        tmpThread->quit();
-        removeKeys.append(indexNew.key);
-        //qDebug() << tmpThread << "sf quit";
-        ++j;
-    }
-
-    for(int i=0; i< removeKeys.count(); i++) {
-        listOfThreads.remove(removeKeys.at(i));
-    }
-
-    if(nbVal == 0) archiverCommon->updateSecondsPast(indexNew, false);
+    if(held == 0) archiverCommon->updateSecondsPast(indexNew, false);
     else archiverCommon->updateSecondsPast(indexNew, true);
 
     //qDebug() << "in sf handle results finished";
 }
 
+void ArchiveSF_Plugin::handleCancelled(indexes indexNew)
+{
+    archiverCommon->requestCancelled(indexNew);
+}
+
 // define data to be called
 int ArchiveSF_Plugin::pvAddMonitor(int index, knobData *kData, int rate, int skip) {
     return archiverCommon->pvAddMonitor(index, kData, rate, skip);
@@ -31,49 +31,41 @@
 #include <QList>
 #include <QTimer>
 #include <QThread>
+#include <QNetworkAccessManager>
 #include <qwt.h>
 #include "cacartesianplot.h"
 #include "controlsinterface.h"
 #include "archiveSF_plugin.h"
 #include "archiverCommon.h"
+#include "archiveExecutor.h"
 #include "sfRetrieval.h"
 
 
-class Q_DECL_EXPORT WorkerSF : public QObject
+// one request to the data api; it is posted with the network manager of the plugin from the gui thread,
+// so that no thread waits for the reply
+class Q_DECL_EXPORT WorkerSF : public archiveRetrieval
 {
     Q_OBJECT
 
 public:
-    WorkerSF() {
+    WorkerSF(QNetworkAccessManager *manager, indexes index, QString indexName, MessageWindow *messageWindow) {
         //qDebug() << "WorkerSF::WorkerSF()";
         qRegisterMetaType<indexes>("indexes");
         qRegisterMetaType<QVector<double> >("QVector<double>");
+        networkManager = manager;
+        indexNew = index;
+        index_name = indexName;
+        messagewindowP = messageWindow;
         fromArchive =  (sfRetrieval *)0;
+        isDelta = false;
     }
 
     ~WorkerSF() {
         //qDebug() << "WorkerSF::~WorkerSF()";
     }
 
-private:
-    QVector<double>  TimerN, YValsN;
-
-public slots:
-
-    void workerFinish() {
-        deleteLater();
-    }
-
-    sfRetrieval* getArchive() {
-        return fromArchive;
-    }
-
-    void getFromArchive(QWidget *w, indexes indexNew,  QString index_name, MessageWindow * messageWindow) {
-
-        Q_UNUSED(w);
-
-        QMutex *mutex = indexNew.mutexP;
-        mutex->lock();
+    // posts the request and returns, retrievalFinished() goes on with the result
+    void start(QThreadPool *pool) {
 
         struct timeb now;
         QUrl url = QUrl(index_name);
@@ -81,11 +73,15 @@ public slots:
         bool isBinned;
 
         QString key = indexNew.pv;
-        int nbVal = 0;
 
         ftime(&now);
         double endSeconds = (double) now.time + (double) now.millitm / (double)1000;
         double startSeconds = endSeconds - indexNew.secondsPast;
+
+        // when samples are held, only the newer ones are requested, starting with the last one held
+        // that could have been incomplete
+        isDelta = (indexNew.lastSampleTime > startSeconds);
+        if(isDelta) startSeconds = indexNew.lastSampleTime;
 #ifdef CSV
         QString response ="'response':{'format':'csv'}";
 #else
@@ -102,30 +98,62 @@ public slots:
         fields = "'fields':['channel','globalSeconds','value']";
 
         if(indexNew.nrOfBins != -1) {
+            // the same bin width for a delta as for the whole window
+            int nrOfBins = indexNew.nrOfBins;
+            if(isDelta) nrOfBins = qMax(1, qRound(nrOfBins * (endSeconds - startSeconds) / indexNew.secondsPast));
             isBinned = true;
-            agg = tr(", 'aggregation': {'aggregationType':'value', 'aggregations':['min','mean','max'], 'nrOfBins' : %1}").arg(indexNew.nrOfBins);
+            agg = tr(", 'aggregation': {'aggregationType':'value', 'aggregations':['min','mean','max'], 'nrOfBins' : %1}").arg(nrOfBins);
         } else {
             isBinned = true;
-            agg = ", 'aggregation': {'aggregationType':'value', 'aggregations':['min','mean','max'], 'durationPerBin' : 'PT1S'}";
+            // bins of the width given by the automatic binning, at least 1 second
+            agg = tr(", 'aggregation': {'aggregationType':'value', 'aggregations':['min','mean','max'], 'durationPerBin' : 'PT%1S'}").arg(qMax(indexNew.binSeconds, 1));
             //agg = "";
         }
         QString total = "{" + response + "," + range + "," + channels + "," + fields + agg + "}";
         total = total.replace("'", "\"");
         QByteArray json_str = total.toUtf8();
 
-        fromArchive = new sfRetrieval();
+        fromArchive = new sfRetrieval(networkManager, pool);
+        fromArchive->setParent(this);
+        connect(fromArchive, SIGNAL(requestFinished()), this, SLOT(retrievalFinished()));
 
         //qDebug() << "fromArchive pointer=" << fromArchive << indexNew.timeAxis;
 
-        if(fromArchive->requestUrl(url, json_str, indexNew.secondsPast, isBinned, indexNew.timeAxis, key)) {
-            if((nbVal = fromArchive->getCount()) > 0) {
-                //qDebug() << nbVal << total;
-                TimerN.resize(fromArchive->getCount());
-                YValsN.resize(fromArchive->getCount());
-                fromArchive->getData(TimerN, YValsN);
-            }
-        } else {
-            if(messageWindow != (MessageWindow *) 0) {
+        fromArchive->requestUrl(url, json_str, indexNew.secondsPast, isBinned, key);
+    }
+
+    void cancel() {
+        cancelled = true;
+        if(fromArchive != (sfRetrieval *) 0) fromArchive->cancelDownload();
+    }
+
+private:
+    QVector<double>  TimerN, YValsN;
+
+private slots:
+
+    void retrievalFinished() {
+
+        QString key = indexNew.pv;
+        int nbVal = 0;
+
+        // a cancelled request has no result, its series may be requested again right away
+        if(cancelled || fromArchive->isAborted()) {
+            emit requestCancelled(indexNew);
+            emit done();
+            return;
+        }
+
+        bool ok = fromArchive->isFinished();
+        if(ok && ((nbVal = fromArchive->getCount()) > 0)) {
+            TimerN.resize(fromArchive->getCount());
+            YValsN.resize(fromArchive->getCount());
+            fromArchive->getData(TimerN, YValsN);
+        }
+
+        // no new data is normal for a delta
+        if(!ok || ((nbVal == 0) && !isDelta)) {
+            if(messagewindowP != (MessageWindow *) 0) {
                 QString mess("ArchiveSF plugin -- lastError: ");
                 mess.append(fromArchive->lastError());
                 mess.append(" for pv: ");
@@ -135,54 +163,27 @@ public slots:
 #else
                 mess = (Qt::escape(mess));
 #endif
-                messageWindow->postMsgEvent(QtFatalMsg, (char*) qasc(mess));
+                messagewindowP->postMsgEvent(QtFatalMsg, (char*) qasc(mess));
             }
         }
 
         //qDebug() << QTime::currentTime().toString() << "number of values received" << nbVal << fromArchive << "for" << key;
 
         emit resultReady(indexNew, nbVal, TimerN, YValsN, fromArchive->getBackend());
-
-        mutex->unlock();
-        fromArchive->deleteLater();
+        emit done();
     }
 
 signals:
     void resultReady(indexes indexNew, int nbVal, QVector<double> TimerN, QVector<double> YValsN, QString backend);
-
-public:
+    void requestCancelled(indexes indexNew);
 
 private:
+    QNetworkAccessManager *networkManager;
+    indexes indexNew;
+    QString index_name;
+    MessageWindow *messagewindowP;
     sfRetrieval *fromArchive;
-
-};
-
-class Q_DECL_EXPORT myThread : public QThread
-{
-    Q_OBJECT
-
-public:
-    myThread(WorkerSF *worker) {
-        pworker = worker;
-        //qDebug() << "myThread::myThread()";
-    }
-    ~myThread() {
-        //qDebug() << "myThread::~myThread()";
-    }
-    WorkerSF *workersf() {
-        return pworker;
-    }
-
-    sfRetrieval *getArchive() {
-        if(pworker != (WorkerSF *) 0) {
-            return pworker->getArchive();
-        } else {
-            return (sfRetrieval *) 0;
-        }
-    }
-
-private:
-    WorkerSF *pworker;
+    bool isDelta;
 };
 
 class Q_DECL_EXPORT ArchiveSF_Plugin : public QObject, ControlsInterface
@@ -216,9 +217,9 @@ public:
 
 public slots:
     void handleResults(indexes, int, QVector<double>, QVector<double>, QString);
+    void handleCancelled(indexes);
 
 signals:
-    void operate(QWidget*, const indexes, const QString, MessageWindow *);
     void Signal_StopUpdateInterface();
 
 private slots:
@@ -231,8 +232,8 @@ private:
     MutexKnobData *mutexknobdataP;
     MessageWindow *messagewindowP;
     ArchiverCommon *archiverCommon;
-    QMap<QString, myThread*> listOfThreads;
-    bool suspend;
+    QNetworkAccessManager *networkManager;
+    ArchiveExecutor *executor;
 };
 
 #endif
@@ -0,0 +1,369 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2014
+ *
+ *  Author:
+ *    Anton Mezger
+ *  Contact details:
+ *    anton.mezger@psi.ch
+ */
+
+
+#include <string.h>
+#include "sfDecoder.h"
+
+#define MAXDEPTH 64
+
+// powers of ten represented exactly by a double
+static const double exactPowers[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+sfDecoder::sfDecoder(const QByteArray &reply, bool binned)
+{
+    P = reply.constData();
+    End = P + reply.size();
+    Binned = binned;
+    DataFound = false;
+    Count = 0;
+}
+
+bool sfDecoder::fail(const QString &error)
+{
+    if(ErrorString.isEmpty()) ErrorString = error;
+    return false;
+}
+
+// values that are not numbers (null, strings) are skipped like before
+bool sfDecoder::isNumber()
+{
+    skipWhiteSpace();
+    return (P < End) && ((*P >= '0' && *P <= '9') || *P == '-');
+}
+
+bool sfDecoder::keyIs(const char *key, int length, const char *name)
+{
+    return ((int) strlen(name) == length) && (memcmp(key, name, length) == 0);
+}
+
+void sfDecoder::skipWhiteSpace()
+{
+    while(P < End && (*P == ' ' || *P == '\n' || *P == '\r' || *P == '\t')) P++;
+}
+
+bool sfDecoder::expect(char c)
+{
+    skipWhiteSpace();
+    if(P >= End || *P != c) return fail(QString("'%1' expected at position %2").arg(c).arg(End - P));
+    P++;
+    return true;
+}
+
+// gives the raw content of a string, the escapes are not resolved (not needed for the members we use)
+bool sfDecoder::parseString(const char **start, int *length)
+{
+    if(!expect('"')) return false;
+    const char *begin = P;
+    while(P < End && *P != '"') {
+        if(*P == '\\') P++;
+        P++;
+    }
+    if(P >= End) return fail("unterminated string");
+    if(start != (const char **) 0) *start = begin;
+    if(length != (int *) 0) *length = P - begin;
+    P++;
+    return true;
+}
+
+// fast path for mantissas up to 19 digits and exact powers of ten, otherwise by the c library
+bool sfDecoder::parseNumber(double &value)
+{
+    skipWhiteSpace();
+    const char *begin = P;
+    bool negative = false;
+    unsigned long long mantissa = 0;
+    int digits = 0, exponent = 0;
+
+    if(P < End && (*P == '-' || *P == '+')) negative = (*P++ == '-');
+    while(P < End && *P >= '0' && *P <= '9') {
+        if(digits < 19) mantissa = mantissa * 10 + (*P - '0'); else exponent++;
+        if(mantissa > 0) digits++;
+        P++;
+    }
+    if(P < End && *P == '.') {
+        P++;
+        while(P < End && *P >= '0' && *P <= '9') {
+            if(digits < 19) {
+                mantissa = mantissa * 10 + (*P - '0');
+                exponent--;
+                if(mantissa > 0) digits++;
+            }
+            P++;
+        }
+    }
+    if(P < End && (*P == 'e' || *P == 'E')) {
+        P++;
+        bool negativeExp = false;
+        int exp = 0;
+        if(P < End && (*P == '-' || *P == '+')) negativeExp = (*P++ == '-');
+        while(P < End && *P >= '0' && *P <= '9') {
+            if(exp < 10000) exp = exp * 10 + (*P - '0');
+            P++;
+        }
+        exponent += negativeExp ? -exp : exp;
+    }
+    if(P == begin || (P == begin + 1 && negative)) return fail(QString("number expected at position %1").arg(End - P));
+
+    if(mantissa < (1ULL << 53) && exponent >= -22 && exponent <= 22) {
+        value = (double) mantissa;
+        if(exponent < 0) value /= exactPowers[-exponent];
+        else value *= exactPowers[exponent];
+    } else {
+        char buffer[64];
+        int length = qMin((int) (P - begin), (int) sizeof(buffer) - 1);
+        memcpy(buffer, begin, length);
+        buffer[length] = '\0';
+        value = QByteArray::fromRawData(buffer, length).toDouble();
+        return true;
+    }
+    if(negative) value = -value;
+    return true;
+}
+
+// numbers given as strings, e.g. globalSeconds
+bool sfDecoder::parseNumberString(double &value)
+{
+    skipWhiteSpace();
+    if(P < End && *P != '"') return parseNumber(value);
+
+    const char *start;
+    int length;
+    if(!parseString(&start, &length)) return false;
+    const char *after = P;
+    const char *end = End;
+    P = start;
+    End = start + length;
+    bool ok = parseNumber(value);
+    if(ok && P != End) ok = fail(QString("could not decode number %1").arg(QString::fromUtf8(start, length)));
+    P = after;
+    End = end;
+    return ok;
+}
+
+bool sfDecoder::skipValue(int depth)
+{
+    if(depth > MAXDEPTH) return fail("json nested too deeply");
+    skipWhiteSpace();
+    if(P >= End) return fail("unexpected end of reply");
+
+    switch(*P) {
+    case '"':
+        return parseString((const char **) 0, (int *) 0);
+    case '{':
+        P++;
+        skipWhiteSpace();
+        if(P < End && *P == '}') { P++; return true; }
+        for(;;) {
+            if(!parseString((const char **) 0, (int *) 0) || !expect(':') || !skipValue(depth + 1)) return false;
+            skipWhiteSpace();
+            if(P < End && *P == ',') { P++; continue; }
+            return expect('}');
+        }
+    case '[':
+        P++;
+        skipWhiteSpace();
+        if(P < End && *P == ']') { P++; return true; }
+        for(;;) {
+            if(!skipValue(depth + 1)) return false;
+            skipWhiteSpace();
+            if(P < End && *P == ',') { P++; continue; }
+            return expect(']');
+        }
+    case 't':
+        if(End - P >= 4 && strncmp(P, "true", 4) == 0) { P += 4; return true; }
+        break;
+    case 'f':
+        if(End - P >= 5 && strncmp(P, "false", 5) == 0) { P += 5; return true; }
+        break;
+    case 'n':
+        if(End - P >= 4 && strncmp(P, "null", 4) == 0) { P += 4; return true; }
+        break;
+    default: {
+        double value;
+        return parseNumber(value);
+    }
+    }
+    return fail(QString("unexpected character at position %1").arg(End - P));
+}
+
+bool sfDecoder::parseChannel()
+{
+    skipWhiteSpace();
+    if(P >= End || *P != '{') return skipValue(1);
+    P++;
+    skipWhiteSpace();
+    if(P < End && *P == '}') { P++; return true; }
+    for(;;) {
+        const char *key;
+        int length;
+        if(!parseString(&key, &length) || !expect(':')) return false;
+        skipWhiteSpace();
+        if(keyIs(key, length, "backend") && P < End && *P == '"') {
+            const char *start;
+            int size;
+            if(!parseString(&start, &size)) return false;
+            Backend = QString::fromUtf8(start, size);
+        } else if(!skipValue(2)) {
+            return false;
+        }
+        skipWhiteSpace();
+        if(P < End && *P == ',') { P++; continue; }
+        return expect('}');
+    }
+}
+
+// mean of a bin
+bool sfDecoder::parseBin(double &value, bool &valueFound)
+{
+    P++;
+    skipWhiteSpace();
+    if(P < End && *P == '}') { P++; return true; }
+    for(;;) {
+        const char *key;
+        int length;
+        if(!parseString(&key, &length) || !expect(':')) return false;
+        if(keyIs(key, length, "mean") && isNumber()) {
+            if(!parseNumber(value)) return false;
+            valueFound = true;
+        } else if(!skipValue(4)) {
+            return false;
+        }
+        skipWhiteSpace();
+        if(P < End && *P == ',') { P++; continue; }
+        return expect('}');
+    }
+}
+
+bool sfDecoder::parseSample(double &time, double &value, bool &timeFound, bool &valueFound)
+{
+    if(!expect('{')) return false;
+    skipWhiteSpace();
+    if(P < End && *P == '}') { P++; return true; }
+    for(;;) {
+        const char *key;
+        int length;
+        if(!parseString(&key, &length) || !expect(':')) return false;
+        skipWhiteSpace();
+        if(keyIs(key, length, "globalSeconds")) {
+            if(!parseNumberString(time)) return false;
+            timeFound = true;
+        } else if(keyIs(key, length, "value")) {
+            if(P < End && *P == '[') return fail("waveforms not supported");
+            if(P < End && *P == '{') {
+                if(!Binned) return fail("binned value received for a raw request");
+                if(!parseBin(value, valueFound)) return false;
+            } else if(isNumber()) {
+                if(!parseNumber(value)) return false;
+                valueFound = true;
+            } else if(!skipValue(3)) {
+                return false;
+            }
+        } else if(!skipValue(3)) {
+            return false;
+        }
+        skipWhiteSpace();
+        if(P < End && *P == ',') { P++; continue; }
+        return expect('}');
+    }
+}
+
+bool sfDecoder::parseData(double now, double secondsPast, QVector<double> &x, QVector<double> &y)
+{
+    if(!expect('[')) return false;
+    DataFound = true;
+    skipWhiteSpace();
+    if(P < End && *P == ']') { P++; return true; }
+
+    for(;;) {
+        double time = 0.0, value = 0.0;
+        bool timeFound = false, valueFound = false;
+        if(!parseSample(time, value, timeFound, valueFound)) return false;
+
+        if(timeFound && valueFound && (now - time) < secondsPast) {
+            x.append(time);
+            y.append(value);
+            Count++;
+        }
+
+        skipWhiteSpace();
+        if(P < End && *P == ',') { P++; continue; }
+        return expect(']');
+    }
+}
+
+bool sfDecoder::decode(double now, double secondsPast, QVector<double> &x, QVector<double> &y)
+{
+    Count = 0;
+    x.resize(0);
+    y.resize(0);
+
+    // a sample takes at least about 40 bytes in the reply
+    int estimate = (End - P) / 40;
+    x.reserve(estimate);
+    y.reserve(estimate);
+
+    skipWhiteSpace();
+    if(P >= End || *P != '[') return fail("the json root element is not an array, something has changed");
+    P++;
+    skipWhiteSpace();
+    if(P < End && *P == ']') return true;
+
+    for(;;) {
+        if(!expect('{')) return false;
+        skipWhiteSpace();
+        if(P < End && *P != '}') {
+            for(;;) {
+                const char *key;
+                int length;
+                if(!parseString(&key, &length) || !expect(':')) return false;
+                if(keyIs(key, length, "channel")) {
+                    if(!parseChannel()) return false;
+                } else if(keyIs(key, length, "data")) {
+                    skipWhiteSpace();
+                    if(P < End && *P == '[') {
+                        if(!parseData(now, secondsPast, x, y)) return false;
+                    } else if(!skipValue(1)) {
+                        return false;
+                    }
+                } else if(!skipValue(1)) {
+                    return false;
+                }
+                skipWhiteSpace();
+                if(P < End && *P == ',') { P++; continue; }
+                if(!expect('}')) return false;
+                break;
+            }
+        } else {
+            P++;
+        }
+        skipWhiteSpace();
+        if(P < End && *P == ',') { P++; continue; }
+        return expect(']');
+    }
+}
@@ -0,0 +1,78 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2014
+ *
+ *  Author:
+ *    Anton Mezger
+ *  Contact details:
+ *    anton.mezger@psi.ch
+ */
+
+
+#ifndef SFDECODER_H
+#define SFDECODER_H
+
+#include <QByteArray>
+#include <QVector>
+#include <QString>
+
+// decoder for the json replies of the data api, e.g.
+//   [{"channel":{"name":"pv","backend":"sf-databuffer"},"data":[{"globalSeconds":"1513178125.123","value":1.5}, ...]}]
+// with a value being a number or for binned data an object with min, mean and max
+// the reply is scanned once in place and the times and values are written directly into the vectors,
+// without building a document; all other members are skipped
+
+class sfDecoder
+{
+public:
+    sfDecoder(const QByteArray &reply, bool binned);
+
+    // keeps the samples newer than secondsPast before now, times in seconds since the epoch
+    bool decode(double now, double secondsPast, QVector<double> &x, QVector<double> &y);
+
+    int count() const { return Count; }
+    bool hasData() const { return DataFound; }
+    QString backend() const { return Backend; }
+    QString lastError() const { return ErrorString; }
+
+private:
+    void skipWhiteSpace();
+    bool expect(char c);
+    bool parseString(const char **start, int *length);
+    bool isNumber();
+    bool parseNumber(double &value);
+    bool parseNumberString(double &value);
+    bool skipValue(int depth);
+    bool parseChannel();
+    bool parseData(double now, double secondsPast, QVector<double> &x, QVector<double> &y);
+    bool parseSample(double &time, double &value, bool &timeFound, bool &valueFound);
+    bool parseBin(double &value, bool &valueFound);
+    bool fail(const QString &error);
+
+    static bool keyIs(const char *key, int length, const char *name);
+
+    const char *P;
+    const char *End;
+    bool Binned;
+    bool DataFound;
+    int Count;
+    QString Backend;
+    QString ErrorString;
+};
+
+#endif
@@ -29,13 +29,12 @@
 #include <iostream>
 #include <QFile>
 #include <QDir>
-#include <QMutex>
-#include <QWaitCondition>
-#include <QEventLoop>
+#include <QRunnable>
 #include <QTimer>
 #include <time.h>
 #include <sys/timeb.h>
 #include "sfRetrieval.h"
+#include "sfDecoder.h"
 #include <QDebug>
 #include <QThread>
 #include <QTime>
@@ -49,27 +48,56 @@
 #endif
 
 
-sfRetrieval::sfRetrieval()
+// decodes a reply in a thread of the pool, the retrieval is told in its own thread when done
+class sfDecodeTask : public QRunnable
+{
+public:
+    sfDecodeTask(sfRetrieval *retrieval, const QByteArray &data) {
+        this->retrieval = retrieval;
+        this->data = data;
+    }
+
+    void run() {
+        retrieval->decode(data);
+        data.clear();
+        QMetaObject::invokeMethod(retrieval, "decodeFinished", Qt::QueuedConnection);
+    }
+
+private:
+    sfRetrieval *retrieval;
+    QByteArray data;
+};
+
+sfRetrieval::sfRetrieval(QNetworkAccessManager *networkManager, QThreadPool *threadPool)
 {
     finished = false;
-    manager = new QNetworkAccessManager(this);
-    eventLoop = new QEventLoop(this);
+    aborted = false;
+    timedOut = false;
+    totalCount = 0;
+    manager = networkManager;
+    pool = threadPool;
+    reply = (QNetworkReply *) 0;
     errorString = "";
+    timeoutHelper = new QTimer(this);
+    timeoutHelper->setSingleShot(true);
+    timeoutHelper->setInterval(60000);
+    connect(timeoutHelper, SIGNAL(timeout()), this, SLOT(timeoutL()));
     //qDebug() << QTime::currentTime().toString() << this << "constructor";
-    connect(this, SIGNAL(requestFinished()), this, SLOT(downloadFinished()) );
 }
 
 void sfRetrieval::timeoutL()
 {
-    errorString = "http request timeout";
-    //qDebug() << QTime::currentTime().toString() << this << PV << "timeout" << errorString;
-    cancelDownload();
+    //qDebug() << QTime::currentTime().toString() << this << PV << "timeout";
+    if(reply == (QNetworkReply *) 0) return;
+    timedOut = true;
+    reply->abort();
 }
 
-bool sfRetrieval::requestUrl(const QUrl url, const QByteArray &json, int secondsPast, bool binned, bool timeAxis, QString key)
+void sfRetrieval::requestUrl(const QUrl url, const QByteArray &json, int secondsPast, bool binned, QString key)
 {
     //qDebug() << "sfRetrieval::requestUrl" << json;
     aborted = false;
+    timedOut = false;
     finished = false;
     totalCount = 0;
     secndsPast = secondsPast;
@@ -77,117 +105,108 @@ bool sfRetrieval::requestUrl(const QUrl url, const QByteArray &json, int seconds
     //printf("caQtDM -- request from %s with %s\n", qasc(url.toString()), qasc(out));
     downloadUrl = url;
     isBinned = binned;
-    timAxis = timeAxis;
     errorString = "";
     PV = key;
 
-    QNetworkRequest *request = new QNetworkRequest(url);
+    QNetworkRequest request(url);
 
     //for https we need some configuration (with no verify socket)
 #ifndef CAQTDM_SSL_IGNORE
 #ifndef QT_NO_SSL
     if(url.toString().toUpper().contains("HTTPS")) {
-        QSslConfiguration config = request->sslConfiguration();
+        QSslConfiguration config = request.sslConfiguration();
 #if QT_VERSION < QT_VERSION_CHECK(4, 7, 0)
         config.setProtocol(QSsl::TlsV1);
 #endif
         config.setPeerVerifyMode(QSslSocket::VerifyNone);
-        request->setSslConfiguration(config);
+        request.setSslConfiguration(config);
     }
 
 
 #endif
 #endif
 
-    request->setRawHeader("Content-Type", "application/json");
-    request->setRawHeader("Timeout", "86400");
+    request.setRawHeader("Content-Type", "application/json");
+    request.setRawHeader("Timeout", "86400");
 
-    reply = manager->post(*request, json);
+    // the manager is shared, so only the finished signal of our own reply is of interest
+    reply = manager->post(request, json);
+    connect(reply, SIGNAL(finished()), this, SLOT(finishReply()));
 
     //qDebug() << "requesturl reply" << reply;
-
-    connect(manager, SIGNAL(finished(QNetworkReply*)), this, SLOT(finishReply(QNetworkReply*)));
-
-    finished = false;
-    QTimer *timeoutHelper = new QTimer(this);
-    timeoutHelper->setInterval(60000);
     timeoutHelper->start();
-    connect(timeoutHelper, SIGNAL(timeout()), this, SLOT(timeoutL()));
-    //qDebug() << QTime::currentTime().toString() << this << PV << "go on eventloop->exec";
-    eventLoop->exec();
-
-    //downloadfinished will continue
-    if(finished) return true;
-    else return false;
-}
-
-void sfRetrieval::close()
-{
-    deleteLater();
 }
 
+// does not wait, requestFinished() follows when the reply is aborted or when a decoding has finished
 void sfRetrieval::cancelDownload()
 {
-    totalCount = 0;
     aborted = true;
+    timeoutHelper->stop();
 
-    disconnect(manager);
-    if( reply != NULL ) {
+    if(reply != (QNetworkReply *) 0) {
         //qDebug() << QTime::currentTime().toString() << this << PV << "!!!!!!!!!!!!!!!!! abort networkreply for";
         reply->abort();
-        reply->deleteLater();
-        reply = NULL;
     }
-
-    downloadFinished();
-    deleteLater();
 }
 
-int sfRetrieval::downloadFinished()
+void sfRetrieval::finishReply()
 {
-    //qDebug() << QTime::currentTime().toString() << this << PV << "download finished";
-    //eventLoop->processEvents();
-#if QT_VERSION > QT_VERSION_CHECK(4, 8, 0)
-    eventLoop->quit();
-#else
-    eventLoop->exit();
-#endif
-    return finished;
-}
+    timeoutHelper->stop();
+    if(reply == (QNetworkReply *) 0) return;
+    QNetworkReply *thisReply = reply;
+    reply = (QNetworkReply *) 0;
+    thisReply->deleteLater();
 
-void sfRetrieval::finishReply(QNetworkReply *reply)
-{
-    if(aborted) return;
+    if(aborted) {
+        emit requestFinished();
+        return;
+    }
     //qDebug() << QTime::currentTime().toString() << this << PV << "reply received";
-    int count = 0;
-    struct timeb now;
-    int valueIndex = 2;
-    int expected = 3;
-    double seconds;
-    if(isBinned) {
-        valueIndex = 3;
-        expected = 5;
+
+    if(timedOut) {
+        errorString = "http request timeout";
+        emit requestFinished();
+        return;
     }
 
-    QVariant status =  reply->attribute(QNetworkRequest::HttpStatusCodeAttribute);
+    QVariant status =  thisReply->attribute(QNetworkRequest::HttpStatusCodeAttribute);
     if(status.toInt() != 200) {
-        errorString = tr("unexpected http status code %1 [%2] from %3").arg(status.toInt()).arg(reply->attribute(QNetworkRequest::HttpReasonPhraseAttribute).toString()).arg(downloadUrl.toString());
+        errorString = tr("unexpected http status code %1 [%2] from %3").arg(status.toInt()).arg(thisReply->attribute(QNetworkRequest::HttpReasonPhraseAttribute).toString()).arg(downloadUrl.toString());
         //qDebug() << QTime::currentTime().toString() << this << PV << "finishreply" << errorString;
         emit requestFinished();
-        reply->deleteLater();
         return;
     }
 
-    if(reply->error()) {
-        errorString = tr("%1: %2").arg(parseError(reply->error())).arg(downloadUrl.toString());
+    if(thisReply->error()) {
+        errorString = tr("%1: %2").arg(parseError(thisReply->error())).arg(downloadUrl.toString());
         //qDebug() << QTime::currentTime().toString() << this << PV << "finishreply" << errorString;
         emit requestFinished();
-        reply->deleteLater();
         return;
     }
 
-    QString out = QString(reply->readAll());
-    reply->deleteLater();
+    // the decoding of large replies must not hold up the gui thread
+    pool->start(new sfDecodeTask(this, thisReply->readAll()));
+}
+
+void sfRetrieval::decodeFinished()
+{
+    emit requestFinished();
+}
+
+// runs in a thread of the pool, the retrieval is not touched by the gui thread meanwhile
+void sfRetrieval::decode(const QByteArray &data)
+{
+    struct timeb now;
+    double seconds;
+#ifdef CSV
+    int count = 0;
+    int valueIndex = 2;
+    int expected = 3;
+    if(isBinned) {
+        valueIndex = 3;
+        expected = 5;
+    }
+#endif
 
     errorString = "";
     ftime(&now);
@@ -195,13 +214,13 @@ void sfRetrieval::finishReply(QNetworkReply *reply)
 
 
 #ifdef CSV
+    QString out = QString(data);
     QStringList result = out.split("\n", QString::SkipEmptyParts);
     //printf("number of values received = %d\n",  result.count());
 
     if(result.count() < 2) {
         if(result.count() == 1) errorString = tr("result too small %1:[%2]").arg(QString::number(result.count())).arg(result[0]);
         else errorString = tr("result too small %1").arg(QString::number(result.count()));
-        emit requestFinished();
         return;
     }
 
@@ -213,25 +232,22 @@ void sfRetrieval::finishReply(QNetworkReply *reply)
         QStringList line = result[i].split(";", QString::SkipEmptyParts);
         if(line.count() != expected) {
             errorString = tr("dataline has not the expected number of items %1: [%2]").arg(QString::number(line.count())).arg(expected);
-            emit requestFinished();
             return;
         } else {
             //qDebug() << "i=" << i <<  "linecount" << line.count() << line[1];
             double archiveTime = line[1].toDouble(&ok1);
             if(ok1) {
                 if((seconds - archiveTime) < secndsPast) {
-                    X[count] = -(seconds - archiveTime) / 3600.0;
+                    X[count] = archiveTime;
                     Y[count] = line[valueIndex].toDouble(&ok2);
                     if(ok2) count++;
                     else {
                         errorString = tr("could not decode value %1 at position %2").arg(line[valueIndex].arg(valueIndex));
-                        emit requestFinished();
                         return;
                     }
                 }
             } else {
                 errorString = tr("could not decode time %1 at position").arg(line[1].arg(1));
-                emit requestFinished();
                 return;
             }
         }
@@ -240,204 +256,24 @@ void sfRetrieval::finishReply(QNetworkReply *reply)
 
 #else
 
-    totalCount = 0;
-    int stat;
-    Backend = "";
-
-    JSONValue *value = JSON::Parse(qasc(out));
-
-    //printf("\n\nout: %s\n\n", qasc(out));
-
-    // Did it go wrong?
-    if (value == NULL) {
-        errorString = tr("could not parse json string left=%1 right=%2").arg(out.left(20)).arg(out.right(20));
-        //qDebug() << QTime::currentTime().toString() << this << PV << "finishreply" << errorString;
-        emit requestFinished();
+    // the reply is decoded in place directly into the data vectors, times in seconds since the epoch
+    sfDecoder decoder(data, isBinned);
+    bool ok = decoder.decode(seconds, secndsPast, X, Y);
+    Backend = decoder.backend();
+    if(!ok) {
+        errorString = decoder.lastError();
+        //qDebug() << QTime::currentTime().toString() << this << PV << "decode" << errorString;
         return;
-    } else {
-
-        if(!value->IsArray()) {
-            qDebug() << QTime::currentTime().toString() << "finishreply the json root element is not an array, something has changed";
-        }
-
-        if(value->IsArray()) {
-            JSONArray array = value->AsArray();
-
-            for (unsigned int i = 0; i < array.size(); i++) {
-                JSONValue *value1 = JSON::Parse(array[i]->Stringify().c_str());
-
-                if(value1->IsObject()) {
-
-                    JSONObject root;
-                    root = value1->AsObject();
-
-                    // find channel data inside this part of array
-                    if (root.find(L"channel") != root.end() && root[L"channel"]->IsObject()) {
-                        //qDebug() << "\nchannel part found as object";
-                        JSONValue *value2 = JSON::Parse(root[L"channel"]->Stringify().c_str());
-                        JSONObject root0 = value2->AsObject();
-
-                        // get channel name
-                        if (root0.find(L"name") != root0.end() && root0[L"name"]->IsString()) {
-                            std::wstring data=root0[L"name"]->Stringify();
-                            char *channel = new char[data.size()+1];
-                            sprintf(channel,"%ls", data.c_str());
-                            //qDebug()<< "channel name found" << root0[L"name"]->AsString().c_str() << channel;
-                            delete channel;
-                        }
-
-                        // get backend name
-                        if (root0.find(L"backend") != root0.end() && root0[L"backend"]->IsString()) {
-                            //char backend[800];
-                            std::wstring data=root0[L"backend"]->Stringify();
-                            char *backend = new char[data.size()+1];
-                            sprintf(backend,"%ls", data.c_str());
-                            Backend = QString(backend);
-                            Backend = Backend.replace("\"", "");
-                            //qDebug()<< "backend name found" << root0[L"backend"]->AsString().c_str() << backend;
-                            delete backend;
-                        }
-                        delete value2;
-                    }
-
-                    // find data array inside this part of array
-                    if (root.find(L"data") != root.end() && root[L"data"]->IsArray()) {
-                        JSONArray array = root[L"data"]->AsArray();
-                        //qDebug() << "\ndata part found as array" << array.size();
-
-                        // scan the data part (big array)
-                        if(array.size() < 1) {
-                            errorString = tr("no data from %1 : %2").arg(downloadUrl.toString()).arg(Backend);
-                            //qDebug() << QTime::currentTime().toString() << this << PV << "finishreply" << errorString;
-                            emit requestFinished();
-                            delete value;
-                            delete value1;
-                            return;
-                        }
-
-                        // set array size
-                        X.resize(array.size());
-                        Y.resize(array.size());
-
-                        // binned data
-                        if(isBinned) {
-
-                            for (unsigned int i = 0; i < array.size(); i++) {
-                                bool valueFound = false;
-                                bool timeFound = false;
-                                double mean;
-                                double archiveTime;
-
-                                // find value part now
-                                JSONObject root1 = array[i]->AsObject();
-                                if (root1.find(L"value") != root1.end() && root1[L"value"]->IsObject()) {
-                                    JSONValue *value2 = JSON::Parse(root1[L"value"]->Stringify().c_str());
-                                    JSONObject root2 = value2->AsObject();
-
-                                    // look for mean
-                                    if (root2.find(L"mean") != root2.end() && root2[L"mean"]->IsNumber()) {
-                                        //qDebug() << "mean part found";
-                                        stat = swscanf(root2[L"mean"]->Stringify().c_str(), L"%lf", &mean);
-                                        valueFound = true;
-                                    }
-                                    delete value2;
-                                }
-
-                                // look for globalSeconds
-                                if (root1.find(L"globalSeconds") != root1.end() && root1[L"globalSeconds"]->IsString()) {
-                                    //qDebug()<< "globalSeconds part found";
-                                    if(getDoubleFromString(QString::fromWCharArray(root1[L"globalSeconds"]->AsString().c_str()), archiveTime)){
-                                        timeFound = true;
-                                    } else {
-                                        qDebug() << tr("could not decode globalSeconds ????");
-                                        break;
-                                    }
-                                }
-
-                                // fill in our data
-                                if(timeFound && valueFound && (seconds - archiveTime) < secndsPast) {
-                                    if(!timAxis) X[count] = -(seconds - archiveTime) / 3600.0;
-                                    else X[count] = archiveTime * 1000;
-                                    Y[count] = mean;
-                                    //qDebug() << "binned" << X[count] << Y[count];
-                                    count++;
-                                }
-
-                            }
-
-                            // non binned data
-                        } else {
-
-                            bool valueFound = false;
-                            bool timeFound = false;
-                            double mean;
-                            double archiveTime;
-                            for (unsigned int i = 0; i < array.size(); i++) {
-
-                                // simple value
-                                JSONObject root1 = array[i]->AsObject();
-                                if (root1.find(L"value") != root1.end() && root1[L"value"]->IsNumber()) {
-                                    //qDebug() << "value found";
-                                    stat = swscanf(root1[L"value"]->Stringify().c_str(), L"%lf", &mean);
-                                    valueFound = true;
-                                } else
-
-                                    // an array
-                                    if (root1.find(L"value") != root1.end() && root1[L"value"]->IsArray()) {
-                                        //qDebug() << "\nvalue part found as array, not yet supported" << array.size();
-                                        errorString = tr("waveforms not supported");
-                                        //qDebug()<< QTime::currentTime().toString()  << this << PV << "finishreply" << errorString;
-                                        emit requestFinished();
-                                        return;
-                                    }
-
-                                // look for globalSeconds
-                                if (root1.find(L"globalSeconds") != root1.end() && root1[L"globalSeconds"]->IsString()) {
-                                    //qDebug()<< "globalSeconds part found";
-                                    if(getDoubleFromString(QString::fromWCharArray(root1[L"globalSeconds"]->AsString().c_str()), archiveTime)){
-                                        timeFound = true;
-                                        //qDebug() << "time found" << archiveTime;
-                                    } else {
-                                        qDebug() << tr("could not decode globalSeconds ????");
-                                        break;
-                                    }
-                                }
-
-                                // fill in our data
-                                if(timeFound && valueFound && (seconds - archiveTime) < secndsPast) {
-                                    if(!timAxis) X[count] = -(seconds - archiveTime) / 3600.0;
-                                    else X[count] = archiveTime *1000;
-                                    Y[count] = mean;
-                                    //qDebug() << "not binned" << X[count] << Y[count];
-                                    count++;
-                                }
-                            }
-                        }
-                    }
-                }
-                delete value1;
-            }
-        }
-        delete value;
     }
 
-    totalCount = count;
-    //qDebug() << QTime::currentTime().toString() << this << PV << "finishreply totalcount =" << count << reply;
+    // no data is reported by a count of 0
+    if(decoder.count() == 0) errorString = tr("no data from %1 : %2").arg(downloadUrl.toString()).arg(Backend);
+    totalCount = decoder.count();
+    //qDebug() << QTime::currentTime().toString() << this << PV << "decode totalcount =" << totalCount;
 
 #endif
 
     finished = true;
-    emit requestFinished();
-}
-
-bool sfRetrieval::getDoubleFromString(QString input, double &value) {
-    bool ok;
-    value = input.toDouble(&ok);
-    if(ok) {
-        return true;
-    } else {
-        return false;
-    }
 }
 
 int sfRetrieval::getCount()
@@ -29,64 +29,63 @@
 #include <QDebug>
 #include <QObject>
 #include <QNetworkReply>
-#include <QTableWidget>
-#include <QMessageBox>
-#include <QEventLoop>
+#include <QTimer>
+#include <QThreadPool>
 
 //#define CSV 1
 
-#ifndef CSV
-#include "JSON.h"
-#endif
-
 class QNetworkAccessManager;
 
+// one request to the data api, posted with the network manager shared by all retrievals of the plugin;
+// requestUrl() does not wait, the reply is decoded in a thread of the pool and requestFinished() is
+// emitted when the data (or the error) are there, also after a cancelDownload()
 class sfRetrieval:public QObject
 {
     Q_OBJECT
 
 public:
-    sfRetrieval();
+    sfRetrieval(QNetworkAccessManager *networkManager, QThreadPool *threadPool);
     ~sfRetrieval() {
         X.clear();
         Y.clear();
         //qDebug() << this << "destructor" << PV;
     }
-    bool requestUrl(const QUrl url, const QByteArray &json, int secondsPast, bool binned, bool timeAxis, QString key);
+    void requestUrl(const QUrl url, const QByteArray &json, int secondsPast, bool binned, QString key);
+    bool isFinished() {return finished;}
+    bool isAborted() {return aborted;}
     const QString lastError();
     int getCount();
     void getData(QVector<double> &x, QVector<double> &y);
     const QString getBackend();
     void cancelDownload();
-    void close();
 
 signals:
-    void networkError(const QString);
     void requestFinished();
 
 protected slots:
-    void finishReply(QNetworkReply*);
+    void finishReply();
+    void decodeFinished();
     const QString parseError(QNetworkReply::NetworkError error);
-    int downloadFinished();
     void timeoutL();
 
 private:
+    friend class sfDecodeTask;
+    void decode(const QByteArray &data);
 
-    bool getDoubleFromString(QString input, double &value);
     QNetworkAccessManager *manager;
+    QThreadPool *pool;
     QNetworkReply *reply;
-    QTableWidget *thisTable;
-    QString thisFile;
+    QTimer *timeoutHelper;
     int finished;
     QUrl downloadUrl;
     QString errorString;
     QVector<double> X,Y;
     int totalCount;
     int secndsPast;
-    QEventLoop *eventLoop;
-    bool isBinned, timAxis;
+    bool isBinned;
     QString Backend;
     bool aborted;
+    bool timedOut;
     QString PV;
 };
 
@@ -25,16 +25,31 @@
 #include <QDebug>
 #include <QThread>
 #include <QApplication>
+#include <QHash>
+#include <algorithm>
 #include "archiverCommon.h"
+#include "archiveDiskCache.h"
 
 #define SECONDSSLEEP 3600       // 1 hour
 #define SECONDSTIMEOUT 60.5     // 1 minute
+#define SECONDSINFLIGHT 90      // a request of a series not answered after this time is repeated
+#define CACHEBUDGET 65536       // kB of samples kept for the series not shown anymore
+#define CHUNKSETTLE 300         // seconds until the archive is taken to be complete
+#define CHUNKDAYS 31            // days the chunks are kept on disk
+#define ZOOMBINS 16             // bins per pixel at most, when zoomed in far from now
 
 // constructor
-ArchiverCommon::ArchiverCommon()
+ArchiverCommon::ArchiverCommon(const QString &pluginName)
 {
+    struct timeb now;
     qDebug() << "ArchivePlugin: Create";
     mutexP = new QMutex;
+    retiredSeries.setMaxCost(CACHEBUDGET);
+    automaticBinning = false;
+
+    ftime(&now);
+    diskCache = new ArchiveDiskCache(pluginName);
+    diskCache->prune((double) now.time - CHUNKDAYS * 86400.0);
 }
 
 void ArchiverCommon::stopUpdateInterface()
@@ -49,6 +64,8 @@ void ArchiverCommon::updateInterface()
     double diff;
     struct timeb now;
     QMap<QString, indexes> listOfIndexesToBeExecuted;
+    QMap<QString, indexes> listOfRequests;
+    QHash<QString, int> longestWindow;
     listOfIndexesToBeExecuted.clear();
 
     QMutexLocker locker(&mutex);
@@ -62,11 +79,24 @@ void ArchiverCommon::updateInterface()
 
     // copy indexes to be executed when it is time
     ftime(&now);
+    double seconds = (double) now.time + (double) now.millitm / (double)1000;
 
     QMap<QString, indexes>::const_iterator i = listOfIndexes.constBegin();
     while (i != listOfIndexes.constEnd()) {
         indexes indexNew = i.value();
 
+        // a new resolution is requested at once, the request of the former one is not needed anymore
+        if(automaticBinning) {
+            QString former = indexNew.series;
+            bool changed = updateBinning(indexNew, seconds);
+            if(changed) indexNew.lastUpdateTime.time = 0;
+            listOfIndexes.insert(i.key(), indexNew);
+            if(changed) {
+                retireSeries(former);
+                emit Signal_AbortOutstandingRequests(i.key());
+            }
+        }
+
         diff = ((double) now.time + (double) now.millitm / (double)1000) -
                ((double) indexNew.lastUpdateTime.time + (double) indexNew.lastUpdateTime.millitm / (double)1000);
         // is it time to update ?
@@ -76,8 +106,58 @@ void ArchiverCommon::updateInterface()
             listOfIndexes.insert(i.key(), indexNew);
             listOfIndexesToBeExecuted.insert(i.key(), indexNew);
         }
+        int window = windowOf(indexNew, seconds);
+        if(window > longestWindow.value(indexNew.series, 0)) longestWindow.insert(indexNew.series, window);
         ++i;
     }
+
+    // one request per series, none while one is outstanding; the request covers the longest window of the series
+    i = listOfIndexesToBeExecuted.constBegin();
+    while (i != listOfIndexesToBeExecuted.constEnd()) {
+        indexes indexNew = i.value();
+        ++i;
+
+        QMap<QString, archiveSeries>::iterator s = listOfSeries.find(indexNew.series);
+        if(s == listOfSeries.end()) {
+            archiveSeries *retired = retiredSeries.take(indexNew.series);
+            if(retired != (archiveSeries *) 0) {
+                s = listOfSeries.insert(indexNew.series, *retired);
+                delete retired;
+            } else {
+                archiveSeries series;
+                series.secondsPast = 0;
+                series.requestTime = 0.0;
+                series.coveredFrom = 0.0;
+
+                // the closed chunks on disk give the beginning of the window
+                int window = longestWindow.value(indexNew.series, windowOf(indexNew, seconds));
+                series.storedUntil = diskCache->load(indexNew.series, seconds - window, seconds, series.samples);
+                if(series.storedUntil > 0.0) {
+                    series.secondsPast = window;
+                    series.coveredFrom = seconds - window;
+                }
+                s = listOfSeries.insert(indexNew.series, series);
+            }
+        }
+        archiveSeries &series = s.value();
+        if((series.requestTime > 0.0) && ((seconds - series.requestTime) < SECONDSINFLIGHT)) continue;
+        if(listOfRequests.contains(indexNew.series)) continue;
+
+        // only the samples newer than the last one held (or the chunks on disk) have to be requested
+        indexNew.secondsPast = longestWindow.value(indexNew.series, windowOf(indexNew, seconds));
+        indexNew.lastSampleTime = 0.0;
+        if((!series.samples.times.isEmpty() || (series.storedUntil > 0.0)) && (series.secondsPast >= indexNew.secondsPast)) {
+            double last = series.storedUntil;
+            if(!series.samples.times.isEmpty()) last = qMax(last, series.samples.times.last());
+            if((seconds - last) < indexNew.secondsPast) indexNew.lastSampleTime = last;
+        }
+        series.requestTime = seconds;
+        indexNew.requestTime = seconds;
+        listOfRequests.insert(indexNew.series, indexNew);
+    }
+
+    listOfIndexesToBeExecuted.clear();
+    foreach(indexes indexNew, listOfRequests) listOfIndexesToBeExecuted.insert(indexNew.key, indexNew);
     //qDebug() << "number of indexes to execute" << listOfIndexesToBeExecuted.count();
 
     // call user routine for updating data
@@ -166,6 +246,19 @@ int ArchiverCommon::pvAddMonitor(int index, knobData *kData, int rate, int skip)
         index.updateSecondsOrig = index.updateSeconds;
 
         index.init = true;
+        index.lastSampleTime = 0.0;
+        // a fixed number of bins gives bins of the same width only over the same window
+        bool fixedBins;
+        int nrOfBins = w->property("nrOfBins").toInt(&fixedBins);
+        index.binWidth = (fixedBins && nrOfBins > 0) ? (double) index.secondsPast / nrOfBins : 0.0;
+        index.seriesBase = QString("%1|%2|%3|%4").arg(QString(kData->pv).replace(".X", "").replace(".Y", ""))
+                .arg(w->property("backend").toString().trimmed().toLower())
+                .arg(index.binWidth > 0.0 ? QString::number(index.binWidth, 'g', 10) : QString())
+                .arg(w->property("archiverIndex").toString());
+        index.series = index.seriesBase;
+        index.zoomFrom = 0.0;
+        index.binSeconds = 0;
+        index.requestTime = 0.0;
         index.key = key;
         index.mutexP = mutexP;
         index.pv = QString(kData->pv);
@@ -232,50 +325,209 @@ void ArchiverCommon::updateSecondsPast(indexes indexNew, bool original)
     }
 }
 
-void ArchiverCommon::updateCartesian(int nbVal, indexes indexNew, QVector<double> TimerN, QVector<double> YValsN, QString backend)
+// a request cancelled or aborted without result does not hold up the next request of its series until it
+// would be repeated anyway; a newer request of the series may be outstanding already
+void ArchiverCommon::requestCancelled(indexes indexNew)
 {
+    QMutexLocker locker(&mutex);
+    QMap<QString, archiveSeries>::iterator s = listOfSeries.find(indexNew.series);
+    if(s == listOfSeries.end()) return;
+    if(s.value().requestTime == indexNew.requestTime) s.value().requestTime = 0.0;
+}
+
+// the samples received are merged into the samples held for the series, the samples older than the
+// window of the series are dropped and every widget showing the series gets its window; returns the
+// number of samples held
+int ArchiverCommon::updateCartesian(int nbVal, indexes indexNew, QVector<double> TimerN, QVector<double> YValsN, QString backend)
+{
+    struct timeb now;
     QMutexLocker locker(&mutex);
     //qDebug() << "ArchiverCommon::updateCartesian";
+
+    // monitors of this series cleared meanwhile
+    QMap<QString, archiveSeries>::iterator s = listOfSeries.find(indexNew.series);
+    if(s == listOfSeries.end()) return 0;
+    archiveSeries &series = s.value();
+    archiveSamples &samples = series.samples;
+    double requestTime = series.requestTime;
+    series.requestTime = 0.0;
+
+    ftime(&now);
+    double seconds = (double) now.time + (double) now.millitm / (double)1000;
+
+    // a whole window replaces the samples held, a delta replaces the samples from its first one on,
+    // while the last sample held (or bin) may have been incomplete
+    if(indexNew.lastSampleTime <= 0.0) {
+        samples.times.clear();
+        samples.values.clear();
+        series.secondsPast = indexNew.secondsPast;
+        series.coveredFrom = seconds - indexNew.secondsPast;
+    }
     if(nbVal > 0) {
-        knobData kData = mutexknobdataP->GetMutexKnobData(indexNew.indexX);
-        if(kData.index == -1) return;
-        mutexknobdataP->DataLock(&kData);
-        kData.edata.fieldtype = caDOUBLE;
-        kData.edata.connected = true;
-        kData.edata.accessR = kData.edata.accessW = true;
-        kData.edata.monitorCount++;
-        strcpy(kData.edata.fec, qasc(backend));
-
-        if((nbVal * sizeof(double)) > (size_t) kData.edata.dataSize) {
-            if(kData.edata.dataB != (void*) 0) free(kData.edata.dataB);
-            kData.edata.dataB = (void*) malloc(nbVal * sizeof(double));
-            kData.edata.dataSize = nbVal * sizeof(double);
+        int keep = std::lower_bound(samples.times.constBegin(), samples.times.constEnd(), TimerN[0]) - samples.times.constBegin();
+        samples.times.resize(keep);
+        samples.values.resize(keep);
+        for(int i = 0; i < nbVal; i++) {
+            if(!samples.times.isEmpty() && TimerN[i] < samples.times.last()) continue;
+            samples.times.append(TimerN[i]);
+            samples.values.append(YValsN[i]);
         }
-        memcpy(kData.edata.dataB, &TimerN[0],  nbVal * sizeof(double));
-        kData.edata.valueCount = nbVal;
-        mutexknobdataP->SetMutexKnobDataReceived(&kData);
-        mutexknobdataP->DataUnlock(&kData);
-
-        kData = mutexknobdataP->GetMutexKnobData(indexNew.indexY);
-        if(kData.index == -1) return;
-        mutexknobdataP->DataLock(&kData);
-        kData.edata.fieldtype = caDOUBLE;
-        kData.edata.connected = true;
-        kData.edata.accessR = kData.edata.accessW = true;
-        kData.edata.monitorCount++;
-        strcpy(kData.edata.fec, qasc(backend));
-
-        if((nbVal * sizeof(double)) > (size_t) kData.edata.dataSize) {
-            if(kData.edata.dataB != (void*) 0) free(kData.edata.dataB);
-            kData.edata.dataB = (void*) malloc(nbVal * sizeof(double));
-            kData.edata.dataSize = nbVal * sizeof(double);
-        }
-        memcpy(kData.edata.dataB, &YValsN[0],  nbVal * sizeof(double));
+    }
+
+    // the chunks closed meanwhile go to disk before they leave the window
+    if(requestTime > 0.0) {
+        double stored = diskCache->store(indexNew.series, samples, qMax(series.coveredFrom, series.storedUntil), requestTime - CHUNKSETTLE);
+        if(stored > series.storedUntil) series.storedUntil = stored;
+    }
 
-        kData.edata.valueCount = nbVal;
-        mutexknobdataP->SetMutexKnobDataReceived(&kData);
-        mutexknobdataP->DataUnlock(&kData);
+    int expired = std::lower_bound(samples.times.constBegin(), samples.times.constEnd(), seconds - series.secondsPast) - samples.times.constBegin();
+    if(expired > 0) {
+        samples.times.remove(0, expired);
+        samples.values.remove(0, expired);
     }
+    series.coveredFrom = qMax(series.coveredFrom, seconds - series.secondsPast);
+
+    int count = samples.times.count();
+    if(count < 1) return 0;
+
+    QMap<QString, indexes>::const_iterator i = listOfIndexes.constBegin();
+    while (i != listOfIndexes.constEnd()) {
+        if(i.value().series == indexNew.series) updateWidget(i.value(), samples, seconds, backend);
+        ++i;
+    }
+
+    return count;
+}
+
+// gives the samples of the window of a widget to its x and y channels
+void ArchiverCommon::updateWidget(const indexes &index, const archiveSamples &samples, double seconds, const QString &backend)
+{
+    int first = std::lower_bound(samples.times.constBegin(), samples.times.constEnd(), seconds - windowOf(index, seconds)) - samples.times.constBegin();
+    int count = samples.times.count() - first;
+    if(count < 1) return;
+
+    knobData kData = mutexknobdataP->GetMutexKnobData(index.indexX);
+    if(kData.index == -1) return;
+    mutexknobdataP->DataLock(&kData);
+    kData.edata.fieldtype = caDOUBLE;
+    kData.edata.connected = true;
+    kData.edata.accessR = kData.edata.accessW = true;
+    kData.edata.monitorCount++;
+    strcpy(kData.edata.fec, qasc(backend));
+
+    if((count * sizeof(double)) > (size_t) kData.edata.dataSize) {
+        if(kData.edata.dataB != (void*) 0) free(kData.edata.dataB);
+        kData.edata.dataB = (void*) malloc(count * sizeof(double));
+        kData.edata.dataSize = count * sizeof(double);
+    }
+
+    // time axis in milliseconds since the epoch, otherwise in hours before now
+    double *x = (double *) kData.edata.dataB;
+    const double *times = samples.times.constData() + first;
+    if(index.timeAxis) {
+        for(int i = 0; i < count; i++) x[i] = times[i] * 1000.0;
+    } else {
+        for(int i = 0; i < count; i++) x[i] = -(seconds - times[i]) / 3600.0;
+    }
+    kData.edata.valueCount = count;
+    mutexknobdataP->SetMutexKnobDataReceived(&kData);
+    mutexknobdataP->DataUnlock(&kData);
+
+    kData = mutexknobdataP->GetMutexKnobData(index.indexY);
+    if(kData.index == -1) return;
+    mutexknobdataP->DataLock(&kData);
+    kData.edata.fieldtype = caDOUBLE;
+    kData.edata.connected = true;
+    kData.edata.accessR = kData.edata.accessW = true;
+    kData.edata.monitorCount++;
+    strcpy(kData.edata.fec, qasc(backend));
+
+    if((count * sizeof(double)) > (size_t) kData.edata.dataSize) {
+        if(kData.edata.dataB != (void*) 0) free(kData.edata.dataB);
+        kData.edata.dataB = (void*) malloc(count * sizeof(double));
+        kData.edata.dataSize = count * sizeof(double);
+    }
+    memcpy(kData.edata.dataB, samples.values.constData() + first,  count * sizeof(double));
+
+    kData.edata.valueCount = count;
+    mutexknobdataP->SetMutexKnobDataReceived(&kData);
+    mutexknobdataP->DataUnlock(&kData);
+}
+
+// a series not shown anymore goes to the cache, the cost is given in kB; the caller holds the lock
+void ArchiverCommon::retireSeries(const QString &series)
+{
+    // an outstanding request of the widget removed gets aborted
+    QMap<QString, archiveSeries>::iterator s = listOfSeries.find(series);
+    if(s == listOfSeries.end()) return;
+    s.value().requestTime = 0.0;
+
+    QMap<QString, indexes>::const_iterator i = listOfIndexes.constBegin();
+    while (i != listOfIndexes.constEnd()) {
+        if(i.value().series == series) return;
+        ++i;
+    }
+
+    archiveSeries *retired = new archiveSeries(s.value());
+    retired->requestTime = 0.0;
+    listOfSeries.erase(s);
+    if(retired->samples.times.isEmpty()) {
+        delete retired;
+        return;
+    }
+    int cost = (retired->samples.times.count() * 2 * sizeof(double)) / 1024 + 1;
+    retiredSeries.insert(series, retired, cost);
+}
+
+// the window of an index; zoomed in, from the start of the zoom on, in powers of two seconds so that
+// the window does not grow with every request
+int ArchiverCommon::windowOf(const indexes &index, double seconds)
+{
+    if(index.zoomFrom <= 0.0) return index.secondsPast;
+    int window = 1;
+    while((window < seconds - index.zoomFrom) && (window < index.secondsPast)) window *= 2;
+    return qMin(window, index.secondsPast);
+}
+
+// automatic binning for plots without nrOfBins: the bin width is the time of a pixel rounded down to a power of two
+// seconds, so that every resolution is a series of its own, cached like the tiles of a map. zoomed in, the window
+// goes from the start of the zoom to now, with a limited number of bins; returns true when the series changed
+bool ArchiverCommon::updateBinning(indexes &index, double seconds)
+{
+    caCartesianPlot* w = qobject_cast<caCartesianPlot *>((QWidget*) index.w);
+    if(w == (caCartesianPlot *) 0 || !w->property("nrOfBins").isNull()) return false;
+
+    int pixels = w->canvas()->contentsRect().width();
+    if(pixels < 1) pixels = w->width();
+    if(pixels < 1) return false;
+
+    double minX, maxX;
+    double zoomFrom = 0.0;
+    double zoomTo = seconds;
+    if(w->getZoomedX(minX, maxX)) {
+        // time axis in milliseconds since the epoch, otherwise in hours before now
+        if(index.timeAxis) {
+            zoomFrom = minX / 1000.0;
+            zoomTo = maxX / 1000.0;
+        } else {
+            zoomFrom = seconds + minX * 3600.0;
+            zoomTo = seconds + maxX * 3600.0;
+        }
+        if((zoomFrom <= seconds - index.secondsPast) || (zoomFrom >= seconds) || (zoomTo <= zoomFrom)) zoomFrom = 0.0;
+    }
+
+    double binWidth;
+    if(zoomFrom > 0.0) binWidth = qMax((qMin(zoomTo, seconds) - zoomFrom) / pixels, (seconds - zoomFrom) / (ZOOMBINS * pixels));
+    else binWidth = (double) index.secondsPast / pixels;
+    int binSeconds = 1;
+    while((binSeconds * 2 <= binWidth) && (binSeconds < (1 << 24))) binSeconds *= 2;
+
+    index.zoomFrom = zoomFrom;
+    index.binSeconds = binSeconds;
+    QString series = index.seriesBase + "|" + QString::number(binSeconds);
+    if(series == index.series) return false;
+    index.series = series;
+    return true;
 }
 
 // caQtDM_Lib will call this routine for getting rid of a monitor
@@ -311,9 +563,13 @@ int ArchiverCommon::pvClearMonitor(knobData *kData) {
                 ++i;
             }
 
+            mutex.lock();
+            QString series = listOfIndexes.value(key).series;
             for(int i=0; i< removeKeys.count(); i++) {
                 listOfIndexes.remove(removeKeys.at(i));
             }
+            retireSeries(series);
+            mutex.unlock();
             emit Signal_AbortOutstandingRequests(key);
         }
     }
@@ -31,12 +31,36 @@
 #include <QList>
 #include <QTimer>
 #include <QThread>
+#include <QVector>
+#include <QCache>
 #include <qwt.h>
 #include "cacartesianplot.h"
 #include "mutexKnobData.h"
 #include "MessageWindow.h"
 
-struct indexes {QString key; int indexX; int indexY; int secondsPast; QString pv; float updateSeconds; struct timeb lastUpdateTime; QWidget *w; int nrOfBins; QMutex *mutexP; bool init; QString backend; int updateSecondsOrig; bool timeAxis;};
+struct indexes {QString key; int indexX; int indexY; int secondsPast; QString pv; float updateSeconds; struct timeb lastUpdateTime; QWidget *w; int nrOfBins; QMutex *mutexP; bool init; QString backend; int updateSecondsOrig; bool timeAxis; double lastSampleTime; QString series;
+                QString seriesBase; double zoomFrom; int binSeconds; double binWidth; double requestTime;};
+
+// with automatic binning, the series of an index (seriesBase with the bin width) follows the pixel width and the
+// zoom of the plot: binSeconds gives the bin width, zoomFrom the start of the zoom (0 when not zoomed)
+// with a fixed nrOfBins, binWidth is the width of these bins over the own window of the widget (0 otherwise);
+// widgets with the same bin width share the series, whose requests keep that width over the longest window
+// requestTime is the time a request of the series was made with this index
+
+// samples held for a key, times in seconds since the epoch in ascending order
+// the retrievals only ask for the samples newer than the last one held (lastSampleTime of indexes, 0 when
+// the whole window has to be requested) and deliver their times in seconds since the epoch
+struct archiveSamples {QVector<double> times; QVector<double> values;};
+
+// the samples of one pv from one archive with one binning (series of indexes), requested and held once for all the
+// widgets showing it; each widget gets a copy of its window in the data of its channels, the transformation of the
+// times depends on the widget and the channel data can not refer to shared memory.
+// only one request is made for a series at a time, covering the longest window of its widgets. the series not shown
+// anymore are kept in a cache limited in size, so that reopening a display only needs the samples since then.
+// the samples are complete from coveredFrom on, the chunks up to storedUntil are on disk
+struct archiveSeries {archiveSamples samples; int secondsPast; double requestTime; double coveredFrom; double storedUntil;};
+
+class ArchiveDiskCache;
 #define CHAR_ARRAY_LENGTH 200
 
 class Q_DECL_EXPORT ArchiverCommon : public QObject
@@ -44,7 +68,7 @@ class Q_DECL_EXPORT ArchiverCommon : public QObject
     Q_OBJECT
 
 public:
-    ArchiverCommon();
+    ArchiverCommon(const QString &pluginName = QString());
 
     int initCommunicationLayer(MutexKnobData *data, MessageWindow *messageWindow, QMap<QString, QString> options);
     int pvAddMonitor(int index, knobData *kData, int rate, int skip);
@@ -53,8 +77,10 @@ public:
     int pvClearEvent(void * ptr);
     int pvAddEvent(void * ptr);
     int TerminateIO() {return true;}
-    void updateCartesian(int nbVal, indexes indexNew, QVector<double> TimerN, QVector<double> YValsN, QString backend);
+    int updateCartesian(int nbVal, indexes indexNew, QVector<double> TimerN, QVector<double> YValsN, QString backend);
+    void requestCancelled(indexes indexNew);
     void updateSecondsPast(indexes indexNew, bool original);
+    void setAutomaticBinning(bool automatic) {automaticBinning = automatic;}
     QTimer *timer;
 
 protected:
@@ -68,6 +94,11 @@ private slots:
     void stopUpdateInterface();
 
 private:
+    void updateWidget(const indexes &index, const archiveSamples &samples, double seconds, const QString &backend);
+    void retireSeries(const QString &series);
+    bool updateBinning(indexes &index, double seconds);
+    static int windowOf(const indexes &index, double seconds);
+
     typedef struct  {char Dev[40];} device;
     QMutex mutex;
     QMutex *mutexP;
@@ -75,8 +106,12 @@ private:
     MessageWindow *messagewindowP;
 
     QMap<QString, indexes> listOfIndexes;
+    QMap<QString, archiveSeries> listOfSeries;
+    QCache<QString, archiveSeries> retiredSeries;
+    ArchiveDiskCache *diskCache;
 
     bool timerRunning;
+    bool automaticBinning;
 };
 
 
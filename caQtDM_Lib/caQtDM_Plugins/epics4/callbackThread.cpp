@@ -17,10 +17,10 @@
  *
  *  Copyright (c) 2010 - 2014
  *
- *  Authors:
- *    Marty Kraimer, Anton Mezger
+ *  Author:
+ *    Anton Mezger
  *  Contact details:
- *    anton.mezger@psi.ch, mrkraimer@comcast.net
+ *    anton.mezger@psi.ch
  */
 
 #include <iostream>
@@ -33,33 +33,111 @@ namespace epics { namespace pvData {
 
 CallbackThread::~CallbackThread()
 {
-cout << "CallbackThread::~CallbackThread()\n";
     stop();
-cout << "CallbackThread::~CallbackThread() returning\n";
+    for(size_t i = 0; i < consumers.size(); ++i) {
+        Consumer *consumer = consumers[i];
+        // a consumer cannot wait for itself, it ends after its batch
+        if(consumer->thread->isCurrentThread()) continue;
+        consumer->thread.reset();
+        Node *node = consumer->takeAll();
+        while(node) {
+            Node *next = node->next;
+            delete node;
+            node = next;
+        }
+        delete consumer;
+    }
+    consumers.clear();
+}
+
+void CallbackThread::startThreads(int threads)
+{
+    if(threads < 1) threads = 1;
+    for(int i = 0; i < threads; ++i) {
+        Consumer *consumer = new Consumer();
+        consumer->thread = std::tr1::shared_ptr<epicsThread>(new epicsThread(
+            *consumer,
+            "callbackThread",
+            epicsThreadGetStackSize(epicsThreadStackSmall),
+            epicsThreadPriorityLow));
+        consumers.push_back(consumer);
+        consumer->thread->start();
+    }
+}
+
+void CallbackThread::queueRequest(CallbackRequesterPtr const & callbackRequester)
+{
+    Node *node = new Node;
+    node->callbackRequester = callbackRequester;
+    node->next = 0;
+    size_t count = consumers.size();
+    if(count == 1) {
+        consumers[0]->push(node);
+    } else {
+        // a requester always goes to the same consumer, the low bits of a heap address are zero
+        size_t hash = ((size_t) callbackRequester.get()) >> 4;
+        consumers[hash % count]->push(node);
+    }
+}
+
+void CallbackThread::stop()
+{
+    for(size_t i = 0; i < consumers.size(); ++i) consumers[i]->stop();
+}
+
+void CallbackThread::Consumer::push(Node *node)
+{
+    // the consumer only ever empties the whole stack, so that a recycled top node does no harm
+    void *top = epicsAtomicGetPtrT(&head);
+    while(true) {
+        node->next = static_cast<Node *>(top);
+        void *previous = epicsAtomicCmpAndSwapPtrT(&head, top, node);
+        if(previous == top) break;
+        top = previous;
+    }
+    // signal only a consumer that waits or is about to wait
+    if(epicsAtomicCmpAndSwapIntT(&idle, 1, 0) == 1) wakeup.signal();
+}
+
+CallbackThread::Node *CallbackThread::Consumer::takeAll()
+{
+    void *top = epicsAtomicGetPtrT(&head);
+    while(top != 0) {
+        void *previous = epicsAtomicCmpAndSwapPtrT(&head, top, 0);
+        if(previous == top) break;
+        top = previous;
+    }
+    // the newest request is on top, reverse into arrival order
+    Node *batch = 0;
+    Node *node = static_cast<Node *>(top);
+    while(node) {
+        Node *next = node->next;
+        node->next = batch;
+        batch = node;
+        node = next;
+    }
+    return batch;
 }
 
-void CallbackThread::run()
+void CallbackThread::Consumer::run()
 {
-    CallbackRequesterPtr callbackRequester;
-    while(true) 
-    {
-        epicsThreadSleep(.2);
-        if(runStop.tryWait()) {
-            runReturn.signal();
-            return;
-        }    
-        {
-             epics::pvData::Lock xx(mutex);
-             if(monitorQueue.empty()) continue;
-             callbackRequester = monitorQueue.front();
-             monitorQueue.pop();
+    while(!epicsAtomicGetIntT(&stopped)) {
+        Node *batch = takeAll();
+        if(batch == 0) {
+            epicsAtomicSetIntT(&idle, 1);
+            // a request pushed just before idle was set did not signal
+            if(epicsAtomicGetPtrT(&head) != 0 || epicsAtomicGetIntT(&stopped)) {
+                epicsAtomicSetIntT(&idle, 0);
+                continue;
+            }
+            wakeup.wait();
+            continue;
         }
-        while(callbackRequester) {
-            callbackRequester->callback();
-            epics::pvData::Lock xx(mutex);
-            if(monitorQueue.empty()) break;
-            callbackRequester = monitorQueue.front();
-            monitorQueue.pop();
+        while(batch) {
+            Node *node = batch;
+            batch = batch->next;
+            if(!epicsAtomicGetIntT(&stopped)) node->callbackRequester->callback();
+            delete node;
         }
     }
 }
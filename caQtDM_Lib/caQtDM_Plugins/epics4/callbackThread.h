@@ -22,12 +22,14 @@
  *  Contact details:
  *    anton.mezger@psi.ch
  */
+
 #ifndef CALLBACKTHREAD_H
 #define CALLBACKTHREAD_H
 
 
-#include <queue>
+#include <vector>
 #include <epicsThread.h>
+#include <epicsAtomic.h>
 #include <pv/event.h>
 
 
@@ -47,49 +49,54 @@ public:
     virtual void callback() = 0;
 };
 
-class CallbackThread;
-typedef std::tr1::shared_ptr<CallbackThread> CallbackThreadPtr;
+// requests are pushed by any thread onto the lock-free stack of a consumer thread; the consumer
+// takes the whole stack with one atomic swap and runs the batch in arrival order. with more than
+// one consumer the requesters are spread by their address, the requests of one requester always
+// go to the same consumer, so that its callbacks stay serialized
 
-class epicsShareClass  CallbackThread :
-    public epicsThreadRunable
+class epicsShareClass  CallbackThread
 {
-    std::queue<CallbackRequesterPtr> monitorQueue;
-    std::tr1::shared_ptr<epicsThread> thread;
-    epics::pvData::Mutex mutex;
-    epics::pvData::Event runStop;
-    epics::pvData::Event runReturn;
+    struct Node {
+        CallbackRequesterPtr callbackRequester;
+        Node *next;
+    };
+
+    class Consumer : public epicsThreadRunable
+    {
+    public:
+        Consumer() : head(0), idle(0), stopped(0) {}
+        virtual void run();
+        void push(Node *node);
+        Node *takeAll();
+        void stop()
+        {
+            epicsAtomicSetIntT(&stopped, 1);
+            wakeup.signal();
+        }
+        std::tr1::shared_ptr<epicsThread> thread;
+    private:
+        void *head;     // top node of the stack, only accessed atomically
+        int idle;       // set while the consumer waits for requests
+        int stopped;
+        epics::pvData::Event wakeup;
+    };
+
+    std::vector<Consumer *> consumers;
 public:
     POINTER_DEFINITIONS(CallbackThread);
     ~CallbackThread();
-    virtual void run();
-    void startThread()
-    {
-         thread =  std::tr1::shared_ptr<epicsThread>(new epicsThread(
-            *this,
-            "callbackThread",
-            epicsThreadGetStackSize(epicsThreadStackSmall),
-            epicsThreadPriorityLow));
-         thread->start();
-    }
-    void queueRequest(CallbackRequesterPtr const & callbackRequester)
-    {
-        epics::pvData::Lock xx(mutex);
-        monitorQueue.push(callbackRequester);
-    }
-    static CallbackThreadPtr create()
+    void queueRequest(CallbackRequesterPtr const & callbackRequester);
+    static CallbackThreadPtr create(int threads = 1)
     {
          CallbackThreadPtr t(new CallbackThread());
-         t->startThread();
+         t->startThreads(threads);
          return t;
     } 
-    void stop()
-    {
-        runStop.signal();
-        runReturn.wait();
-    }
+    // returns at once, a callback still running finishes in its thread
+    void stop();
 private:
-    CallbackThread()
-    {}
+    CallbackThread() {}
+    void startThreads(int threads);
 };
 
 
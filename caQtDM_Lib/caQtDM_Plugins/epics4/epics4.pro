@@ -21,8 +21,22 @@ HEADERS         = epics4_plugin.h ../controlsinterface.h
 SOURCES         = epics4_plugin.cpp
 TARGET          = epics4_plugin
 
-SOURCES += callbackThread.cpp epics4Requester.cpp
-HEADERS += callbackThread.h epics4Requester.h
+SOURCES += callbackThread.cpp ndarrayDecoder.cpp epics4Requester.cpp
+HEADERS += callbackThread.h ndarrayDecoder.h epics4Requester.h
+
+# lz4 and blosc compressed ndarrays are decompressed when the libraries are given
+LZ4LIB = $$(LZ4LIB)
+!isEmpty(LZ4LIB) {
+    DEFINES += EPICS4_LZ4
+    INCLUDEPATH += $(LZ4INCLUDE)
+    LIBS += -L$(LZ4LIB) -llz4
+}
+BLOSCLIB = $$(BLOSCLIB)
+!isEmpty(BLOSCLIB) {
+    DEFINES += EPICS4_BLOSC
+    INCLUDEPATH += $(BLOSCINCLUDE)
+    LIBS += -L$(BLOSCLIB) -lblosc
+}
 
 warning("epics4 was specified in qtdefs.pri, so build plugin with epics4 which will support all normative data types")
 
@@ -44,10 +44,6 @@ using namespace epics::nt;
 
 namespace epics { namespace caqtdm { namespace epics4 {
 
-class PVAInterface;
-typedef std::tr1::shared_ptr<PVAInterface> PVAInterfacePtr;
-typedef std::tr1::weak_ptr<PVAInterface> PVAInterfaceWPtr;
-
 class PVAChannelRequester;
 typedef std::tr1::shared_ptr<PVAChannelRequester> PVAChannelRequesterPtr;
 typedef std::tr1::weak_ptr<PVAChannelRequester> PVAChannelRequesterWPtr;
@@ -150,16 +146,49 @@ typedef std::tr1::weak_ptr<PVAMonitorRequester> PVAMonitorRequesterWPtr;
 
 class epicsShareClass PVAInterface :
     public CallbackRequester,
+    public NDArrayDecodeRequester,
     public std::tr1::enable_shared_from_this<PVAInterface>
 {
 private:
-   template <typename pureData> void fillData(pureData const &array, size_t size, knobData* kPtr);
+    void holdData(shared_vector<const void> const & data, size_t length);
+    void resolveFields(StructureConstPtr const & monitorStructure);
+    void publish(bool initialize, bool update);
+    void publishTo(int index, bool initialize, bool update);
+
+    // a knob receiving the data of this interface; the monitor runs as long as one
+    // subscriber is neither cleared nor stopped (hidden widget)
+    struct Subscriber {
+        Subscriber(int index) : index(index), cleared(false), stopped(false) {}
+        int index;
+        bool cleared;
+        bool stopped;
+    };
+
+    // offsets of the monitored fields in the monitor elements, resolved once when the monitor
+    // connects, so that no field is looked up by name on every event; 0 when not monitored
+    struct FieldOffsets {
+        FieldOffsets()
+        : value(0), severity(0), seconds(0), nanoseconds(0), userTag(0),
+          dimension(0), attribute(0), codecName(0), codecParameters(0), uncompressedSize(0)
+        {}
+        size_t value;
+        size_t severity;
+        size_t seconds;
+        size_t nanoseconds;
+        size_t userTag;
+        size_t dimension;
+        size_t attribute;
+        size_t codecName;
+        size_t codecParameters;
+        size_t uncompressedSize;
+    };
 
     enum NormativeType {
         ntunknown_t,
         ntscalar_t,
         ntscalararray_t,
-        ntenum_t
+        ntenum_t,
+        ntndarray_t
     };
 
     enum CallbackType {
@@ -176,10 +205,20 @@ private:
     bool monitorStarted;
     CreateRequest::shared_pointer createRequest;
     MutexKnobData *mutexKnobData;
-    int index;
+    std::vector<Subscriber> subscribers;
+    string key;
     Epics4RequesterPtr requester;
     CallbackThreadPtr callbackThread;
+    NDArrayDecoderPtr ndarrayDecoder;
+    string monitorFields;
+    string monitorOptions;
+    FieldOffsets offsets;
     bool gotFirstConnect;
+    bool setupRunning;  // interface, display and monitor are being requested, guarded by dataMutex
+    bool retrySetup;    // connected again while the setup was running
+    bool connected;
+    bool initialized;
+    bool monitorCleared;
     NormativeType normativeType;
     CallbackType callbackType;
     StructureConstPtr structure;
@@ -189,10 +228,15 @@ private:
     Event waitForPutConnect;
     Monitor::shared_pointer monitor;
     ConvertPtr convert;
-    knobData kData;
+    // the decoded data shared by all subscribers, guarded by dataMutex
+    epicsData current;
     shared_vector<const string> choices;
+    shared_vector<const void> heldData;
+    shared_vector<const void> heldPrevious;
+    bool codecReported;
     TimeStamp timeStamp;
     Mutex mutex;
+    Mutex dataMutex;
     PVAGetFieldRequesterPtr pvaGetFieldRequester;
     PVAChannelGetRequesterPtr pvaChannelGetRequester;
     PVAChannelPutRequesterPtr pvaChannelPutRequester;
@@ -203,15 +247,25 @@ public:
     PVAInterface(
         PVAChannelPtr const & pvaChannel,
         MutexKnobData *mutexKnobData,
-        int index,
         Epics4RequesterPtr const & requester,
-        CallbackThreadPtr const & callbackThread);
+        CallbackThreadPtr const & callbackThread,
+        NDArrayDecoderPtr const & ndarrayDecoder,
+        string const & monitorFields,
+        string const & monitorOptions);
     virtual ~PVAInterface();
     void destroy();
     void clearMonitor();
     void stopMonitor();
     void startMonitor();
 
+    void addSubscriber(int index);
+    // following returns (true,false) if no more subscribers
+    bool removeSubscriber(int index);
+    void clearSubscriber(int index);
+    void setSubscriberStopped(int index, bool stopped);
+    bool isShareable();
+    string getKey() { return key; }
+
     std::string getRequesterName();
     void message(std::string const & message,MessageType messageType);
     // for getField
@@ -252,8 +306,12 @@ public:
     
    
     virtual void callback();
+    // for ndarrayDecoder
+    virtual void decodeDone(NDArrayFrame const & frame);
+    virtual void decodeFailed(std::string const & message);
 
     void channelStateChange(bool isConnected);
+    void setupFailed();
 
     PVAChannelPtr getPVAChannel();
     int reconnect();
@@ -271,6 +329,8 @@ public:
     void getScalarData(PVStructurePtr const & pvStructure);
     void getEnumData(PVStructurePtr const & pvStructure);
     void getScalarArrayData(PVStructurePtr const & pvStructure);
+    void getNDArrayData(PVStructurePtr const & pvStructure);
+    void setImage(NDArrayFrame const & frame);
     bool setValue(double rdata, int32_t idata, char *sdata, int forceType);
     bool setArrayValue(
         float *fdata, double *ddata,
@@ -602,13 +662,21 @@ bool PVAChannel::removeInterface(const PVAInterfacePtr & pvaInterface)
 }
 
 
+// widgets asking for the same fields of a channel with the same options share one interface
+static string interfaceKey(string const & fullName, string const & fields, string const & options)
+{
+    return fullName + " " + fields + " " + options;
+}
+
 class epicsShareClass PVAInterfaceGlue
 {
 private:
      PVAInterfacePtr pvaInterface;
+     int index;
 public:
-    PVAInterfaceGlue(const PVAInterfacePtr & pvaInterface)
-    :pvaInterface(pvaInterface)
+    PVAInterfaceGlue(const PVAInterfacePtr & pvaInterface, int index)
+    :pvaInterface(pvaInterface),
+     index(index)
     {}
     ~PVAInterfaceGlue()
     {
@@ -622,15 +690,21 @@ public:
     {
          return pvaInterface;
     }
+    int getIndex()
+    {
+         return index;
+    }
 };
 
 
 PVAInterface::PVAInterface(
         PVAChannelPtr const & pvaChannel,
         MutexKnobData *mutexKnobData,
-        int index,
         Epics4RequesterPtr const & requester,
-        CallbackThreadPtr const & callbackThread)
+        CallbackThreadPtr const & callbackThread,
+        NDArrayDecoderPtr const & ndarrayDecoder,
+        string const & monitorFields,
+        string const & monitorOptions)
 : pvaChannel(pvaChannel),
   gotFirstConnection(false),
   putFinished(true),
@@ -638,15 +712,25 @@ PVAInterface::PVAInterface(
   monitorStarted(false),
   createRequest(CreateRequest::create()),
   mutexKnobData(mutexKnobData),
-  index(index),
+  key(interfaceKey(pvaChannel->getFullName(), monitorFields, monitorOptions)),
   requester(requester),
   callbackThread(callbackThread),
+  ndarrayDecoder(ndarrayDecoder),
+  monitorFields(monitorFields),
+  monitorOptions(monitorOptions),
   gotFirstConnect(false),
+  setupRunning(false),
+  retrySetup(false),
+  connected(false),
+  initialized(false),
+  monitorCleared(false),
   normativeType(ntunknown_t),
   callbackType(unknown_t),
-  convert(getConvert())
+  convert(getConvert()),
+  codecReported(false)
 {
      if(Epics4Plugin::getDebug()) cout << "PVAInterface::PVAInterface()\n";
+     memset(&current, 0, sizeof(epicsData));
 }
 
 PVAInterface::~PVAInterface()
@@ -663,6 +747,7 @@ void PVAInterface::clearMonitor()
            monitorStarted = false;
        }
        monitor->destroy();
+       monitor.reset();
     }
 }
 
@@ -688,6 +773,102 @@ void PVAInterface::startMonitor()
     }
 }
 
+void PVAInterface::addSubscriber(int index)
+{
+    Lock lock(dataMutex);
+    subscribers.push_back(Subscriber(index));
+    // a late subscriber gets at once what the others already have
+    if(initialized) publishTo(index, true, current.monitorCount > 0);
+    if(gotFirstConnect && connected) mutexKnobData->SetMutexKnobDataConnected(index, true);
+}
+
+bool PVAInterface::removeSubscriber(int index)
+{
+    Lock lock(dataMutex);
+    for(size_t ind = 0; ind < subscribers.size(); ++ind) {
+        if(subscribers[ind].index == index) {
+            subscribers.erase(subscribers.begin() + ind);
+            break;
+        }
+    }
+    return subscribers.empty();
+}
+
+// the monitor is destroyed with its last subscriber, an interface without monitor is not shared anymore
+void PVAInterface::clearSubscriber(int index)
+{
+    bool isLast = true;
+    {
+        Lock lock(dataMutex);
+        for(size_t ind = 0; ind < subscribers.size(); ++ind) {
+            if(subscribers[ind].index == index) subscribers[ind].cleared = true;
+            if(!subscribers[ind].cleared) isLast = false;
+        }
+        if(isLast) monitorCleared = true;
+    }
+    if(isLast) clearMonitor();
+}
+
+void PVAInterface::setSubscriberStopped(int index, bool stopped)
+{
+    bool running = false;
+    {
+        Lock lock(dataMutex);
+        for(size_t ind = 0; ind < subscribers.size(); ++ind) {
+            if(subscribers[ind].index == index) subscribers[ind].stopped = stopped;
+            if(!subscribers[ind].stopped && !subscribers[ind].cleared) running = true;
+        }
+    }
+    if(running) startMonitor(); else stopMonitor();
+}
+
+bool PVAInterface::isShareable()
+{
+    Lock lock(dataMutex);
+    return !monitorCleared;
+}
+
+// dataMutex has to be held
+void PVAInterface::publish(bool initialize, bool update)
+{
+    for(size_t ind = 0; ind < subscribers.size(); ++ind) {
+        if(!subscribers[ind].cleared) publishTo(subscribers[ind].index, initialize, update);
+    }
+}
+
+void PVAInterface::publishTo(int index, bool initialize, bool update)
+{
+    knobData kData = mutexKnobData->GetMutexKnobData(index);
+    if(kData.index == -1) return;
+    mutexKnobData->DataLock(&kData);
+    kData = mutexKnobData->GetMutexKnobData(index);
+    kData.edata.fieldtype = current.fieldtype;
+    kData.edata.status = current.status;
+    kData.edata.severity = current.severity;
+    kData.edata.precision = current.precision;
+    memcpy(kData.edata.units, current.units, sizeof(kData.edata.units));
+    kData.edata.upper_disp_limit = current.upper_disp_limit;
+    kData.edata.lower_disp_limit = current.lower_disp_limit;
+    kData.edata.upper_ctrl_limit = current.upper_ctrl_limit;
+    kData.edata.lower_ctrl_limit = current.lower_ctrl_limit;
+    kData.edata.rvalue = current.rvalue;
+    kData.edata.ivalue = current.ivalue;
+    kData.edata.valueCount = current.valueCount;
+    kData.edata.enumCount = current.enumCount;
+    kData.edata.accessR = current.accessR;
+    kData.edata.accessW = current.accessW;
+    kData.edata.dataB = current.dataB;
+    kData.edata.dataSize = current.dataSize;
+    kData.edata.imageWidth = current.imageWidth;
+    kData.edata.imageHeight = current.imageHeight;
+    kData.edata.imageColorMode = current.imageColorMode;
+    kData.edata.imageBayerPattern = current.imageBayerPattern;
+    if(initialize) kData.edata.initialize = true;
+    if(update) kData.edata.monitorCount++;
+    mutexKnobData->SetMutexKnobDataReceived(&kData);
+    mutexKnobData->DataUnlock(&kData);
+}
+
 void PVAInterface::destroy()
 {
     if(Epics4Plugin::getDebug()) cout << "PVAInterface::destroy calling pvaChannelGet->destroy\n";
@@ -707,8 +888,32 @@ void PVAInterface::channelStateChange(bool isConnected)
         << " isConnected " << (isConnected ? "true" : "false")
         << endl; 
     }
-    if(gotFirstConnect) mutexKnobData->SetMutexKnobDataConnected(index,isConnected);
+    Lock lock(dataMutex);
+    connected = isConnected;
+    if(gotFirstConnect) {
+        for(size_t ind = 0; ind < subscribers.size(); ++ind) {
+            if(!subscribers[ind].cleared) mutexKnobData->SetMutexKnobDataConnected(subscribers[ind].index,isConnected);
+        }
+    }
     if(!isConnected || gotFirstConnect) return;
+    // one setup at a time, a second one would overwrite the callbackType of the first
+    if(setupRunning) {
+        retrySetup = true;
+        return;
+    }
+    setupRunning = true;
+    callbackType = interface_t;
+    callbackThread->queueRequest(shared_from_this());
+}
+
+// the setup ended without a monitor, it is started again when the channel reconnected meanwhile
+void PVAInterface::setupFailed()
+{
+    Lock lock(dataMutex);
+    setupRunning = false;
+    if(!retrySetup || !connected || gotFirstConnect) return;
+    retrySetup = false;
+    setupRunning = true;
     callbackType = interface_t;
     callbackThread->queueRequest(shared_from_this());
 }
@@ -733,15 +938,19 @@ void PVAInterface::getDone(
           string mess(status.getMessage());
           mess += " getField failed";
           message(mess,errorMessage);
+          setupFailed();
           return;
      }
      FieldConstPtr field = structure->getField<Field>(string("value"));
      if(!field) {
           message(" no value field",errorMessage);
+          setupFailed();
           return;
      }
      Type type = field->getType();
-     if(type==scalar) {
+     if(NTNDArray::is_a(structure)) {
+        normativeType = ntndarray_t;
+     } else if(type==scalar) {
         normativeType = ntscalar_t;
      } else if(type==scalarArray) {
         normativeType = ntscalararray_t;
@@ -749,6 +958,7 @@ void PVAInterface::getDone(
         normativeType = ntenum_t;
      } else {
          message(" value is not a valid nttype",errorMessage);
+         setupFailed();
          return;
      }
      gotInterface();
@@ -767,6 +977,7 @@ void PVAInterface::channelGetConnect(
           string mess(status.getMessage());
           mess += " channelGetConnect failed";
           message(mess,errorMessage);
+          setupFailed();
           return;
      }
      channelGet->get();
@@ -784,11 +995,13 @@ void PVAInterface::getDone(
           string mess(status.getMessage());
           mess += " channelGetDone failed";
           message(mess,errorMessage);
+          setupFailed();
           return;
      }
      switch(normativeType) {
        case ntscalar_t : gotDisplayControl(pvStructure); break;
        case ntscalararray_t : gotDisplayControl(pvStructure); break;
+       case ntndarray_t : gotDisplayControl(pvStructure); break;
        case ntenum_t : gotEnum(pvStructure); break;
        default: throw std::runtime_error("PVAInterface::getDone logic error");
      }
@@ -799,9 +1012,9 @@ void PVAInterface::monitorConnect(
         Monitor::shared_pointer const & monitor,
         Structure::const_shared_pointer const & structure)
 {
-    Q_UNUSED(structure);
     if(Epics4Plugin::getDebug()) cout << " PVAInterface::monitorConnect\n";
     if(status.isOK()) {
+       resolveFields(structure);
        Lock lock(mutex);
        if(!monitorStarted) {
            monitor->start();
@@ -828,37 +1041,28 @@ void PVAInterface::monitorEvent(MonitorPtr const & monitor)
         MonitorElementPtr monitorElement(monitor->poll());
         if(!monitorElement) break;
         PVStructurePtr pvStructure = monitorElement->pvStructurePtr;
-        kData = mutexKnobData->GetMutexKnobData(index);
-        if(kData.index == -1) return;
-        mutexKnobData->DataLock(&kData);
-        bool gotAlarm = false;
-        if(structure->getField("alarm")) gotAlarm = true;
-        if(gotAlarm) {
-            PVFieldPtr pvField = pvStructure->getSubField<PVStructure>("alarm");
-            Alarm alarm;
-            PVAlarm pvAlarm;
-            pvAlarm.attach(pvField);
-            pvAlarm.get(alarm);
-            kData.edata.severity = alarm.getSeverity();
+        Lock lock(dataMutex);
+        int monitorCount = current.monitorCount;
+        if(offsets.severity) {
+            int sev = pvStructure->getSubField<PVInt>(offsets.severity)->get();
+            current.severity = sev;
+            current.status = (sev==0 ? 0 : 17);
         }
-        bool gotTimeStamp = false;
-        if(structure->getField("alarm")) gotTimeStamp = true;
-        if(gotTimeStamp) {
-            PVFieldPtr pvField = pvStructure->getSubField<PVStructure>("timeStamp");
-            PVTimeStamp pvTimeStamp;
-            pvTimeStamp.attach(pvField);
-            pvTimeStamp.get(timeStamp);
+        if(offsets.seconds) {
+            timeStamp.put(pvStructure->getSubField<PVLong>(offsets.seconds)->get(),
+                          pvStructure->getSubField<PVInt>(offsets.nanoseconds)->get());
+            timeStamp.setUserTag(pvStructure->getSubField<PVInt>(offsets.userTag)->get());
         }
         switch (normativeType) {
             case ntscalar_t : getScalarData(pvStructure); break;
             case ntenum_t : getEnumData(pvStructure); break;
             case ntscalararray_t : getScalarArrayData(pvStructure); break;
+            case ntndarray_t : getNDArrayData(pvStructure); break;
             default: throw std::runtime_error("PVAInterface::event logic error");
         }
-        //qDebug() << "update" << kData.pv << kData.index << kData.pluginFlavor << kData.dispName <<kData.edata.rvalue << kData.edata.ivalue;
-        mutexKnobData->SetMutexKnobDataReceived(&kData);
-
-        mutexKnobData->DataUnlock(&kData);
+        // decoded once for all widgets of this channel request
+        publish(false, current.monitorCount != monitorCount);
+        lock.unlock();
         monitor->release(monitorElement);
     }
 }
@@ -921,6 +1125,7 @@ void PVAInterface::callback()
        }
     } catch (std::runtime_error e) {
         cerr << "exception " << e.what() << endl;
+        setupFailed();
         return;
     }
 }
@@ -972,18 +1177,16 @@ void PVAInterface::gotInterface()
            FieldConstPtr valueField = structure->getField("value");
            if(!valueField) {
                 message("no support",errorMessage);
+                setupFailed();
                 return;
            }
-           kData = mutexKnobData->GetMutexKnobData(index);
-           if(kData.index == -1) return;
-           mutexKnobData->DataLock(&kData);
-           kData.edata.initialize = true;
-           kData.edata.accessR = 1;
-           kData.edata.accessW = 1;
-
-           mutexKnobData->SetMutexKnobDataReceived(&kData);
-
-           mutexKnobData->DataUnlock(&kData);
+           {
+               Lock lock(dataMutex);
+               current.accessR = 1;
+               current.accessW = 1;
+               initialized = true;
+               publish(true, false);
+           }
            callbackType = createMonitor_t;
            callbackThread->queueRequest(shared_from_this());
            return;
@@ -1043,34 +1246,48 @@ void PVAInterface::gotDisplayControl(PVStructurePtr const & pvStructure)
             }
         }
     }
-    kData = mutexKnobData->GetMutexKnobData(index);
-    if(kData.index == -1) return;
-    mutexKnobData->DataLock(&kData);
-    kData.edata.initialize = true;
-    kData.edata.upper_disp_limit = displayHigh;
-    kData.edata.lower_disp_limit = displayLow;
-    kData.edata.upper_ctrl_limit = controlHigh;
-    kData.edata.lower_ctrl_limit = controlLow;
-    kData.edata.precision = precision;
-    kData.edata.accessR = 1;
-    kData.edata.accessW = 1;
-    int len = units.length();
-    if(len>39) len = 39;    // kData.edata.units is 40 bytes
-    if(len<1) {
-         kData.edata.units[0] = '\0';
-    } else {
-         const char * from = units.c_str();
-         for(int i=0; i< len; ++i) kData.edata.units[i] = from[i];
-         kData.edata.units[len] = '\0';
+    {
+        Lock lock(dataMutex);
+        current.upper_disp_limit = displayHigh;
+        current.lower_disp_limit = displayLow;
+        current.upper_ctrl_limit = controlHigh;
+        current.lower_ctrl_limit = controlLow;
+        current.precision = precision;
+        current.accessR = 1;
+        current.accessW = 1;
+        int len = units.length();
+        if(len>39) len = 39;    // current.units is 40 bytes
+        if(len<1) {
+             current.units[0] = '\0';
+        } else {
+             const char * from = units.c_str();
+             for(int i=0; i< len; ++i) current.units[i] = from[i];
+             current.units[len] = '\0';
+        }
+        initialized = true;
+        publish(true, false);
     }
-    mutexKnobData->SetMutexKnobDataReceived(&kData);
-
-    mutexKnobData->DataUnlock(&kData);
     callbackType = createMonitor_t;
     callbackThread->queueRequest(shared_from_this());
     pvaChannelGet.reset();
 }
 
+// strings of an array or choices of an enum, separated by escape as the widgets expect them
+static shared_vector<const void> joinStrings(shared_vector<const string> const & strings)
+{
+    size_t size = 0;
+    for(size_t i = 0; i < strings.size(); ++i) size += strings[i].length() + 1;
+    shared_vector<char> joined(size > 0 ? size : 1);
+    char * ptr = joined.data();
+    for(size_t i = 0; i < strings.size(); ++i) {
+        memcpy(ptr, strings[i].data(), strings[i].length());
+        ptr += strings[i].length();
+        ptr[0] = '\033'; ++ptr;
+    }
+    joined[joined.size() - 1] = '\0';
+    return static_shared_vector_cast<const void>(freeze(joined));
+}
+
 void PVAInterface::getEnum()
 {
     PVStructurePtr pvRequest = createRequest->createRequest("value.choices");
@@ -1085,48 +1302,21 @@ void PVAInterface::gotEnum(PVStructurePtr const & pvStructure)
     int enumCount = choices.size();
     if(enumCount<=0) {
         message("gotEnum no choices",errorMessage);
+        setupFailed();
         return;
     }
-    kData = mutexKnobData->GetMutexKnobData(index);
-    if(kData.index == -1) return;
-    mutexKnobData->DataLock(&kData);
-    kData.edata.precision = 0;
-    kData.edata.units[0] = '\0';
-    int dataSize = 0;
-    for(int ind = 0; ind < enumCount; ++ind) {
-       const string val = choices[ind];
-       dataSize += val.length() + 1;
-    }
-    if(dataSize==0) {
-        message("gotEnum no choices",errorMessage);
-        mutexKnobData->DataUnlock(&kData);
-        return;
+    {
+        Lock lock(dataMutex);
+        current.precision = 0;
+        current.units[0] = '\0';
+        holdData(joinStrings(choices), 1);
+        current.enumCount = enumCount;
+        current.fieldtype  = DBF_ENUM;
+        current.accessR = 1;
+        current.accessW = 1;
+        initialized = true;
+        publish(true, false);
     }
-    if(dataSize > kData.edata.dataSize) {
-        if(kData.edata.dataSize>0 && (kData.edata.dataB != (void*) 0)) free(kData.edata.dataB);
-        kData.edata.dataB = (void*) malloc((size_t) dataSize);
-        kData.edata.dataSize = dataSize;
-    }
-    char * ptr = static_cast<char*>(kData.edata.dataB);
-    for(int ind = 0; ind < enumCount; ++ind) {
-       const string val = choices[ind];
-       int len = val.length();
-       memcpy(ptr, val.data(),len);
-       ptr += len;
-       ptr[0] = '\033';
-       ptr++;
-    }
-    ptr--;
-    ptr[0] = '\0';
-    kData.edata.initialize = true;
-    kData.edata.enumCount = enumCount;
-    kData.edata.fieldtype  = DBF_ENUM;
-    kData.edata.accessR = 1;
-    kData.edata.accessW = 1;
-
-    mutexKnobData->SetMutexKnobDataReceived(&kData);
-
-    mutexKnobData->DataUnlock(&kData);
     callbackType = createMonitor_t;
     callbackThread->queueRequest(shared_from_this());
     pvaChannelGet.reset();
@@ -1136,16 +1326,32 @@ void PVAInterface::createMonitor()
 {
     if(Epics4Plugin::getDebug()) cout << "PVAInterface::createMonitor()\n";
     try {
-       if(normativeType==ntunknown_t) return;
-       string request("value,alarm,timeStamp");
-       if(normativeType==ntenum_t) request = "alarm,timeStamp,value.index";
+       if(normativeType==ntunknown_t) {
+           setupFailed();
+           return;
+       }
+       // only the fields the widget needs, the value of an enum is its index
+       string request(monitorFields);
+       if(normativeType==ntenum_t) request.replace(0, 5, "value.index");
+       if(normativeType==ntndarray_t) request += ",dimension,attribute,codec,uncompressedSize";
+       if(!monitorOptions.empty()) request = "record[" + monitorOptions + "]field(" + request + ")";
        PVStructurePtr pvRequest = createRequest->createRequest(request);
+       if(!pvRequest) {
+           message("invalid pvRequest " + request + " " + createRequest->getMessage(), errorMessage);
+           setupFailed();
+           return;
+       }
        pvaMonitorRequester = PVAMonitorRequesterPtr(new PVAMonitorRequester(shared_from_this()));
        monitor = pvaChannel->getChannel()->createMonitor(pvaMonitorRequester,pvRequest);
+       Lock lock(dataMutex);
        gotFirstConnect = true;
-       mutexKnobData->SetMutexKnobDataConnected(index,true);
+       setupRunning = false;
+       for(size_t ind = 0; ind < subscribers.size(); ++ind) {
+           if(!subscribers[ind].cleared) mutexKnobData->SetMutexKnobDataConnected(subscribers[ind].index,true);
+       }
     } catch (std::runtime_error e) {
          cerr << "exception " << e.what() << endl;
+         setupFailed();
          return;
     }
 }
@@ -1154,29 +1360,41 @@ void PVAInterface::gotMonitor()
 {
     if(Epics4Plugin::getDebug()) cout << "PVAInterface::gotMonitor()\n";
 }
+
+static size_t offsetOf(PVStructurePtr const & pvStructure, const char *name)
+{
+    PVFieldPtr pvField = pvStructure->getSubField(name);
+    return (pvField ? pvField->getFieldOffset() : 0);
+}
+
+void PVAInterface::resolveFields(StructureConstPtr const & monitorStructure)
+{
+    // all monitor elements have this structure, an empty instance gives the offsets
+    PVStructurePtr pvStructure = getPVDataCreate()->createPVStructure(monitorStructure);
+    FieldOffsets resolved;
+    resolved.value = offsetOf(pvStructure, (normativeType==ntenum_t ? "value.index" : "value"));
+    resolved.severity = offsetOf(pvStructure, "alarm.severity");
+    resolved.seconds = offsetOf(pvStructure, "timeStamp.secondsPastEpoch");
+    resolved.nanoseconds = offsetOf(pvStructure, "timeStamp.nanoseconds");
+    resolved.userTag = offsetOf(pvStructure, "timeStamp.userTag");
+    if(!resolved.nanoseconds || !resolved.userTag) resolved.seconds = 0;
+    resolved.dimension = offsetOf(pvStructure, "dimension");
+    resolved.attribute = offsetOf(pvStructure, "attribute");
+    resolved.codecName = offsetOf(pvStructure, "codec.name");
+    resolved.codecParameters = offsetOf(pvStructure, "codec.parameters");
+    resolved.uncompressedSize = offsetOf(pvStructure, "uncompressedSize");
+    offsets = resolved;
+}
  
 
 void PVAInterface::getScalarData(PVStructurePtr const & pvStructure)
 {
-    if(Epics4Plugin::getDebug()) cout << "getScalarData " << kData.pv << endl;
-    PVScalarPtr pvScalar = pvStructure->getSubField<PVScalar>("value");
+    if(Epics4Plugin::getDebug()) cout << "getScalarData " << pvaChannel->getFullName() << endl;
+    PVScalarPtr pvScalar = pvStructure->getSubField<PVScalar>(offsets.value);
     if(!pvScalar) {
         cout << "PVAInterface::getScalarData pvStructure \n" << pvStructure << endl; return;
     }
-    
-    PVFieldPtr pvAlarmField = pvStructure->getSubField<PVStructure>("alarm");
-    if(pvAlarmField) {
-       Alarm alarm;
-       PVAlarm pvAlarm; 
-       bool result;
-       result = pvAlarm.attach(pvAlarmField);
-       if(result) {
-            pvAlarm.get(alarm);
-            int sev = alarm.getSeverity();
-            kData.edata.severity = sev;
-            kData.edata.status = (sev==0 ? 0 : 17);
-       }
-    }
+
     ScalarType scalarType = pvScalar->getScalar()->getScalarType();
 
     switch (scalarType) {
@@ -1185,22 +1403,22 @@ void PVAInterface::getScalarData(PVStructurePtr const & pvStructure)
         //qDebug() << "boolean";
          PVBooleanPtr pvBoolean = std::tr1::dynamic_pointer_cast<PVBoolean>(pvScalar);
          bool value  = pvBoolean->get();
-         kData.edata.ivalue = (value ? 1 : 0);
-         kData.edata.rvalue = (float) kData.edata.ivalue;
-         kData.edata.fieldtype  = DBF_LONG;
-         kData.edata.valueCount = 1;
-         kData.edata.monitorCount++;
+         current.ivalue = (value ? 1 : 0);
+         current.rvalue = (float) current.ivalue;
+         current.fieldtype  = DBF_LONG;
+         current.valueCount = 1;
+         current.monitorCount++;
     }
          break;
     case pvByte:
     {
         //qDebug() << "byte";
          char value = convert->toByte(pvScalar);
-         kData.edata.ivalue = value;
-         kData.edata.rvalue = value;
-         kData.edata.fieldtype  = DBF_CHAR;
-         kData.edata.valueCount = 1;
-         kData.edata.monitorCount++;
+         current.ivalue = value;
+         current.rvalue = value;
+         current.fieldtype  = DBF_CHAR;
+         current.valueCount = 1;
+         current.monitorCount++;
     }
         break;
     case pvShort:
@@ -1213,11 +1431,11 @@ void PVAInterface::getScalarData(PVStructurePtr const & pvStructure)
     {
         //qDebug() << "all others";
          int32 value = convert->toInt(pvScalar);
-         kData.edata.ivalue = value;
-         kData.edata.rvalue = value;
-         kData.edata.fieldtype  = DBF_LONG;
-         kData.edata.valueCount = 1;
-         kData.edata.monitorCount++;
+         current.ivalue = value;
+         current.rvalue = value;
+         current.fieldtype  = DBF_LONG;
+         current.valueCount = 1;
+         current.monitorCount++;
     }
         break;
     case pvFloat:
@@ -1225,11 +1443,11 @@ void PVAInterface::getScalarData(PVStructurePtr const & pvStructure)
     {
         //qDebug() << "float & double";
          double value = convert->toDouble(pvScalar);
-         kData.edata.rvalue = value;
-         kData.edata.ivalue = value;
-         kData.edata.fieldtype  = DBF_DOUBLE;
-         kData.edata.valueCount = 1;
-         kData.edata.monitorCount++;
+         current.rvalue = value;
+         current.ivalue = value;
+         current.fieldtype  = DBF_DOUBLE;
+         current.valueCount = 1;
+         current.monitorCount++;
     }
          break;
     case pvString:
@@ -1238,20 +1456,12 @@ void PVAInterface::getScalarData(PVStructurePtr const & pvStructure)
          PVStringPtr pvString = std::tr1::dynamic_pointer_cast<PVString>(pvScalar);
          string value = pvString->get();
          int len = value.length();
-         const char * data = value.data();
-         int length = len + 1;
-         if(length>kData.edata.dataSize)
-         {
-               if(kData.edata.dataSize!=0 && (kData.edata.dataB != (void*) 0)) free(kData.edata.dataB);
-               kData.edata.dataB = (void*) malloc((size_t) length);
-         }
-         memcpy(kData.edata.dataB,data,len);
-         char *yyy = (char *)(kData.edata.dataB);
-         yyy[len] = '\0';
-         kData.edata.dataSize = length;
-         kData.edata.fieldtype  = DBF_STRING;
-         kData.edata.valueCount = 1;
-         kData.edata.monitorCount++;
+         shared_vector<char> text(len + 1);
+         memcpy(text.data(), value.data(), len);
+         text[len] = '\0';
+         current.fieldtype  = DBF_STRING;
+         holdData(static_shared_vector_cast<const void>(freeze(text)), 1);
+         current.monitorCount++;
     }
          break;
     }
@@ -1260,46 +1470,48 @@ void PVAInterface::getScalarData(PVStructurePtr const & pvStructure)
 
 void PVAInterface::getEnumData(PVStructurePtr const & pvStructure)
 {
-    PVFieldPtr pvAlarmField = pvStructure->getSubField<PVStructure>("alarm");
-    if(pvAlarmField) {
-       Alarm alarm;
-       PVAlarm pvAlarm; 
-       bool result;
-       result = pvAlarm.attach(pvAlarmField);
-       if(result) {
-            pvAlarm.get(alarm);
-            int sev = alarm.getSeverity();
-            kData.edata.severity = sev;
-            kData.edata.status = (sev==0 ? 0 : 17);
-       }
-    }
-     int32 index = pvStructure->getSubField<PVInt>("value.index")->get();
-     kData.edata.ivalue = index;
-     kData.edata.rvalue = index;
-     kData.edata.valueCount = 1;
-     kData.edata.monitorCount++;
-}
-
-template <typename pureData>
-void PVAInterface::fillData(pureData const &array, size_t length, knobData* kPtr) {
-    if(length>0) {
-        int size = sizeof(array[0]);
-        if((length * size) > (size_t) kPtr->edata.dataSize) {
-            if(kPtr->edata.dataB != (void*) 0) free(kPtr->edata.dataB);
-            kPtr->edata.dataB = (void*) malloc(length * size);
-            kPtr->edata.dataSize = length * size;
-        }
-        memcpy(kPtr->edata.dataB, &array[0],  length * size);
-    }
-    kData.edata.valueCount = length;
-    kData.edata.monitorCount++;
+     PVIntPtr pvIndex = pvStructure->getSubField<PVInt>(offsets.value);
+     if(!pvIndex) return;
+     int32 index = pvIndex->get();
+     current.ivalue = index;
+     current.rvalue = index;
+     current.valueCount = 1;
+     current.monitorCount++;
+}
+
+// the frozen array of the monitor element is handed to all widgets instead of copying it into
+// malloc'd buffers; the previous one is kept until the knobs point to the new one, so the array
+// a knob points to is valid as long as its data lock is held. widgets keeping data beyond the
+// update copy it (caCamera)
+void PVAInterface::holdData(shared_vector<const void> const & data, size_t length)
+{
+    heldPrevious = heldData;
+    heldData = data;
+    current.dataB = (void*) heldData.data();
+    current.dataSize = heldData.size();
+    current.valueCount = length;
 }
 
+static short fieldTypeOf(ScalarType scalarType)
+{
+    switch(scalarType) {
+    case pvByte:
+    case pvUByte: return DBF_CHAR;
+    case pvShort:
+    case pvUShort: return DBF_INT;
+    case pvInt:
+    case pvUInt: return DBF_LONG;
+    case pvFloat: return DBF_FLOAT;
+    case pvDouble: return DBF_DOUBLE;
+    default: return -1;
+    }
+}
 
 void PVAInterface::getScalarArrayData(PVStructurePtr const & pvStructure)
 {
 
-    PVScalarArrayPtr pva = pvStructure->getSubField<PVScalarArray>("value");
+    PVScalarArrayPtr pva = pvStructure->getSubField<PVScalarArray>(offsets.value);
+    if(!pva) return;
     ScalarArrayConstPtr scalar = pva->getScalarArray();
     ScalarType scalarType = scalar->getElementType();
     int length = pva->getLength();
@@ -1311,148 +1523,160 @@ void PVAInterface::getScalarArrayData(PVStructurePtr const & pvStructure)
         break;
 
     case pvString: {
+        current.fieldtype = DBF_STRING;
         if(length<1) {
-            kData.edata.fieldtype = DBF_STRING;
-            kData.edata.valueCount = 0;
+            current.valueCount = 0;
             return;
         }
         PVStringArrayPtr ArrayData = std::tr1::static_pointer_cast<PVStringArray> (pva);
-        shared_vector<const string> array(ArrayData->view());
-        kData.edata.fieldtype = DBF_STRING;
-        int numBytes = 0;
-        for(int i=0; i<length; ++i)
-        {
-             numBytes += array[i].length();
-        }
-        numBytes += length + 1;
-        if(numBytes>kData.edata.dataSize) {
-             if(kData.edata.dataB != (void*) 0) free(kData.edata.dataB);
-             kData.edata.dataB = (void*) malloc(numBytes);
-             kData.edata.dataSize = numBytes;
-        }
-        char * ptr = static_cast<char*>(kData.edata.dataB);
-        for(int i=0; i<length; ++i)
-        {
-             const string value = array[i];
-             int len = value.length();
-             memcpy(ptr,value.data(),len);
-             ptr += len;
-             ptr[0] = '\033'; ++ptr;
-        }
-        ptr--;
-        ptr[0] = '\0';
-        kData.edata.valueCount = length;
-        kData.edata.monitorCount++;
-        return;
-    }    
-    case pvByte: {
-        if(length<1) {
-            kData.edata.fieldtype = DBF_CHAR;
-            kData.edata.valueCount = 0;
-            return;
-        }
-        PVByteArrayPtr ArrayData = std::tr1::static_pointer_cast<PVByteArray> (pva);
-        shared_vector<const int8> xxx(ArrayData->view());
-        kData.edata.fieldtype = DBF_CHAR;
-        fillData(xxx, length, &kData);
+        holdData(joinStrings(ArrayData->view()), length);
+        current.monitorCount++;
         return;
     }
 
-    case pvUByte: {
-        if(length<1) {
-            kData.edata.fieldtype = DBF_CHAR;
-            kData.edata.valueCount = 0;
-            return;
-        }
-        PVUByteArrayPtr ArrayData = std::tr1::static_pointer_cast<PVUByteArray> (pva);
-        shared_vector<const uint8> xxx(ArrayData->view());
-        kData.edata.fieldtype = DBF_CHAR;
-        fillData(xxx, length, &kData);
+    case pvLong:
+    case pvULong:
+        requester->message("array of pvLong not yet supported", errorMessage);
         return;
-    }
 
-    case pvShort: {
+    default: {
+        current.fieldtype = fieldTypeOf(scalarType);
         if(length<1) {
-            kData.edata.fieldtype = DBF_INT;
-            kData.edata.valueCount = 0;
+            current.valueCount = 0;
             return;
         }
-        PVShortArrayPtr ArrayData = std::tr1::static_pointer_cast<PVShortArray> (pva);
-        shared_vector<const int16> xxx(ArrayData->view());
-        kData.edata.fieldtype = DBF_INT;
-        fillData(xxx, length, &kData);
+        shared_vector<const void> data;
+        pva->getAs<void>(data);
+        holdData(data, length);
+        current.monitorCount++;
         return;
     }
+    }
+}
 
-    case pvUShort: {
-        if(length<1) {
-            kData.edata.fieldtype = DBF_INT;
-            kData.edata.valueCount = 0;
+void PVAInterface::getNDArrayData(PVStructurePtr const & pvStructure)
+{
+    PVUnionPtr pvValue = pvStructure->getSubField<PVUnion>(offsets.value);
+    PVScalarArrayPtr pva;
+    if(pvValue) pva = pvValue->get<PVScalarArray>();
+    if(!pva) return;
+
+    NDArrayFrame frame;
+    ScalarType scalarType = pva->getScalarArray()->getElementType();
+    pva->getAs<void>(frame.data);
+
+    // compressed arrays are bytes, the data type of the image is a codec parameter (NDDataType_t)
+    PVStringPtr pvCodec;
+    if(offsets.codecName) pvCodec = pvStructure->getSubField<PVString>(offsets.codecName);
+    if(pvCodec) frame.codec = pvCodec->get();
+    if(!frame.codec.empty()) {
+        if(!NDArrayDecoder::isSupported(frame.codec)) {
+            if(!codecReported) message("ndarray codec " + frame.codec + " not supported", errorMessage);
+            codecReported = true;
             return;
         }
-        PVUShortArrayPtr ArrayData = std::tr1::static_pointer_cast<PVUShortArray> (pva);
-        shared_vector<const uint16> xxx(ArrayData->view());
-        kData.edata.fieldtype = DBF_INT;
-        fillData(xxx, length, &kData);
+        static const ScalarType ndDataTypes[10] = {pvByte, pvUByte, pvShort, pvUShort, pvInt, pvUInt, pvLong, pvULong, pvFloat, pvDouble};
+        PVUnionPtr pvParameters;
+        if(offsets.codecParameters) pvParameters = pvStructure->getSubField<PVUnion>(offsets.codecParameters);
+        PVScalarPtr pvDataType;
+        if(pvParameters) pvDataType = pvParameters->get<PVScalar>();
+        int ndDataType = pvDataType ? convert->toInt(pvDataType) : -1;
+        if(ndDataType < 0 || ndDataType > 9) {
+            message("ndarray codec " + frame.codec + " without data type", errorMessage);
+            return;
+        }
+        scalarType = ndDataTypes[ndDataType];
+        PVLongPtr pvSize;
+        if(offsets.uncompressedSize) pvSize = pvStructure->getSubField<PVLong>(offsets.uncompressedSize);
+        if(pvSize) frame.uncompressedSize = pvSize->get();
+    }
+    frame.fieldtype = fieldTypeOf(scalarType);
+    if(frame.fieldtype < 0) {
+        if(!codecReported) message(string("ndarray of ") + ScalarTypeFunc::name(scalarType) + " not supported", errorMessage);
+        codecReported = true;
         return;
     }
-
-    case pvInt: {
-        if(length<1) {
-            kData.edata.fieldtype = DBF_LONG;
-            kData.edata.valueCount = 0;
-            return;
+    frame.elementSize = ScalarTypeFunc::elementSize(scalarType);
+
+    size_t dims[3] = {0, 0, 0};
+    size_t ndims = 0;
+    PVStructureArrayPtr pvDimensions;
+    if(offsets.dimension) pvDimensions = pvStructure->getSubField<PVStructureArray>(offsets.dimension);
+    if(pvDimensions) {
+        PVStructureArray::const_svector dimensions(pvDimensions->view());
+        for(; ndims < dimensions.size() && ndims < 3; ++ndims) {
+            PVIntPtr pvSize;
+            if(dimensions[ndims]) pvSize = dimensions[ndims]->getSubField<PVInt>("size");
+            if(pvSize) dims[ndims] = pvSize->get();
         }
-        PVIntArrayPtr ArrayData = std::tr1::static_pointer_cast<PVIntArray> (pva);
-        shared_vector<const int32> xxx(ArrayData->view());
-        kData.edata.fieldtype = DBF_LONG;
-        fillData(xxx, length, &kData);
     }
 
-    case pvUInt: {
-        if(length<1) {
-            kData.edata.fieldtype = DBF_LONG;
-            kData.edata.valueCount = 0;
-            return;
+    int colorMode = -1;
+    PVStructureArrayPtr pvAttributes;
+    if(offsets.attribute) pvAttributes = pvStructure->getSubField<PVStructureArray>(offsets.attribute);
+    if(pvAttributes) {
+        PVStructureArray::const_svector attributes(pvAttributes->view());
+        for(size_t i = 0; i < attributes.size(); ++i) {
+            if(!attributes[i]) continue;
+            PVStringPtr pvName = attributes[i]->getSubField<PVString>("name");
+            if(!pvName) continue;
+            string name = pvName->get();
+            if(name != "ColorMode" && name != "BayerPattern") continue;
+            PVUnionPtr pvAttribute = attributes[i]->getSubField<PVUnion>("value");
+            PVScalarPtr pvScalar;
+            if(pvAttribute) pvScalar = pvAttribute->get<PVScalar>();
+            if(!pvScalar) continue;
+            if(name == "ColorMode") colorMode = convert->toInt(pvScalar);
+            else frame.bayerPattern = convert->toInt(pvScalar);
         }
-        PVUIntArrayPtr ArrayData = std::tr1::static_pointer_cast<PVUIntArray> (pva);
-        shared_vector<const uint32> xxx(ArrayData->view());
-        kData.edata.fieldtype = DBF_LONG;
-        fillData(xxx, length, &kData);
-        return;
     }
 
-    case pvLong:
-    case pvULong:
-        requester->message("array of pvLong not yet supported", errorMessage);
-        return;
+    // without color mode attribute the color dimension tells it
+    if(colorMode < 0) {
+        if(ndims == 3 && dims[0] == 3) colorMode = imageRGB1;
+        else if(ndims == 3 && dims[1] == 3) colorMode = imageRGB2;
+        else if(ndims == 3 && dims[2] == 3) colorMode = imageRGB3;
+        else colorMode = imageMono;
+    }
+    frame.colorMode = colorMode;
+    switch(colorMode) {
+    case imageRGB1: frame.width = dims[1]; frame.height = dims[2]; break;
+    case imageRGB2: frame.width = dims[0]; frame.height = dims[2]; break;
+    case imageRGB3: frame.width = dims[0]; frame.height = dims[1]; break;
+    default: frame.width = dims[0]; frame.height = (ndims > 1 ? dims[1] : 1); break;
+    }
 
-    case pvFloat: {
-        if(length<1) {
-            kData.edata.fieldtype = DBF_FLOAT;
-            kData.edata.valueCount = 0;
-            return;
-        }
-        PVFloatArrayPtr ArrayData = std::tr1::static_pointer_cast<PVFloatArray> (pva);
-        shared_vector<const float> xxx(ArrayData->view());
-        kData.edata.fieldtype = DBF_FLOAT;
-        fillData(xxx, length, &kData);
-        return;
+    if(frame.codec.empty()) {
+        setImage(frame);
+    } else {
+        ndarrayDecoder->queueRequest(shared_from_this(), frame);
     }
+}
 
+void PVAInterface::setImage(NDArrayFrame const & frame)
+{
+    current.fieldtype = frame.fieldtype;
+    current.imageWidth = frame.width;
+    current.imageHeight = frame.height;
+    current.imageColorMode = frame.colorMode;
+    current.imageBayerPattern = frame.bayerPattern;
+    holdData(frame.data, frame.data.size() / frame.elementSize);
+    current.monitorCount++;
+}
 
-    case pvDouble: {
-        if(length<1) {
-            kData.edata.fieldtype = DBF_DOUBLE;
-            kData.edata.valueCount = 0;
-            return;
-        }
-        PVDoubleArrayPtr ArrayData = std::tr1::static_pointer_cast<PVDoubleArray> (pva);
-        shared_vector<const double> xxx(ArrayData->view());
-        kData.edata.fieldtype = DBF_DOUBLE;
-        fillData(xxx, length, &kData);
-    }
-    }
+// called by the decoder thread
+void PVAInterface::decodeDone(NDArrayFrame const & frame)
+{
+    Lock lock(dataMutex);
+    setImage(frame);
+    publish(false, true);
+}
+
+void PVAInterface::decodeFailed(std::string const & mess)
+{
+    if(codecReported) return;
+    codecReported = true;
+    message(mess, errorMessage);
 }
 
 bool PVAInterface::setValue(double rdata, int32_t idata, char *sdata, int forceType)
@@ -1686,7 +1910,7 @@ bool PVAInterface::setArrayValue(
 
 bool PVAInterface::getTimeStamp(char *buf)
 {
-    if(!structure->getField("timeStamp")) return false;
+    if(!offsets.seconds) return false;
     time_t tt;
     timeStamp.toTime_t(tt);
     struct tm ctm;
@@ -1727,7 +1951,12 @@ int Epics4Plugin::initCommunicationLayer(MutexKnobData *mutexKnobDataP, MessageW
     mutexKnobData = mutexKnobDataP;
     ClientFactory::start();
     CAClientFactory::start();
-    callbackThread = CallbackThread::create();
+    // more connection callback threads for displays with many channels
+    int callbackThreads = 1;
+    QString threads = (QString) qgetenv("CAQTDM_EPICS4_CALLBACKTHREADS");
+    if(!threads.isEmpty()) callbackThreads = qBound(1, threads.toInt(), 16);
+    callbackThread = CallbackThread::create(callbackThreads);
+    ndarrayDecoder = NDArrayDecoder::create();
     requester = Epics4RequesterPtr(new Epics4Requester(messageWindow));
     if(Epics4Plugin::getDebug()) cout << "Epics4Plugin::initCommunicationLayer return true\n";
     return true;
@@ -1775,13 +2004,47 @@ int Epics4Plugin::pvAddMonitor(int index, knobData *kData, int rate, int skip)
         pvaChannelMap.insert(std::pair<string,PVAChannelWPtr>(fullname,pvaChannel));
         if(Epics4Plugin::getDebug())cout << "created new and called connect\n";
     }
-    PVAInterfacePtr pvaInterface(
-         new PVAInterface(pvaChannel, mutexKnobData,index,requester,callbackThread));
-    pvaInterfaceGlue = new PVAInterfaceGlue(pvaInterface);
+    // the fields the widget needs, images and camera geometry channels do not show alarms
+    string monitorFields("value,alarm.severity,timeStamp");
+    string className(kData->clasName);
+    if(className == "cacamera" || className == "cascan2d") monitorFields = "value";
+
+    // queue size and flow control given with caqtdm_monitor
+    string monitorOptions;
+    if(kData->edata.queueSize > 0) {
+        char asc[40];
+        snprintf(asc, sizeof(asc), "queueSize=%d", kData->edata.queueSize);
+        monitorOptions = asc;
+    }
+    if(kData->edata.pipeline != 0) {
+        if(!monitorOptions.empty()) monitorOptions += ",";
+        monitorOptions += "pipeline=true";
+    }
+
+    // widgets with the same request share the interface, its monitor and the decoded data
+    string key(interfaceKey(fullname, monitorFields, monitorOptions));
+    PVAInterfacePtr pvaInterface;
+    std::map<string,PVAInterfaceWPtr>::iterator itf = pvaInterfaceMap.find(key);
+    if(itf != pvaInterfaceMap.end()) {
+        pvaInterface = itf->second.lock();
+        if(pvaInterface && !pvaInterface->isShareable()) pvaInterface.reset();
+        if(!pvaInterface) pvaInterfaceMap.erase(itf);
+    }
+    bool isNew(!pvaInterface);
+    if(isNew) {
+        pvaInterface = PVAInterfacePtr(
+             new PVAInterface(pvaChannel, mutexKnobData,requester,callbackThread,ndarrayDecoder,
+                              monitorFields,monitorOptions));
+        pvaInterfaceMap.insert(std::pair<string,PVAInterfaceWPtr>(key,pvaInterface));
+    }
+    pvaInterfaceGlue = new PVAInterfaceGlue(pvaInterface, index);
     kData->edata.info = pvaInterfaceGlue;
     C_SetMutexKnobData(mutexKnobData, index, *kData);
-    if(Epics4Plugin::getDebug()) cout << "calling addInterface\n";
-    pvaChannel->addInterface(pvaInterface);
+    pvaInterface->addSubscriber(index);
+    if(isNew) {
+        if(Epics4Plugin::getDebug()) cout << "calling addInterface\n";
+        pvaChannel->addInterface(pvaInterface);
+    }
     return true;
 }
 
@@ -1795,7 +2058,7 @@ int Epics4Plugin::pvClearMonitor(knobData *kData) {
     PVAInterfacePtr pvaInterface = pvaInterfaceGlue->getPVAInterface();
     if(!pvaInterface)
          throw std::runtime_error("Epics4Plugin::pvClearMonitor pvaInterface is null");
-    pvaInterface->clearMonitor();
+    pvaInterface->clearSubscriber(pvaInterfaceGlue->getIndex());
     return true;
 }
 
@@ -1809,21 +2072,26 @@ int Epics4Plugin::pvFreeAllocatedData(knobData *kData)
     PVAInterfacePtr pvaInterface = pvaInterfaceGlue->getPVAInterface();
     if(!pvaInterface)
          throw std::runtime_error("Epics4Plugin::pvFreeAllocatedData pvaInterface is null");
-    PVAChannelPtr pvaChannel(pvaInterface->getPVAChannel());
-    bool isLast = pvaChannel->removeInterface(pvaInterface);
-    if(isLast) {
-         string fullName = pvaChannel->getFullName();
-         std::map<string,PVAChannelWPtr>::iterator it = pvaChannelMap.find(fullName);
-         pvaChannelMap.erase(it);
-         pvaChannel->destroy();
-    }
-    pvaInterface->destroy();
+    bool isLastSubscriber = pvaInterface->removeSubscriber(pvaInterfaceGlue->getIndex());
+    if(isLastSubscriber) {
+         std::map<string,PVAInterfaceWPtr>::iterator itf = pvaInterfaceMap.find(pvaInterface->getKey());
+         if(itf != pvaInterfaceMap.end() && itf->second.lock() == pvaInterface) pvaInterfaceMap.erase(itf);
+         PVAChannelPtr pvaChannel(pvaInterface->getPVAChannel());
+         bool isLast = pvaChannel->removeInterface(pvaInterface);
+         if(isLast) {
+              string fullName = pvaChannel->getFullName();
+              std::map<string,PVAChannelWPtr>::iterator it = pvaChannelMap.find(fullName);
+              pvaChannelMap.erase(it);
+              pvaChannel->destroy();
+         }
+         pvaInterface->clearMonitor();
+         pvaInterface->destroy();
+    }
     kData->edata.info = NULL;
     delete pvaInterfaceGlue;
-    if(kData->edata.dataB != (void*) 0) {
-        if(kData->edata.dataB != (void*) 0) free(kData->edata.dataB);
-        kData->edata.dataB = (void*) 0;
-    }
+    // the data are held by the interface and released with it
+    kData->edata.dataB = (void*) 0;
+    kData->edata.dataSize = 0;
     return true;
 }
 
@@ -1879,7 +2147,7 @@ int Epics4Plugin::pvClearEvent(void * ptr) {
     PVAInterfaceGlue *pvaInterfaceGlue  = static_cast<PVAInterfaceGlue *>(ptr);
     PVAInterfacePtr pvaInterface = pvaInterfaceGlue->getPVAInterface();
     if(!pvaInterface) throw std::runtime_error("Epics4Plugin::pvSetWave pvaInterface is null");
-    pvaInterface->stopMonitor();
+    pvaInterface->setSubscriberStopped(pvaInterfaceGlue->getIndex(), true);
 
     return true;
 }
@@ -1889,7 +2157,7 @@ int Epics4Plugin::pvAddEvent(void * ptr) {
     PVAInterfaceGlue *pvaInterfaceGlue  = static_cast<PVAInterfaceGlue *>(ptr);
     PVAInterfacePtr pvaInterface = pvaInterfaceGlue->getPVAInterface();
     if(!pvaInterface) throw std::runtime_error("Epics4Plugin::pvSetWave pvaInterface is null");
-    pvaInterface->startMonitor();
+    pvaInterface->setSubscriberStopped(pvaInterfaceGlue->getIndex(), false);
     return true;
 }
 
@@ -54,6 +54,7 @@
 #include <QObject>
 #include "controlsinterface.h"
 #include "callbackThread.h"
+#include "ndarrayDecoder.h"
 #include "epics4Requester.h"
 
 
@@ -66,6 +67,10 @@ class PVAChannel;
 typedef std::tr1::shared_ptr<PVAChannel> PVAChannelPtr;
 typedef std::tr1::weak_ptr<PVAChannel> PVAChannelWPtr;
 
+class PVAInterface;
+typedef std::tr1::shared_ptr<PVAInterface> PVAInterfacePtr;
+typedef std::tr1::weak_ptr<PVAInterface> PVAInterfaceWPtr;
+
 
 }}}
 
@@ -126,8 +131,11 @@ public:
   private:
     static bool debug;
     std::map<std::string,epics::caqtdm::epics4::PVAChannelWPtr> pvaChannelMap;
+    // interfaces keyed by channel, monitored fields and options, shared by the widgets
+    std::map<std::string,epics::caqtdm::epics4::PVAInterfaceWPtr> pvaInterfaceMap;
     epics::caqtdm::epics4::Epics4RequesterPtr requester;
     epics::pvData::CallbackThreadPtr callbackThread;
+    epics::caqtdm::epics4::NDArrayDecoderPtr ndarrayDecoder;
     MutexKnobData * mutexKnobData;
 };
 
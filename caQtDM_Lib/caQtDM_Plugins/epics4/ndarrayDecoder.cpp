@@ -0,0 +1,165 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2014
+ *
+ *  Authors:
+ *    Marty Kraimer, Anton Mezger
+ *  Contact details:
+ *    anton.mezger@psi.ch, mrkraimer@comcast.net
+ */
+
+#include <pv/pvIntrospect.h>
+#ifdef EPICS4_LZ4
+#include <lz4.h>
+#endif
+#ifdef EPICS4_BLOSC
+#include <blosc.h>
+#endif
+
+#include "ndarrayDecoder.h"
+
+using namespace std;
+using namespace epics::pvData;
+
+namespace epics { namespace caqtdm { namespace epics4 {
+
+NDArrayDecoderPtr NDArrayDecoder::create()
+{
+    NDArrayDecoderPtr decoder(new NDArrayDecoder());
+    decoder->startThread();
+    return decoder;
+}
+
+NDArrayDecoder::~NDArrayDecoder()
+{
+    stop();
+}
+
+void NDArrayDecoder::startThread()
+{
+    thread = std::tr1::shared_ptr<epicsThread>(new epicsThread(
+        *this,
+        "ndarrayDecoder",
+        epicsThreadGetStackSize(epicsThreadStackSmall),
+        epicsThreadPriorityLow));
+    thread->start();
+}
+
+bool NDArrayDecoder::isSupported(string const & codec)
+{
+#ifdef EPICS4_LZ4
+    if(codec == "lz4") return true;
+#endif
+#ifdef EPICS4_BLOSC
+    if(codec == "blosc") return true;
+#endif
+    (void) codec;
+    return false;
+}
+
+void NDArrayDecoder::queueRequest(NDArrayDecodeRequesterPtr const & requester, NDArrayFrame const & frame)
+{
+    {
+        Lock xx(mutex);
+        if(stopRequested) return;
+        // only the newest frame of a channel is worth decoding
+        for(std::list<Request>::iterator it = requestList.begin(); it != requestList.end(); ++it) {
+            if(it->requester.lock() == requester) {
+                it->frame = frame;
+                return;
+            }
+        }
+        Request request;
+        request.requester = requester;
+        request.frame = frame;
+        requestList.push_back(request);
+    }
+    wakeup.signal();
+}
+
+void NDArrayDecoder::stop()
+{
+    {
+        Lock xx(mutex);
+        if(stopRequested) return;
+        stopRequested = true;
+        requestList.clear();
+    }
+    wakeup.signal();
+    runReturn.wait();
+}
+
+void NDArrayDecoder::run()
+{
+    while(true) {
+        wakeup.wait();
+        while(true) {
+            Request request;
+            {
+                Lock xx(mutex);
+                if(stopRequested) {
+                    runReturn.signal();
+                    return;
+                }
+                if(requestList.empty()) break;
+                request = requestList.front();
+                requestList.pop_front();
+            }
+            NDArrayDecodeRequesterPtr requester(request.requester.lock());
+            if(!requester) continue;
+            string error;
+            if(decode(request.frame, error)) requester->decodeDone(request.frame);
+            else requester->decodeFailed(error);
+        }
+    }
+}
+
+// replaces the compressed data of the frame by the decompressed ones
+bool NDArrayDecoder::decode(NDArrayFrame & frame, string & error)
+{
+    const char *source = static_cast<const char *>(frame.data.data());
+    size_t sourceSize = frame.data.size();
+    size_t size = frame.uncompressedSize;
+    if(size == 0 || (size % frame.elementSize) != 0) {
+        error = "codec " + frame.codec + " with invalid uncompressed size";
+        return false;
+    }
+    shared_vector<uint8> result(size);
+    int decoded = -1;
+#ifdef EPICS4_LZ4
+    if(frame.codec == "lz4") {
+        decoded = LZ4_decompress_safe(source, (char *) result.data(), (int) sourceSize, (int) size);
+    }
+#endif
+#ifdef EPICS4_BLOSC
+    if(frame.codec == "blosc") {
+        decoded = blosc_decompress_ctx(source, result.data(), size, 1);
+    }
+#endif
+    (void) source;
+    (void) sourceSize;
+    if(decoded != (int) size) {
+        error = "codec " + frame.codec + " could not decompress the data";
+        return false;
+    }
+    frame.data = static_shared_vector_cast<const void>(freeze(result));
+    frame.codec.clear();
+    return true;
+}
+
+}}}
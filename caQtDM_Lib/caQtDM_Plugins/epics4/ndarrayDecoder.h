@@ -0,0 +1,105 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2014
+ *
+ *  Authors:
+ *    Marty Kraimer, Anton Mezger
+ *  Contact details:
+ *    anton.mezger@psi.ch, mrkraimer@comcast.net
+ */
+
+#ifndef NDARRAYDECODER_H
+#define NDARRAYDECODER_H
+
+#include <list>
+#include <string>
+#include <epicsThread.h>
+#include <pv/event.h>
+#include <pv/lock.h>
+#include <pv/sharedVector.h>
+
+
+namespace epics { namespace caqtdm { namespace epics4 {
+
+// one image of an ndarray channel with its geometry and the data type of the decoded data
+struct NDArrayFrame
+{
+    NDArrayFrame()
+    : width(0), height(0), colorMode(0), bayerPattern(0), fieldtype(0), elementSize(1), uncompressedSize(0)
+    {}
+    epics::pvData::shared_vector<const void> data;
+    std::string codec;
+    int width;
+    int height;
+    short colorMode;
+    short bayerPattern;
+    short fieldtype;
+    size_t elementSize;
+    size_t uncompressedSize;
+};
+
+class NDArrayDecodeRequester;
+typedef std::tr1::shared_ptr<NDArrayDecodeRequester> NDArrayDecodeRequesterPtr;
+typedef std::tr1::weak_ptr<NDArrayDecodeRequester> NDArrayDecodeRequesterWPtr;
+
+class epicsShareClass NDArrayDecodeRequester
+{
+public:
+    virtual ~NDArrayDecodeRequester(){}
+    virtual void decodeDone(NDArrayFrame const & frame) = 0;
+    virtual void decodeFailed(std::string const & message) = 0;
+};
+
+class NDArrayDecoder;
+typedef std::tr1::shared_ptr<NDArrayDecoder> NDArrayDecoderPtr;
+
+// decompresses lz4/blosc compressed ndarrays on its own thread, so that the monitor callbacks
+// are not blocked; a frame still waiting is replaced by a newer one of the same requester
+
+class epicsShareClass NDArrayDecoder :
+    public epicsThreadRunable
+{
+    struct Request {
+        NDArrayDecodeRequesterWPtr requester;
+        NDArrayFrame frame;
+    };
+    std::list<Request> requestList;
+    std::tr1::shared_ptr<epicsThread> thread;
+    epics::pvData::Mutex mutex;
+    epics::pvData::Event wakeup;
+    epics::pvData::Event runReturn;
+    bool stopRequested;
+public:
+    POINTER_DEFINITIONS(NDArrayDecoder);
+    ~NDArrayDecoder();
+    virtual void run();
+    static NDArrayDecoderPtr create();
+    static bool isSupported(std::string const & codec);
+    void queueRequest(NDArrayDecodeRequesterPtr const & requester, NDArrayFrame const & frame);
+    void stop();
+private:
+    NDArrayDecoder()
+    : stopRequested(false)
+    {}
+    void startThread();
+    static bool decode(NDArrayFrame & frame, std::string & error);
+};
+
+}}}
+
+#endif // NDARRAYDECODER_H
@@ -60,6 +60,10 @@
 #include "caqtdm_lib.h"
 #include "parsepepfile.h"
 #include "fileFunctions.h"
+#include "uifilecache.h"
+#include "displaypathindex.h"
+#include "displayimage.h"
+#include "displaytrace.h"
 
 #include "myMessageBox.h"
 #include "alarmstrings.h"
@@ -298,7 +302,13 @@ CaQtDM_Lib::CaQtDM_Lib(QWidget *parent, QString filename, QString macro, MutexKn
                        ControlsInterface *> interfaces, MessageWindow *msgWindow, bool pepprint, QWidget *parentAS,
                        QMap<QString,QString> options) : QMainWindow(parent)
 {
-    QUiLoader loader;
+    DisplayTraceLoader loader;
+    QElapsedTimer openTimer;
+    qint64 loadTime = 0, scanTime = 0, softTime = 0, flushTime = 0;
+    DisplayTrace::Scope openTrace("open", "display", filename);
+    DisplayTrace::Scope loadTrace("load", "display", filename);
+    openTimer.start();
+    includeLoadTime = 0;
     fromAS = false;
     AllowsUpdate = true;
     mutexKnobDataP = mKnobData;
@@ -325,6 +335,12 @@ CaQtDM_Lib::CaQtDM_Lib(QWidget *parent, QString filename, QString macro, MutexKn
         }
     }
 
+    // widgets on hidden pages or in hidden includes get their channels when they become visible,
+    // prefetch gives the number of pages around the actual one getting their channels anyway
+    lazyActivation = options["activation"].contains("lazy");
+    prefetchPages = qMax(options["prefetch"].toInt(), 0);
+    deferredMonitors.clear();
+
     // file watcher for changes
     watcher = new QFileSystemWatcher(this);
     QObject::connect(watcher, SIGNAL(fileChanged(const QString&)), this, SLOT(handleFileChanged(const QString&)));
@@ -350,9 +366,15 @@ CaQtDM_Lib::CaQtDM_Lib(QWidget *parent, QString filename, QString macro, MutexKn
     if(!fromAS) {
         if(filename.lastIndexOf(".ui") != -1) {
 
-            file->open(QFile::ReadOnly);
-
-            myWidget = loader.load(file, this);
+            // a compiled display image is used when up to date, otherwise the ui file is parsed
+            DisplayTrace::Scope imageTrace("display image", "load", filename);
+            myWidget = DisplayImage::load(&loader, filename, this);
+            imageTrace.end();
+            if(!myWidget) {
+                DisplayTrace::Scope parseTrace("ui file", "load", filename);
+                file->open(QFile::ReadOnly);
+                myWidget = loader.load(file, this);
+            }
 
             if (!myWidget) {
                 QMessageBox::warning(this, tr("caQtDM"), tr("Error loading %1. Use designer to find errors").arg(filename));
@@ -435,6 +457,9 @@ CaQtDM_Lib::CaQtDM_Lib(QWidget *parent, QString filename, QString macro, MutexKn
 #endif
     }
 
+    loadTime = openTimer.restart();
+    loadTrace.end();
+
     // connect all signals of our propagators
     QList<wmSignalPropagator *> allM = this->findChildren<wmSignalPropagator *>();
     foreach(wmSignalPropagator* widget, allM) {
@@ -488,6 +513,8 @@ CaQtDM_Lib::CaQtDM_Lib(QWidget *parent, QString filename, QString macro, MutexKn
     stripGroupList.clear();
     stripList.clear();
     softvars.clear();
+    internalMacros.clear();
+    macroContexts.clear();
 
     nbIncludes = 0;
     splashCounter = 1;
@@ -511,10 +538,17 @@ CaQtDM_Lib::CaQtDM_Lib(QWidget *parent, QString filename, QString macro, MutexKn
     savedFile[0] = fi.baseName();
     savedMacro[0] = macro;
 
+    openTimer.restart();
+    DisplayTrace::Scope scanTrace("scan", "display", filename);
     scanWidgets(myWidget->findChildren<QWidget *>(), macro);
+    scanTime = openTimer.restart();
+    scanTrace.end();
 
     // build a list for getting all soft pv
+    DisplayTrace::Scope softTrace("softpvs", "display", filename);
     mutexKnobDataP->BuildSoftPVList(myWidget);
+    softTime = openTimer.restart();
+    softTrace.end();
 
     // setup changeevent for QTabWidgets
     allTabs = myWidget->findChildren<QTabWidget *>();
@@ -555,7 +589,11 @@ CaQtDM_Lib::CaQtDM_Lib(QWidget *parent, QString filename, QString macro, MutexKn
     loopTimerID = startTimer(1000);
 
     // all interfaces flush io
+    openTimer.restart();
+    DisplayTrace::Scope flushTrace("flush", "display", filename);
     FlushAllInterfaces();
+    flushTime = openTimer.elapsed();
+    flushTrace.end();
 
     // due to crash in connection with the splash screen, changed
     // these instructions to the botton of this class
@@ -603,8 +641,23 @@ CaQtDM_Lib::CaQtDM_Lib(QWidget *parent, QString filename, QString macro, MutexKn
     snprintf(asc, MAX_STRING_LENGTH, "special macro CAQTDM_INTERNAL_UIPATH set to %s\n", qasc(path));
     postMessage(QtWarningMsg, asc);
 
+    // only when tracing: cost of opening this display by phase, the loading of the includes is part
+    // of the widget scan, and the file lookups answered without probing the file system
+    if(DisplayTrace::isEnabled()) {
+        snprintf(asc, MAX_STRING_LENGTH, "display %s opened: load %lldms, widgets %lldms (includes loaded in %lldms), softpvs %lldms, flush %lldms\n",
+                 qasc(thisFileShort), (long long) loadTime, (long long) scanTime, (long long) includeLoadTime, (long long) softTime, (long long) flushTime);
+        postMessage(QtWarningMsg, asc);
+
+        snprintf(asc, MAX_STRING_LENGTH, "display path index: %lld probes avoided, %lld made\n",
+                 (long long) displayPathIndex::instance()->probesAvoided(), (long long) displayPathIndex::instance()->probes());
+        postMessage(QtWarningMsg, asc);
+    }
+
     strcpy(asc,"unresolved macros present, press context in display to obtain a list");
     if(unknownMacrosList.count() > 0) postMessage(QtCriticalMsg, asc);
+
+    openTrace.end();
+    DisplayTrace::write();
 }
 
 /**
@@ -625,6 +678,9 @@ void CaQtDM_Lib::ResizeScrollBars(caInclude * includeWidget, int sizeX, int size
 void CaQtDM_Lib::Callback_TabChanged(int current)
 {
     Q_UNUSED(current);
+    // create the channels of the widgets becoming visible
+    activateWidgets();
+
     // Enable & Disable IO when in invisible page of a TabWidget
     EnableDisableIO();
     FlushAllInterfaces();
@@ -805,6 +861,9 @@ void CaQtDM_Lib::EnableDisableIO()
 void CaQtDM_Lib::timerEvent(QTimerEvent *event)
 {
     Q_UNUSED(event);
+    // includes may have become visible
+    activateWidgets();
+
     // for epics we flush the buffer every second
     FlushAllInterfaces();
 
@@ -963,21 +1022,90 @@ QMap<QString, QString> CaQtDM_Lib::createMap(const QString& macro)
     return map;
 }
 
+/**
+ * this routine gives the map of a macro string completed with the special CAQTDM_INTERNAL macros
+ * the special macros do not change while a display is opened, so they are computed only once; the map
+ * of a macro string is built once and shared by all widgets using it
+ */
+QMap<QString, QString> CaQtDM_Lib::macroContext(const QString& macro)
+{
+    QHash<QString, QMap<QString, QString> >::const_iterator it = macroContexts.constFind(macro);
+    if(it != macroContexts.constEnd()) return it.value();
+
+    if(internalMacros.isEmpty()) {
+        QString path = thisFileFull;
+        int pos = path.lastIndexOf("/");
+        if((pos > 0) && ((path.length() - pos -1) > 0)) path.chop(path.length() - pos -1);
+        internalMacros.insert("CAQTDM_INTERNAL_UIPATH", path);
+        internalMacros.insert("CAQTDM_INTERNAL_STARTTIME", QTime::currentTime().toString());
+        internalMacros.insert("CAQTDM_INTERNAL_STARTDATE", QDate::currentDate().toString("dd.MM.yyyy"));
+
+        internalMacros.insert("CAQTDM_INTERNAL_VERSION", TARGET_VERSION_STR);
+
+        QString message = QString("%1");
+        message = message.arg(QT_VERSION_STR);
+        internalMacros.insert("CAQTDM_INTERNAL_QTVERSION", message);
+
+        path =qApp->applicationFilePath();
+        pos = path.lastIndexOf("/");
+        if((pos > 0) && ((path.length() - pos -1) > 0)) path.chop(path.length() - pos -1);
+        internalMacros.insert("CAQTDM_INTERNAL_EXEPATH", path);
+
+        internalMacros.insert("CAQTDM_INTERNAL_PID",QString::number(qApp->applicationPid()));
+        internalMacros.insert("CAQTDM_INTERNAL_HOSTNAME", QHostInfo::localHostName());
+
+        internalMacros.insert("CAQTDM_INTERNAL_SCREENCOUNT",QString::number( qApp->desktop()->screenCount()));
+        internalMacros.insert("CAQTDM_INTERNAL_DPI",QString::number( qApp->desktop()->physicalDpiX())); //qApp->primaryScreen()->physicalDotsPerInch()));
+#if QT_VERSION >= QT_VERSION_CHECK(5, 8, 0)
+        internalMacros.insert("CAQTDM_INTERNAL_REFRESHRATE",QString::number(qApp->primaryScreen()->refreshRate()));
+#endif
+        internalMacros.insert("CAQTDM_INTERNAL_DESKTOP_WIDTH",QString::number(qApp->desktop()->size().width()));
+        internalMacros.insert("CAQTDM_INTERNAL_DESKTOP_HEIGHT",QString::number(qApp->desktop()->size().height()));
+
+        internalMacros.insert("CAQTDM_INTERNAL_CA_ADDRLIST",qgetenv("EPICS_CA_ADDR_LIST"));
+        internalMacros.insert("CAQTDM_INTERNAL_BS_ADDRLIST",qgetenv("BSREAD_ZMQ_ADDR_LIST"));
+        internalMacros.insert("CAQTDM_INTERNAL_BS_DISPATCHER",qgetenv("BSREAD_DISPATCHER"));
+    }
+
+    // special macros take precedence over the macros of the string
+    QMap<QString, QString> map = createMap(macro);
+    QMap<QString, QString>::const_iterator i;
+    for(i = internalMacros.constBegin(); i != internalMacros.constEnd(); ++i) map.insert(i.key(), i.value());
+    macroContexts.insert(macro, map);
+    return map;
+}
+
+/**
+ * only these widgets are treated by HandleWidget
+ */
+static bool isHandledWidget(const QString &className)
+{
+    return className.contains("ca") || className.contains("QTextBrowser") || className.contains("replaceMacro") ||
+           className.contains("QE") || className.contains("QTabWidget");
+}
+
 void CaQtDM_Lib::scanWidgets(QList<QWidget*> list, QString macro)
 {
-    // get first all primary softs (inorder that pv working on their own value will always be treated first
-    //qDebug() << " ------------ first pass treat softs being involved in itsself (incrementing)";
+    // classify the widgets once; the softs have to be defined before all other widgets, first the ones
+    // working on their own value (incrementing), then the other ones, and the rest comes afterwards
+    QList<QWidget*> softs, handled;
     foreach(QWidget *w1, list) {
+        if(!isHandledWidget(w1->metaObject()->className())) continue;
+        if(qobject_cast<caCalc *>(w1)) softs.append(w1);
+        handled.append(w1);
+    }
+
+    //qDebug() << " ------------ first pass treat softs being involved in itsself (incrementing)";
+    foreach(QWidget *w1, softs) {
         HandleWidget(w1, macro, true, true);
     }
     //qDebug() << " ------------ first pass other softs";
-    // other softpvs
-    foreach(QWidget *w1, list) {
+    foreach(QWidget *w1, softs) {
         HandleWidget(w1, macro, true, false);
     }
-    // other pvs
+    // other pvs, the softs are taken by now
     //qDebug() << " ------------ no first pass other stuff";
-    foreach(QWidget *w1, list) {
+    foreach(QWidget *w1, handled) {
         HandleWidget(w1, macro, false, false);
     }
 }
@@ -996,8 +1124,8 @@ void CaQtDM_Lib::HandleWidget(QWidget *w1, QString macro, bool firstPass, bool t
     QString pv;
 
     QString className(w1->metaObject()->className());
-    if(!className.contains("ca") && !className.contains("QTextBrowser") && !className.contains("replaceMacro") &&
-            !className.contains("QE") && !className.contains("QTabWidget")) return;
+    if(!isHandledWidget(className)) return;
+    DisplayTrace::Scope trace("HandleWidget", "widget", DisplayTrace::isEnabled() ? className + " " + w1->objectName() : QString());
 
     int nbMonitors = 0;
 
@@ -1012,40 +1140,7 @@ void CaQtDM_Lib::HandleWidget(QWidget *w1, QString macro, bool firstPass, bool t
 
     if(className.contains("ca") || className.contains("QTextBrowser") || className.contains("replaceMacro") || className.contains("QTabWidget")) {
         PRINT(printf("\n%*c %s macro=<%s>", 15 * level, '+', qasc(w1->objectName()), qasc(macro)));
-        map = createMap(macro);
-        // insert special macro into map
-        QString path = thisFileFull;
-        int pos = path.lastIndexOf("/");
-        if((pos > 0) && ((path.length() - pos -1) > 0)) path.chop(path.length() - pos -1);
-        map.insert("CAQTDM_INTERNAL_UIPATH", path);
-        map.insert("CAQTDM_INTERNAL_STARTTIME", QTime::currentTime().toString());
-        map.insert("CAQTDM_INTERNAL_STARTDATE", QDate::currentDate().toString("dd.MM.yyyy"));
-
-        map.insert("CAQTDM_INTERNAL_VERSION", TARGET_VERSION_STR);
-
-        QString message = QString("%1");
-        message = message.arg(QT_VERSION_STR);
-        map.insert("CAQTDM_INTERNAL_QTVERSION", message);
-
-        path =qApp->applicationFilePath();
-        pos = path.lastIndexOf("/");
-        if((pos > 0) && ((path.length() - pos -1) > 0)) path.chop(path.length() - pos -1);
-        map.insert("CAQTDM_INTERNAL_EXEPATH", path);
-
-        map.insert("CAQTDM_INTERNAL_PID",QString::number(qApp->applicationPid()));
-        map.insert("CAQTDM_INTERNAL_HOSTNAME", QHostInfo::localHostName());
-
-        map.insert("CAQTDM_INTERNAL_SCREENCOUNT",QString::number( qApp->desktop()->screenCount()));
-        map.insert("CAQTDM_INTERNAL_DPI",QString::number( qApp->desktop()->physicalDpiX())); //qApp->primaryScreen()->physicalDotsPerInch()));
-#if QT_VERSION >= QT_VERSION_CHECK(5, 8, 0)
-        map.insert("CAQTDM_INTERNAL_REFRESHRATE",QString::number(qApp->primaryScreen()->refreshRate()));
-#endif
-        map.insert("CAQTDM_INTERNAL_DESKTOP_WIDTH",QString::number(qApp->desktop()->size().width()));
-        map.insert("CAQTDM_INTERNAL_DESKTOP_HEIGHT",QString::number(qApp->desktop()->size().height()));
-
-        map.insert("CAQTDM_INTERNAL_CA_ADDRLIST",qgetenv("EPICS_CA_ADDR_LIST"));
-        map.insert("CAQTDM_INTERNAL_BS_ADDRLIST",qgetenv("BSREAD_ZMQ_ADDR_LIST"));
-        map.insert("CAQTDM_INTERNAL_BS_DISPATCHER",qgetenv("BSREAD_DISPATCHER"));
+        map = macroContext(macro);
     }
 
     QColor bg = w1->property("background").value<QColor>();
@@ -2129,7 +2224,7 @@ void CaQtDM_Lib::HandleWidget(QWidget *w1, QString macro, bool firstPass, bool t
         w1->setProperty("ObjectType", caInclude_Widget);
 
         QWidget *thisW = (QWidget *) 0;
-        QUiLoader loader;
+        DisplayTraceLoader loader;
         bool prcFile = false;
 
         QHBoxLayout *boxLayout = new QHBoxLayout;
@@ -2262,6 +2357,7 @@ void CaQtDM_Lib::HandleWidget(QWidget *w1, QString macro, bool firstPass, bool t
             QFileInfo fi(fileName);
             if(fi.exists()) {
                 qint64 diff=0;
+                DisplayTrace::Scope loadTrace("include load", "include", fileName);
                 // load prc or ui file
                 if(prcFile) {
                     // load new file
@@ -2275,13 +2371,8 @@ void CaQtDM_Lib::HandleWidget(QWidget *w1, QString macro, bool firstPass, bool t
                     QElapsedTimer timer;
                     timer.start();
 #endif
-                    QFile *file = new QFile;
-                    // open and load ui file
-                    file->setFileName(fileName);
-                    file->open(QFile::ReadOnly);
-                    thisW = loader.load(file, this);
-                    file->close();
-                    delete file;
+                    // load ui file, built from the template compiled only once for all instances of this include
+                    thisW = uiFileCache::instance()->load(&loader, fileName, this);
 
 #if !defined(useElapsedTimer)
                     double now = rTime();
@@ -2290,7 +2381,9 @@ void CaQtDM_Lib::HandleWidget(QWidget *w1, QString macro, bool firstPass, bool t
                     diff = timer.elapsed();
 #endif
                     if(diff < 1) diff=1; // you really do not believe that smaller is possible, do you?
+                    includeLoadTime += diff;
                 }
+                loadTrace.end();
 
                 QMap<QString, includeData>::const_iterator name = includeFilesList.find(fi.absoluteFilePath());
                 if(name != includeFilesList.end()) {
@@ -2396,7 +2489,9 @@ void CaQtDM_Lib::HandleWidget(QWidget *w1, QString macro, bool firstPass, bool t
                         cainclude_path=cainclude_path+pathcomponents.join("/")+"/";
                     }
 
+                    DisplayTrace::Scope scanTrace("include scan", "include", fileName);
                     scanWidgets(thisW->findChildren<QWidget *>(), macroS);
+                    scanTrace.end();
 
                     // take into account recursive use of directories
                     if(cainclude_path.contains("/")) {
@@ -2801,7 +2896,7 @@ void CaQtDM_Lib::HandleWidget(QWidget *w1, QString macro, bool firstPass, bool t
         stripplotWidget->setPVS(text);
         QStringList vars = text.split(";", QString::SkipEmptyParts);
 
-        int NumberOfCurves = min(vars.count(), caStripPlot::MAXCURVES);
+        int NumberOfCurves = vars.count();
 
         // go through the defined curves and add monitor
 
@@ -3078,97 +3173,17 @@ void CaQtDM_Lib::updateTextBrowser()
 QString CaQtDM_Lib::treatMacro(QMap<QString, QString> map, const QString& text, bool *doNothing, QString widgetName)
 {
     QString newText = text;
-    char asc[MAX_STRING_LENGTH];
     *doNothing = false;
     // a macro exists and when pv contains a right syntax then replace pv
     if(!map.isEmpty()) {
         if(text.contains("$(") && text.contains(")")) {
-            // normal macroexchange
-            QMapIterator<QString, QString> i(map);
-            int recursive_counter = 0;
-            bool recursive_continue=true;
-            while (recursive_continue) {
-                //recursive_continue=false;
-                QString newText_Backup=newText;
-                while (i.hasNext()) {
-                    i.next();
-                    QString toReplace = "$(" + i.key() + ")";
-                    //qDebug() << "replace in" << newText << toReplace << "with" << i.value();
-                    newText.replace(toReplace, i.value());
-                }
-                if (newText_Backup.compare(newText)==0){
-                    //qDebug() << "finish Loop simple Macro Replace";
-                    recursive_continue=false;
-                }
-                if(recursive_counter++ > 10) break;
+            QList<MacroEngine::Message> messages;
+            macroEngine.setMacros(map);
+            newText = macroEngine.expand(text, &messages);
+            foreach(MacroEngine::Message message, messages) {
+                postMessage(message.type, (char*) qasc(message.text));
             }
-            i.toFront();
-            if(newText.contains("$(")){
-                //qDebug() << "Spezial";
-                while (i.hasNext()) {
-                    i.next();
-                    QString tofind = "$(" + i.key()+"{";
-                    int position=newText.indexOf(tofind);
-                    while (position!=(-1)){
-                        //qDebug() << "position" <<position;
-                        if ((position>=0)&&(position<newText.length())){
-                            int json_start=(position-1)+tofind.length();
-                            int json_end  =newText.indexOf(QString("})"),json_start);
-
-                            //qDebug() << "newText.mid(): " << newText.mid(json_start,json_end-json_start+1);
-                            QString macro_regex="";
-                            QString macro_value="Parsing Error";
-                            bool macro_value_found=false;
-
-                            JSONObject jsonobj;
-                            JSONValue *MacroDataJ = JSON::Parse(newText.mid(json_start,json_end-json_start+1).toStdString().c_str());
-                            if (MacroDataJ!=NULL){
-                                if(!MacroDataJ->IsObject()) {
-                                    delete(MacroDataJ);
-                                } else {
-                                    jsonobj=MacroDataJ->AsObject();
-                                    if (jsonobj.find(L"regex") != jsonobj.end() && jsonobj[L"regex"]->IsString()) {
-                                        macro_regex=QString::fromWCharArray(jsonobj[L"regex"]->AsString().c_str());
-                                    }
-
-                                    if (jsonobj.find(L"value") != jsonobj.end() && jsonobj[L"value"]->IsString()) {
-                                        macro_value=QString::fromWCharArray(jsonobj[L"value"]->AsString().c_str());
-                                        macro_value_found=true;
-                                    }
-                                    delete(MacroDataJ);
-                                }
-                            }else{
-                                snprintf(asc, MAX_STRING_LENGTH, "JSON Error in (%s)", qasc(newText.mid(json_start,json_end-json_start+1)));
-                                postMessage(QtWarningMsg, asc);
-
-                            }
-
-                            QRegExp rx_json;
-                            QString toReplace = "$(" + i.key() + newText.mid(json_start,json_end-json_start+1) + ")";
-                            rx_json.setPattern(macro_regex);
-                            if (rx_json.isValid()){
-                                QString ReplaceWith=i.value();
-                                    if (macro_value_found){
-                                    ReplaceWith.replace(rx_json,macro_value);
-
-                                    //qDebug() << "replace in" << newText << toReplace << "with" << ReplaceWith << "outof " << macro_value;
-                                    snprintf(asc, MAX_STRING_LENGTH, "Replace (%s) (%s) with (%s) Regex:(%s)", qasc(i.key()), qasc(i.value()),qasc(macro_value),qasc(macro_regex));
-                                    postMessage(QtDebugMsg, asc);
-                                    newText.replace(toReplace, ReplaceWith);
-                                }else{
-                                    snprintf(asc, MAX_STRING_LENGTH, "No Replacement found do simple(%s) (%s) macro resolution", qasc(i.key()), qasc(i.value()));
-                                    //qDebug() << "No Replacement found do simple(%s) (%s) macro resolution" <<  qasc(i.key()) <<  qasc(i.value()) << text;
-                                    postMessage(QtWarningMsg, asc);
-                                    newText.replace(toReplace, i.value());
-                                }
-                            }
-
-                        }
-                        position=newText.indexOf(tofind,position+1);
-                    }
-                }
 
-            }
             // unresolved macros
             if(newText.contains("$(")){
                 QString unresMacro = "";
@@ -3316,11 +3331,14 @@ int CaQtDM_Lib::addMonitor(QWidget *thisW, knobData *kData, QString pv, QWidget
     int indx;
     QString pluginName="";
     QString pluginFlavor="";
+    DisplayTrace::Scope trace("addMonitor", "monitor", pv);
     ControlsInterface *plugininterface = (ControlsInterface *) 0;
 
     ftime(&now);
     w->setProperty("Connect", false);
     int rate = DEFAULTRATE;  // default will be 5Hz
+    int queueSize = 0;
+    int pipeline = 0;
 
     if(pv.size() == 0) return -1;
 
@@ -3336,7 +3354,7 @@ int CaQtDM_Lib::addMonitor(QWidget *thisW, knobData *kData, QString pv, QWidget
         char asc[MAX_STRING_LENGTH];
         QString JSONString = trimmedPV.mid(pos+1);
         trimmedPV = trimmedPV.mid(0, pos);
-        status = parseForDisplayRate(JSONString, rate);
+        status = parseForDisplayRate(JSONString, rate, &queueSize, &pipeline);
         trimmedPV = trimmedPV + "." + JSONString;
         if(!status) {
             snprintf(asc, MAX_STRING_LENGTH, "JSON parsing error on %s ,should be like {\"monitor\":{\"maxdisplayrate\":10}}", (char*) qasc(pv.trimmed()));
@@ -3503,6 +3521,8 @@ int CaQtDM_Lib::addMonitor(QWidget *thisW, knobData *kData, QString pv, QWidget
     kData->edata.initialize = true;
     kData->edata.lastTime = now;
     kData->edata.repRate = rate;   // default 5 Hz
+    kData->edata.queueSize = queueSize;
+    kData->edata.pipeline = pipeline;
 
     // update data structure
     mutexKnobDataP->SetMutexKnobData(num, *kData);
@@ -3513,10 +3533,33 @@ int CaQtDM_Lib::addMonitor(QWidget *thisW, knobData *kData, QString pv, QWidget
         return num;
     }
 
+    // channels of hidden widgets are created when they become visible
+    if(lazyActivation && (plugininterface != (ControlsInterface *) 0) && isDeferred(w)) {
+        deferredMonitors.insert(num, w);
+        memset(kData, 0, sizeof (knobData));
+        return num;
+    }
+
     // define data acquisition
-    if(plugininterface != (ControlsInterface *) 0) plugininterface->pvAddMonitor(num, kData, rate, false);
+    if(plugininterface != (ControlsInterface *) 0) {
+        DisplayTrace::Scope pluginTrace("pvAddMonitor", "monitor", DisplayTrace::isEnabled() ? QString(kData->pluginName) + " " + kData->pv : QString());
+        plugininterface->pvAddMonitor(num, kData, rate, false);
+    }
 
     // add for this widget the io info
+    addMonitorInfo(w, kData);
+
+    // clear data
+    memset(kData, 0, sizeof (knobData));
+
+    return num;
+}
+
+/**
+ * keep for a widget the io info of its monitors
+ */
+void CaQtDM_Lib::addMonitorInfo(QWidget *w, knobData *kData)
+{
     QVariant v = qVariantFromValue(kData->edata.info);
     QVariant var1=w->property("InfoList");
     QVariantList infoList1 = var1.toList();
@@ -3528,11 +3571,65 @@ int CaQtDM_Lib::addMonitor(QWidget *thisW, knobData *kData, QString pv, QWidget
     QVariantList infoList2 = var2.toList();
     infoList2.append(plugin);
     w->setProperty("Interface", infoList2);
+}
 
-    // clear data
-    memset(kData, 0, sizeof (knobData));
+/**
+ * a widget on a hidden page of a tab or stacked widget (not within the prefetched pages around the actual one)
+ * or inside a hidden include is deferred; caCalc and the plots needing a history are never deferred
+ */
+bool CaQtDM_Lib::isDeferred(QWidget *w)
+{
+    if(qobject_cast<caCalc *>(w)) return false;
+    QString className = w->metaObject()->className();
+    if(className.contains("caStripPlot") || className.contains("caWaterfallPlot")) return false;
 
-    return num;
+    QWidget *child = w;
+    QWidget *parent = w->parentWidget();
+    while((parent != (QWidget*) 0) && (child != myWidget)) {
+        if((child != w) && child->isHidden() && (qobject_cast<caInclude *>(child) != (caInclude *) 0)) return true;
+        if(QStackedWidget* stack = qobject_cast<QStackedWidget *>(parent)) {
+            int page = stack->indexOf(child);
+            if((page >= 0) && (qAbs(page - stack->currentIndex()) > prefetchPages)) return true;
+        }
+        child = parent;
+        parent = parent->parentWidget();
+    }
+    return false;
+}
+
+/**
+ * create the channels of the deferred widgets that are not hidden anymore
+ */
+void CaQtDM_Lib::activateWidgets()
+{
+    if(deferredMonitors.isEmpty()) return;
+
+    int count = 0;
+    QMutableMapIterator<int, QPointer<QWidget> > i(deferredMonitors);
+    while(i.hasNext()) {
+        i.next();
+
+        // widget deleted meanwhile (include reloaded), its channel will never be created
+        if(i.value().isNull()) {
+            knobData kData = mutexKnobDataP->GetMutexKnobData(i.key());
+            kData.index = -1;
+            mutexKnobDataP->SetMutexKnobData(i.key(), kData);
+            i.remove();
+            continue;
+        }
+        if(isDeferred(i.value())) continue;
+
+        knobData kData = mutexKnobDataP->GetMutexKnobData(i.key());
+        ControlsInterface *plugininterface = (ControlsInterface *) kData.pluginInterface;
+        if((kData.index != -1) && (plugininterface != (ControlsInterface *) 0)) {
+            plugininterface->pvAddMonitor(i.key(), &kData, kData.edata.repRate, false);
+            addMonitorInfo(i.value(), &kData);
+            count++;
+        }
+        i.remove();
+    }
+
+    if(count > 0) FlushAllInterfaces();
 }
 
 /**
@@ -3660,7 +3757,6 @@ bool CaQtDM_Lib::Python_Error(QWidget *w, QString message)
 
     postMessage(QtWarningMsg, asc);
     setCalcToNothing(w);
-    Py_Finalize();
 #else
     Q_UNUSED(w);
     Q_UNUSED(message);
@@ -3668,6 +3764,86 @@ bool CaQtDM_Lib::Python_Error(QWidget *w, QString message)
     return true;
 }
 
+#ifdef PYTHON
+#define MAXMONITORS 4
+
+/**
+ * the python function of a widget is compiled once and kept together with its argument tuple,
+ * it is compiled again when the calc of the widget changes
+ */
+CaQtDM_Lib::pythonCalc *CaQtDM_Lib::getPythonCalc(QWidget *w, const QString &calcQString)
+{
+    QHash<QWidget*, pythonCalc>::iterator it = pythonCalcs.find(w);
+    if(it != pythonCalcs.end()) {
+        if(it.value().source == calcQString) return &it.value();
+        releasePythonCalc(w);
+    }
+
+    // the interpreter stays initialized for all displays
+    if(!Py_IsInitialized()) Py_Initialize();
+
+    PyObject *pGlobal = PyDict_New();
+    PyDict_SetItemString( pGlobal, "__builtins__", PyEval_GetBuiltins() );
+
+    // get rid of %P/ and last / on new line
+    QString source = calcQString.mid(3, calcQString.length()-4);
+
+    //Create a new module object
+    QString myModule("myModule"+w->objectName());
+    PyObject *pNewMod = PyModule_New((char*) qasc(myModule));
+
+    PyModule_AddStringConstant(pNewMod, "__file__", "");
+
+    //Get the dictionary object from my module
+    PyObject *pLocal = PyModule_GetDict(pNewMod);
+
+    //Define my function in the newly created module, when error then we get a null pointer back
+    PyObject *pValue = PyRun_String(qasc(source), Py_file_input, pGlobal, pLocal);
+    Py_DECREF(pGlobal);
+    if(pValue == (PyObject *) 0) {
+        Python_Error(w, "probably a syntax error on the python function (calc will be disabled)");
+        Py_DECREF(pNewMod);
+        return (pythonCalc *) 0;
+    }
+    Py_DECREF(pValue);
+
+    //Get a pointer to the function I just defined
+    PyObject *pFunc = PyObject_GetAttrString(pNewMod, "PythonCalc");
+    if((pFunc == (PyObject *) 0) || (!PyCallable_Check(pFunc))) {
+        Python_Error(w, "python function not found, must be called PythonCalc (calc will be disabled)");
+        Py_XDECREF(pFunc);
+        Py_DECREF(pNewMod);
+        return (pythonCalc *) 0;
+    }
+
+    pythonCalc calc;
+    calc.source = calcQString;
+    calc.module = pNewMod;
+    calc.function = pFunc;
+    calc.arguments = PyTuple_New(MAXMONITORS);
+    for(int i=0; i< MAXMONITORS; i++) PyTuple_SetItem(calc.arguments, i, PyFloat_FromDouble(0.0));
+
+    return &pythonCalcs.insert(w, calc).value();
+}
+#endif
+
+/**
+ * release the compiled python function of a widget
+ */
+void CaQtDM_Lib::releasePythonCalc(QWidget *w)
+{
+#ifdef PYTHON
+    QHash<QWidget*, pythonCalc>::iterator it = pythonCalcs.find(w);
+    if(it == pythonCalcs.end()) return;
+    Py_XDECREF(it.value().arguments);
+    Py_XDECREF(it.value().function);
+    Py_XDECREF(it.value().module);
+    pythonCalcs.erase(it);
+#else
+    Q_UNUSED(w);
+#endif
+}
+
 /**
   * routine used by the above routine for calculating the visibilty of our objects
   */
@@ -3831,13 +4007,6 @@ bool CaQtDM_Lib::CalcVisibility(QWidget *w, double &result, bool &valid)
             // python function
         } else if(calcQString.startsWith("%P/")) {
 
-            Py_Initialize();
-#define MAXMONITORS 4
-            PyObject *pArgs, *pValue, *pValueA[MAX_CALC_INPUTS], *pFunc;
-            PyObject *pGlobal = PyDict_New();
-            PyObject *pLocal;
-
-            for(int i=0; i < MAXMONITORS; i++) valueArray[i] = 0.0;
             for(int i=0; i< nbMonitors;i++) {
                 knobData *ptr = mutexKnobDataP->GetMutexKnobDataPtr(MonitorList.at(i+1).toInt());
                 if(ptr == (knobData*) 0) {
@@ -3846,43 +4015,14 @@ bool CaQtDM_Lib::CalcVisibility(QWidget *w, double &result, bool &valid)
                 }
             }
 
-            PyDict_SetItemString( pGlobal, "__builtins__", PyEval_GetBuiltins() );
-
-            // get rid of %P/ and last / on new line
-            calcQString = calcQString.mid(3, calcQString.length()-4);
-
-            char newCalc[2048];
-            strcpy(newCalc, qasc(calcQString));
-
-            //Create a new module object
-            QString myModule("myModule"+w->objectName());
-            PyObject *pNewMod = PyModule_New((char*) qasc(myModule));
-
-            PyModule_AddStringConstant(pNewMod, "__file__", "");
-
-            //Get the dictionary object from my module
-            pLocal = PyModule_GetDict(pNewMod);
-
-            //Define my function in the newly created module, when error then we get a null pointer back
-            pValue = PyRun_String(qasc(calcQString), Py_file_input, pGlobal, pLocal);
-            if(pValue == (PyObject *) 0) {
-                valid = false;
-                Py_DECREF(pNewMod);
-                return Python_Error(w, "probably a syntax error on the python function (calc will be disabled)");
-            }
-            Py_DECREF(pValue);
-
-            //Get a pointer to the function I just defined
-            pFunc = PyObject_GetAttrString(pNewMod, "PythonCalc");
-            if((pFunc == (PyObject *) 0) || (!PyCallable_Check(pFunc))) {
+            // compiled only once, an error disables the calc
+            pythonCalc *calc = getPythonCalc(w, calcQString);
+            if(calc == (pythonCalc *) 0) {
                 valid = false;
-                Py_DECREF(pNewMod);
-                return Python_Error(w, "python function not found, must be called PythonCalc (calc will be disabled)");
+                return true;
             }
 
-            //Build a tuple to hold my arguments (just the number 4 in this case)
-            pArgs = PyTuple_New(MAXMONITORS);
-            for(int i=0; i< MAXMONITORS; i++) pValueA[i] = PyFloat_FromDouble(0.0);
+            for(int i=0; i < MAXMONITORS; i++) valueArray[i] = 0.0;
             for(int i=0; i< nbMonitors; i++) {
                 knobData *ptr = mutexKnobDataP->GetMutexKnobDataPtr(MonitorList.at(i+1).toInt());
                 if(ptr != (knobData*) 0) {
@@ -3893,27 +4033,27 @@ bool CaQtDM_Lib::CalcVisibility(QWidget *w, double &result, bool &valid)
                     } else {
                         valueArray[j] = 0.0;
                     }
-                    pValueA[i] = PyFloat_FromDouble(valueArray[i]);
                 }
             }
-            for(int i=0; i < MAXMONITORS; i++)  PyTuple_SetItem(pArgs, i, pValueA[i]);
 
-            //Call my function, passing it the number four
-            pValue = PyObject_CallObject(pFunc, pArgs);
+            // the argument tuple is reused, unless the function kept a reference to it
+            if(Py_REFCNT(calc->arguments) > 1) {
+                Py_DECREF(calc->arguments);
+                calc->arguments = PyTuple_New(MAXMONITORS);
+            }
+            for(int i=0; i < MAXMONITORS; i++)  PyTuple_SetItem(calc->arguments, i, PyFloat_FromDouble(valueArray[i]));
+
+            PyObject *pValue = PyObject_CallObject(calc->function, calc->arguments);
             if (pValue != (PyObject *) 0) {
                 result = PyFloat_AsDouble(pValue);
                 Py_DECREF(pValue);
-                Py_DECREF(pArgs);
-                Py_XDECREF(pFunc);
-                Py_DECREF(pNewMod);
                 valid = true;
             } else {
                 result = 0.0;
                 valid = false;
-                Py_DECREF(pArgs);
-                Py_XDECREF(pFunc);
-                Py_DECREF(pNewMod);
-                return Python_Error(w, "some error in the python function (calc will be disabled)");
+                bool status = Python_Error(w, "some error in the python function (calc will be disabled)");
+                releasePythonCalc(w);
+                return status;
             }
 
             return visible;
@@ -4147,7 +4287,6 @@ void CaQtDM_Lib::Callback_UpdateWidget(int indx, QWidget *w,
                                        const QString& String,
                                        const knobData& data)
 {
-    Q_UNUSED(indx);
     Q_UNUSED(fec);
 
     if(!AllowsUpdate) return;
@@ -5362,10 +5501,15 @@ void CaQtDM_Lib::Callback_UpdateWidget(int indx, QWidget *w,
             } else if(data.specData[0] == 10) { // value4 if present
                 cameraWidget->dataProcessing(data.edata.rvalue, 3);
             } else if(data.specData[0] == 0) { // data channel
+                // ndarray channels deliver the geometry and color mode with the image
+                if(data.edata.imageWidth > 0) CameraGeometry(cameraWidget, data);
                 QMutex *datamutex;
                 datamutex = (QMutex*) data.mutex;
                 datamutex->lock();
-                cameraWidget->showImage(data.edata.dataSize, (char*) data.edata.dataB, data.edata.fieldtype);
+                // the camera copies the frame it shows
+                if(arrayCurrent(data)) {
+                    cameraWidget->showImage(data.edata.dataSize, (char*) data.edata.dataB, data.edata.fieldtype);
+                }
                 datamutex->unlock();
             } else if(data.specData[0] == 15) {
                 if(data.edata.valueCount > 0 && data.edata.dataB != (void*) 0) {
@@ -5417,8 +5561,13 @@ void CaQtDM_Lib::Callback_UpdateWidget(int indx, QWidget *w,
                 scan2dWidget->dataProcessing(data.edata.rvalue, 2); break;
             case 21: // value4 if present
                 scan2dWidget->dataProcessing(data.edata.rvalue, 3); break;
-            case 0: // data channel
-                scan2dWidget->newArray(data.edata.dataSize, (float*) data.edata.dataB); break;
+            case 0: { // data channel
+                QMutex *datamutex = (QMutex*) data.mutex;
+                datamutex->lock();
+                if(arrayCurrent(data)) scan2dWidget->newArray(data.edata.dataSize, (float*) data.edata.dataB);
+                datamutex->unlock();
+            }
+                break;
             default: // ?
                 break;
             }
@@ -5458,11 +5607,25 @@ void CaQtDM_Lib::Callback_UpdateWidget(int indx, QWidget *w,
     }
 }
 
+// to be called with the data mutex locked: the array signaled is still the one of the channel. a plugin
+// handing over its own buffers may have released it for a newer one meanwhile, which is signaled anyway
+bool CaQtDM_Lib::arrayCurrent(const knobData &data)
+{
+    if(data.edata.dataB == (void*) 0) return false;
+    knobData *kPtr = mutexKnobDataP->GetMutexKnobDataPtr(data.index);
+    if(kPtr == (knobData *) 0) return false;
+    return (kPtr->edata.dataB == data.edata.dataB) && (kPtr->edata.dataSize == data.edata.dataSize);
+}
+
 void CaQtDM_Lib::Cartesian(caCartesianPlot *widget, int curvNB, int curvType, int XorY, const knobData &data)
 {
     QMutex *datamutex;
     datamutex = (QMutex*) data.mutex;
     datamutex->lock();
+    if(!arrayCurrent(data)) {
+        datamutex->unlock();
+        return;
+    }
     switch(data.edata.fieldtype) {
     case caFLOAT: {
         float* P = (float*) data.edata.dataB;
@@ -5517,6 +5680,10 @@ void CaQtDM_Lib::CameraWaveform(caCamera *widget, int curvNB, int curvType, int
     QMutex *datamutex;
     datamutex = (QMutex*) data.mutex;
     datamutex->lock();
+    if(!arrayCurrent(data)) {
+        datamutex->unlock();
+        return;
+    }
     switch(data.edata.fieldtype) {
     case caFLOAT: {
         float* P = (float*) data.edata.dataB;
@@ -5560,11 +5727,40 @@ void CaQtDM_Lib::CameraWaveform(caCamera *widget, int curvNB, int curvType, int
     }
 }
 
+void CaQtDM_Lib::CameraGeometry(caCamera *widget, const knobData &data)
+{
+    caCamera::colormode mode;
+    switch(data.edata.imageColorMode) {
+    case imageBayer: {
+        static const caCamera::colormode bayer8[4] = {caCamera::BayerRG_8, caCamera::BayerGB_8, caCamera::BayerGR_8, caCamera::BayerBG_8};
+        static const caCamera::colormode bayer12[4] = {caCamera::BayerRG_12, caCamera::BayerGB_12, caCamera::BayerGR_12, caCamera::BayerBG_12};
+        int pattern = qBound(0, (int) data.edata.imageBayerPattern, 3);
+        mode = (data.edata.fieldtype == caCHAR) ? bayer8[pattern] : bayer12[pattern];
+    }
+        break;
+    case imageRGB1: mode = caCamera::RGB1_CA; break;
+    case imageRGB2: mode = caCamera::RGB2_CA; break;
+    case imageRGB3: mode = caCamera::RGB3_CA; break;
+    case imageYUV444: mode = caCamera::YUV444; break;
+    case imageYUV422: mode = caCamera::YUV422; break;
+    case imageYUV421: mode = caCamera::YUV421; break;
+    default: mode = caCamera::Mono; break;
+    }
+    // setting the mode reinitializes the image, so only when it changes
+    if(widget->getColormode() != mode) widget->setDecodemodeNum((int) mode);
+    widget->setWidth(data.edata.imageWidth);
+    widget->setHeight(data.edata.imageHeight);
+}
+
 void CaQtDM_Lib::WaveTable(caWaveTable *widget, const knobData &data)
 {
     QMutex *datamutex;
     datamutex = (QMutex*) data.mutex;
     datamutex->lock();
+    if(!arrayCurrent(data)) {
+        datamutex->unlock();
+        return;
+    }
 
     switch(data.edata.fieldtype) {
     case caFLOAT: {
@@ -5609,6 +5805,10 @@ void CaQtDM_Lib::WaterFall(caWaterfallPlot *widget, const knobData &data)
     QMutex *datamutex;
     datamutex = (QMutex*) data.mutex;
     datamutex->lock();
+    if(!arrayCurrent(data)) {
+        datamutex->unlock();
+        return;
+    }
     switch(data.edata.fieldtype) {
     case caFLOAT: {
         float* P = (float*) data.edata.dataB;
@@ -6232,7 +6432,7 @@ void CaQtDM_Lib::closeEvent(QCloseEvent* ce)
             //qDebug() << pv << "clear monitor at" << i << "index="  << kData.index << "plugin" << kData.pluginName;
             if(soft) {
                 mutexKnobDataP->RemoveSoftPV(pv, w, kData.index);
-            } else {
+            } else if(!deferredMonitors.contains(i)) {
                ControlsInterface * plugininterface = getControlInterface(kData.pluginName);
                if(plugininterface != (ControlsInterface *) 0) plugininterface->pvClearMonitor(&kData);
             }
@@ -6252,7 +6452,7 @@ void CaQtDM_Lib::closeEvent(QCloseEvent* ce)
         if(kPtr != (knobData *) 0) {
             if(myWidget == (QWidget*) kPtr->thisW) {
                 ControlsInterface * plugininterface = getControlInterface(kPtr->pluginName);
-                if(plugininterface != (ControlsInterface *) 0) plugininterface->pvFreeAllocatedData(kPtr);
+                if((plugininterface != (ControlsInterface *) 0) && !deferredMonitors.contains(i)) plugininterface->pvFreeAllocatedData(kPtr);
                 kPtr->thisW = (void*) 0;
                 if(kPtr->mutex != (QMutex *) 0) {
                     QMutex *mutex = (QMutex *) kPtr->mutex;
@@ -6263,6 +6463,10 @@ void CaQtDM_Lib::closeEvent(QCloseEvent* ce)
         }
     }
     mutexKnobDataP->initHighestCountPV();
+    deferredMonitors.clear();
+
+    // compiled python functions
+    foreach(QWidget *w, pythonCalcs.keys()) releasePythonCalc(w);
 
     // in case of network launcher, close the application when launcher window is closed
     QString thisFileName =  property("fileString").toString().section('/',-1);
@@ -7888,7 +8092,7 @@ void CaQtDM_Lib::TreatRequestedWave(QString pvo, QString text, caWaveTable::Form
     datamutex->unlock();
 }
 
-int CaQtDM_Lib::parseForDisplayRate(QString &inputc, int &rate)
+int CaQtDM_Lib::parseForDisplayRate(QString &inputc, int &rate, int *queueSize, int *pipeline)
 {
     // Parse data
     bool success = false;
@@ -7904,55 +8108,60 @@ int CaQtDM_Lib::parseForDisplayRate(QString &inputc, int &rate)
         //printf("failed to parse <%s>\n", input);
     } else {
         // Retrieve the main object
-        JSONObject root;
-        if(!value->IsObject()) {
-            //printf("The root element is not an object");
-            delete(value);
-        } else {
-
-            root = value->AsObject();
+        if(value->IsObject()) {
+            JSONObject root = value->AsObject();
             // check for monitor
             if (root.find(L"caqtdm_monitor") != root.end() && root[L"caqtdm_monitor"]->IsObject()) {
-
                 //printf("monitor detected\n");
-                // Retrieve nested object
-                JSONValue *value1 = JSON::Parse(root[L"caqtdm_monitor"]->Stringify().c_str());
-                // Did it go wrong?
-                if ((value1 != NULL) && value1->IsObject()) {
-                    JSONObject root;
-                    root = value1->AsObject();
-                    if (root.find(L"maxdisplayrate") != root.end() && root[L"maxdisplayrate"]->IsNumber()) {
-                        int status;
-                        //printf("maxdisplayrate detected\n");
-                        status = swscanf(root[L"maxdisplayrate"]->Stringify().c_str(), L"%d", &rate);
-                        if(status != 1) return false;
-                        //printf("%d decode value=%d\n", status, rate);
-                        delete(value1);
-                        delete(value);
-                        success = true;
-                    } else {
-                        delete(value1);
-                        delete(value);
-                    }
-                } else {
-                    delete(value);
+                JSONObject monitor = root[L"caqtdm_monitor"]->AsObject();
+                if (monitor.find(L"maxdisplayrate") != monitor.end() && monitor[L"maxdisplayrate"]->IsNumber()) {
+                    rate = (int) monitor[L"maxdisplayrate"]->AsNumber();
+                    success = true;
+                }
+                // monitor queue size and flow control, used by the pva plugin
+                if (monitor.find(L"queuesize") != monitor.end() && monitor[L"queuesize"]->IsNumber()) {
+                    if(queueSize != (int *) 0) *queueSize = (int) monitor[L"queuesize"]->AsNumber();
+                    success = true;
+                }
+                if (monitor.find(L"pipeline") != monitor.end() && monitor[L"pipeline"]->IsBool()) {
+                    if(pipeline != (int *) 0) *pipeline = monitor[L"pipeline"]->AsBool() ? 1 : 0;
+                    success = true;
                 }
             }
-
         }
+        delete(value);
     }
 
     // we have to take this json string out of the global json string given for epics 3.15 and higher
-    // get rid of first { and last }
+    // remove the caqtdm_monitor object with its separating comma
     // in the call we append the resulting string to the pv
     if((inputc.at(0) == '{') && (inputc.at(inputc.length()-1) == '}')) {
-        QStringList items = inputc.split(",", QString::SkipEmptyParts);
-        int pos = items.indexOf(QRegExp("*caqtdm_monitor*", Qt::CaseInsensitive, QRegExp::Wildcard), 0);
-        if(pos != -1) items.removeAt(pos);  // pos==-1 should never happen
-        inputc = "{" + items.join(",") + "}";
+        int pos = inputc.indexOf("\"caqtdm_monitor\"", 0, Qt::CaseInsensitive);
+        if(pos != -1) {
+            int end = inputc.indexOf('{', pos);
+            int depth = 0;
+            while(end != -1 && end < inputc.length()) {
+                if(inputc.at(end) == '{') depth++;
+                else if(inputc.at(end) == '}' && --depth == 0) break;
+                end++;
+            }
+            if(end != -1 && end < inputc.length()) {
+                end++;
+                int after = end;
+                while(after < inputc.length() && inputc.at(after).isSpace()) after++;
+                int before = pos - 1;
+                while(before > 0 && inputc.at(before).isSpace()) before--;
+                if(after < inputc.length() && inputc.at(after) == ',') {
+                    end = after + 1;
+                    while(end < inputc.length() && inputc.at(end).isSpace()) end++;
+                } else if(before > 0 && inputc.at(before) == ',') {
+                    pos = before;
+                }
+                inputc.remove(pos, end - pos);
+            }
+        }
     }
 
-
     return success;
 }
 
@@ -8341,6 +8550,7 @@ void CaQtDM_Lib::grabSwipeGesture(Qt::GestureType fingerSwipeGestureTypeID)
 void CaQtDM_Lib::resizeEvent ( QResizeEvent * event )
 {
     double factX, factY;
+    DisplayTrace::Scope trace(firstResize ? "first resize" : "resize", "display", thisFileShort);
 
     //qDebug() << "resize" << event->size();
     QMainWindow *main = this->findChild<QMainWindow *>();
@@ -41,6 +41,7 @@
 #include <QMutex>
 #include <QFile>
 #include <QMap>
+#include <QPointer>
 #include <QtGui>
 #include <QtUiTools>
 #include <QWhatsThis>
@@ -68,6 +69,7 @@
 #include "MessageWindow.h"
 #include "messageWindowWrapper.h"
 #include "JSON.h"
+#include "macroengine.h"
 #include "limitsStripplotDialog.h"
 #include "limitsCartesianplotDialog.h"
 #include "limitsDialog.h"
@@ -283,21 +285,36 @@ private:
     void TreatRequestedWave(QString pv, QString text, caWaveTable::FormatType fType, int index, QWidget *w);
     void TreatOrdinaryValue(QString pv, double value, int32_t idata, QString svalue, QWidget *w);
     bool getSoftChannel(QString pv, knobData &data);
-    int parseForDisplayRate(QString &input, int &rate);
+    int parseForDisplayRate(QString &input, int &rate, int *queueSize = 0, int *pipeline = 0);
     void getStatesToggleAndLed(QWidget *widget, const knobData &data, const QString &String, Qt::CheckState &state);
 
     void resizeSpecials(QString className, QWidget *widget, QVariantList list, double factX, double factY);
     void shellCommand(QString command);
 
+    bool arrayCurrent(const knobData &data);
     void WaterFall(caWaterfallPlot *widget, const knobData &data);
     void Cartesian(caCartesianPlot *widget, int curvNB, int curvType, int XorY, const knobData &data);
     void CameraWaveform(caCamera *widget, int curvNB, int curvType, int XorY, const knobData &data);
+    void CameraGeometry(caCamera *widget, const knobData &data);
     void WaveTable(caWaveTable *widget, const knobData &data);
     void EnableDisableIO();
     void UpdateMeter(caMeter *widget, const knobData &data);
     bool SoftPVusesItsself(QWidget* widget, QMap<QString, QString> map);
     void setCalcToNothing(QWidget* widget);
     bool Python_Error(QWidget *w, QString message);
+
+    // compiled python function of a widget with its argument tuple (PyObject)
+    struct pythonCalc {
+        QString source;
+        struct _object *module;
+        struct _object *function;
+        struct _object *arguments;
+    };
+    QHash<QWidget*, pythonCalc> pythonCalcs;
+#ifdef PYTHON
+    pythonCalc *getPythonCalc(QWidget *w, const QString &calcQString);
+#endif
+    void releasePythonCalc(QWidget *w);
     void FlushAllInterfaces();
     void CartesianPlotsVerticalAlign();
     void StripPlotsVerticalAlign();
@@ -341,6 +358,7 @@ private:
 #endif
 
     QMap<QString, QString> createMap(const QString&);
+    QMap<QString, QString> macroContext(const QString&);
     QString createMacroStringFromMap(QMap<QString, QString> map);
     QMap<QString, QString> actualizeMacroMap();
     QString actualizeMacroString(QMap<QString, QString> map, QString argument);
@@ -348,6 +366,21 @@ private:
     QString thisFileShort;
     QString thisFileFull;
 
+    // special macros and macro maps, computed once while opening the display
+    QMap<QString, QString> internalMacros;
+    QHash<QString, QMap<QString, QString> > macroContexts;
+    MacroEngine macroEngine;
+
+    // lazy activation of hidden widgets, knobdata index -> widget for the channels not yet created;
+    // guarded, an include may delete its widgets before they were shown
+    bool isDeferred(QWidget *w);
+    void activateWidgets();
+    void addMonitorInfo(QWidget *w, knobData *kData);
+    bool lazyActivation;
+    int prefetchPages;
+    QMap<int, QPointer<QWidget> > deferredMonitors;
+    qint64 includeLoadTime;
+
     bool firstResize;
     bool allowResize;
     bool pepPrint;
@@ -0,0 +1,160 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2014
+ *
+ *  Author:
+ *    Anton Mezger
+ *  Contact details:
+ *    anton.mezger@psi.ch
+ */
+
+
+#include <QFile>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QElapsedTimer>
+#include <QCoreApplication>
+#include <stdio.h>
+#include "displaytrace.h"
+
+struct traceEvent {
+    const char *name;
+    const char *category;
+    QString detail;
+    qint64 start;
+    qint64 duration;
+    quint64 thread;
+};
+
+static bool traceEnabled = false;
+static QString traceFile;
+static QElapsedTimer traceClock;
+static QMutex traceMutex;
+static QList<traceEvent> traceEvents;
+
+static void writeTraceAtExit()
+{
+    DisplayTrace::write();
+}
+
+void DisplayTrace::enable(const QString &fileName)
+{
+    QMutexLocker locker(&traceMutex);
+    if(traceEnabled) return;
+    traceFile = fileName;
+    traceClock.start();
+    traceEnabled = true;
+    qAddPostRoutine(writeTraceAtExit);
+    printf("caQtDM -- display open trace will be written to <%s>\n", qPrintable(fileName));
+}
+
+bool DisplayTrace::isEnabled()
+{
+    return traceEnabled;
+}
+
+// microseconds since tracing was enabled
+qint64 DisplayTrace::now()
+{
+#if QT_VERSION >= QT_VERSION_CHECK(4, 8, 0)
+    return traceClock.nsecsElapsed() / 1000;
+#else
+    return traceClock.elapsed() * 1000;
+#endif
+}
+
+void DisplayTrace::record(const char *name, const char *category, const QString &detail, qint64 start, qint64 duration)
+{
+    traceEvent event;
+    event.name = name;
+    event.category = category;
+    event.detail = detail;
+    event.start = start;
+    event.duration = duration;
+    event.thread = (quint64) (quintptr) QThread::currentThreadId();
+
+    QMutexLocker locker(&traceMutex);
+    traceEvents.append(event);
+}
+
+static QString jsonString(const QString &text)
+{
+    QString escaped;
+    escaped.reserve(text.size() + 2);
+    escaped.append('"');
+    for(int i = 0; i < text.size(); i++) {
+        QChar c = text.at(i);
+        if(c == QChar('"')) escaped.append("\\\"");
+        else if(c == QChar('\\')) escaped.append("\\\\");
+        else if(c.unicode() < 0x20) escaped.append(QString("\\u%1").arg((int) c.unicode(), 4, 16, QChar('0')));
+        else escaped.append(c);
+    }
+    escaped.append('"');
+    return escaped;
+}
+
+void DisplayTrace::write()
+{
+    QMutexLocker locker(&traceMutex);
+    if(!traceEnabled) return;
+
+    QFile file(traceFile);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        printf("caQtDM -- trace file <%s> could not be written\n", qPrintable(traceFile));
+        return;
+    }
+
+    qint64 pid = QCoreApplication::applicationPid();
+    file.write("{\"traceEvents\":[\n");
+    for(int i = 0; i < traceEvents.count(); i++) {
+        const traceEvent &event = traceEvents.at(i);
+        QString line = QString("{\"name\":%1,\"cat\":%2,\"ph\":\"X\",\"ts\":%3,\"dur\":%4,\"pid\":%5,\"tid\":%6,\"args\":{\"detail\":%7}}")
+                .arg(jsonString(event.name)).arg(jsonString(event.category)).arg(event.start).arg(event.duration)
+                .arg(pid).arg(event.thread).arg(jsonString(event.detail));
+        if(i < traceEvents.count() - 1) line.append(",");
+        line.append("\n");
+        file.write(line.toUtf8());
+    }
+    file.write("],\"displayTimeUnit\":\"ms\"}\n");
+    file.close();
+}
+
+DisplayTrace::Scope::Scope(const char *name, const char *category, const QString &detail)
+{
+    Running = traceEnabled;
+    if(!Running) return;
+    Name = name;
+    Category = category;
+    Detail = detail;
+    Start = DisplayTrace::now();
+}
+
+void DisplayTrace::Scope::end()
+{
+    if(!Running) return;
+    Running = false;
+    DisplayTrace::record(Name, Category, Detail, Start, DisplayTrace::now() - Start);
+}
+
+QWidget *DisplayTraceLoader::createWidget(const QString &className, QWidget *parent, const QString &name)
+{
+    DisplayTrace::Scope trace("createWidget", "load", DisplayTrace::isEnabled() ? className + " " + name : QString());
+    return QUiLoader::createWidget(className, parent, name);
+}
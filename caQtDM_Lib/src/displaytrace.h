@@ -0,0 +1,78 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2014
+ *
+ *  Author:
+ *    Anton Mezger
+ *  Contact details:
+ *    anton.mezger@psi.ch
+ */
+
+
+#ifndef DISPLAYTRACE_H
+#define DISPLAYTRACE_H
+
+#include <QString>
+#include <QWidget>
+#include <QUiLoader>
+#include "caQtDM_Lib_global.h"
+
+// tracing of the opening of displays (loading, widget setup, monitors, includes, first resize)
+// enabled with -trace file on the command line; the scopes are recorded as complete events of the
+// chrome trace event format and written to the file after every display opened and at exit, the
+// file can be loaded into chrome://tracing or perfetto. when not enabled a scope costs a test.
+
+class CAQTDM_LIBSHARED_EXPORT DisplayTrace
+{
+public:
+    static void enable(const QString &fileName);
+    static bool isEnabled();
+
+    // write all events recorded so far
+    static void write();
+
+    // records the time from its creation to end() or its destruction
+    class CAQTDM_LIBSHARED_EXPORT Scope
+    {
+    public:
+        Scope(const char *name, const char *category, const QString &detail = QString());
+        ~Scope() { end(); }
+        void end();
+
+    private:
+        const char *Name;
+        const char *Category;
+        QString Detail;
+        qint64 Start;
+        bool Running;
+    };
+
+private:
+    static qint64 now();
+    static void record(const char *name, const char *category, const QString &detail, qint64 start, qint64 duration);
+};
+
+// ui loader recording the creation of every widget when tracing
+class DisplayTraceLoader : public QUiLoader
+{
+public:
+    DisplayTraceLoader(QObject *parent = 0) : QUiLoader(parent) {}
+    virtual QWidget *createWidget(const QString &className, QWidget *parent = 0, const QString &name = QString());
+};
+
+#endif // DISPLAYTRACE_H
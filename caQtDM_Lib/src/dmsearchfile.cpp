@@ -25,6 +25,7 @@
 
 #include <QString>
 #include "dmsearchfile.h"
+#include "displaypathindex.h"
 #include <QDebug>
 
 dmsearchFile::dmsearchFile(QString filename)
@@ -35,39 +36,9 @@ dmsearchFile::dmsearchFile(QString filename)
 QString dmsearchFile::findFile()
 {
     if(_FileName.isNull()) return NULL;
-      QString path = (QString) qgetenv("CAQTDM_DISPLAY_PATH");
-#ifdef _MSC_VER
-    QStringList paths = path.split(";");
-#else
-    QStringList paths = path.split(":");
-#endif
-    // first search in current directory
-    QString FileName = _FileName;
-    bool fileFound = false;
-    QFileInfo fi(FileName);
 
-    // file was not found, go through path list
-    if(!fi.exists()) {
-       for(int i=0; i< paths.count(); i++) {
-           FileName = paths[i] + "/" + _FileName;
-           QFileInfo fi(FileName);
-           if(fi.exists()) {
-             fileFound = true;
-             break;
-           }
-        }
-
-    // file was found in current directory
-    } else {
-        fileFound = true;
-    }
-
-    // return filename or null
-    if(fileFound) {
-        //printf("dmsearchFile %s\n", FileName.toAscii().constData());
-        return FileName;
-    }
-    else return NULL;
+    // the current directory and then the path list, answered from the index of the display path
+    return displayPathIndex::instance()->find(_FileName);
 }
 
 QString dmsearchFile::displayPath()
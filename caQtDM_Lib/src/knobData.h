@@ -70,9 +70,15 @@ typedef struct _epicsData {
     void         *dataPtr;
     int          initialize;            /* first initialisation */
     char         aux[10];               /* used for acs controlsystem images */
+    int          imageWidth;            /* image width when the channel delivers its geometry (ndarray), else 0 */
+    int          imageHeight;           /* image height when the channel delivers its geometry */
+    short        imageColorMode;        /* color mode of these images (imageColorMode) */
+    short        imageBayerPattern;     /* bayer pattern of these images (0 RGGB, 1 GBRG, 2 GRBG, 3 BGGR) */
     struct timeb lastTime;              /* last displayed time */
     struct timeb actTime;               /* receive time */
     int          repRate;               /* repetition rate for this channel, default will be 5Hz */
+    int          queueSize;             /* monitor queue size given with caqtdm_monitor, 0 for the default */
+    int          pipeline;              /* monitor with flow control given with caqtdm_monitor */
 } epicsData;
 
 typedef struct _knobData {
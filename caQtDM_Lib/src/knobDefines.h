@@ -51,6 +51,9 @@ typedef char pv_desc[MAXPVDESC];
 
 enum caType {caSTRING = 0, caINT = 1, caFLOAT = 2, caENUM = 3, caCHAR = 4, caLONG = 5, caDOUBLE = 6};
 
+// color modes of images delivered with their geometry, numbered like the areaDetector NDColorMode
+enum imageColorMode {imageMono = 0, imageBayer = 1, imageRGB1 = 2, imageRGB2 = 3, imageRGB3 = 4, imageYUV444 = 5, imageYUV422 = 6, imageYUV421 = 7};
+
 // not really used, now just inserted as property in the widgets, not used elsewhere
 enum objectType {caCalc_Widget = 0,
                  caLabel_Widget,
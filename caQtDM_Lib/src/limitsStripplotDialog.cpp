@@ -66,8 +66,12 @@ limitsStripplotDialog::limitsStripplotDialog(caStripPlot *w, MutexKnobData *data
     move(parent->x() + parent->width() / 2 - thisWidth / 2 , parent->y() + parent->height() /2 -thisHeight/2);
 #endif
 
-    int MAXCURVES = caStripPlot::MAXCURVES;
-    for(int i=0; i< qMin(vars.size(), MAXCURVES); i++) {
+    minComboBox.fill((QComboBox *) 0, vars.size());
+    maxComboBox.fill((QComboBox *) 0, vars.size());
+    minLineEdit.fill((QLineEdit *) 0, vars.size());
+    maxLineEdit.fill((QLineEdit *) 0, vars.size());
+
+    for(int i=0; i< qMin(vars.size(), StripPlot->getCurveCount()); i++) {
         QString pv = vars.at(i).trimmed();
         if(pv.size() > 0) {
             QLabel *channelLabel = new QLabel(pv);
@@ -152,7 +156,7 @@ void limitsStripplotDialog::applyClicked()
 
     for(int i=0; i< qMin(vars.size(), nbMonitors); i++) {
         QString pv = vars.at(i).trimmed();
-        if(pv.size() > 0) {
+        if(pv.size() > 0 && minComboBox[i] != (QComboBox *) 0) {
 
             knobData *ptr = monData->GetMutexKnobDataPtr(list.at(i+1).toInt());
             if(ptr == (knobData *) 0) break;
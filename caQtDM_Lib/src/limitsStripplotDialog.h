@@ -32,6 +32,7 @@
 #include <QGridLayout>
 #include <QDialogButtonBox>
 #include <QList>
+#include <QVector>
 #include <QLabel>
 #include <QPushButton>
 #include <QPair>
@@ -75,10 +76,10 @@
      virtual void paintEvent(QPaintEvent *e);
 
  private:
-     QComboBox *minComboBox[caStripPlot::MAXCURVES];
-     QComboBox *maxComboBox[caStripPlot::MAXCURVES];
-     QLineEdit *minLineEdit[caStripPlot::MAXCURVES];
-     QLineEdit *maxLineEdit[caStripPlot::MAXCURVES];
+     QVector<QComboBox *> minComboBox;
+     QVector<QComboBox *> maxComboBox;
+     QVector<QLineEdit *> minLineEdit;
+     QVector<QLineEdit *> maxLineEdit;
      QComboBox *YaxisType;
      QComboBox *YaxisScaling;
      QStringList vars;
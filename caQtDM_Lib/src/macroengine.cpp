@@ -0,0 +1,244 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2014
+ *
+ *  Author:
+ *    Anton Mezger
+ *  Contact details:
+ *    anton.mezger@psi.ch
+ */
+
+
+#include <QRegExp>
+#include "macroengine.h"
+#include "JSON.h"
+
+// macro maps kept at the same time, the oldest one is dropped when more are used
+#define MAXMACROSETS 32
+
+MacroEngine::MacroEngine()
+{
+    current = -1;
+}
+
+void MacroEngine::clear()
+{
+    templates.clear();
+    sets.clear();
+    current = -1;
+}
+
+void MacroEngine::setMacros(const QMap<QString, QString> &map)
+{
+    // comparing maps sharing their data is immediate
+    if(current >= 0 && sets.at(current).map == map) return;
+
+    for(int i = 0; i < sets.count(); i++) {
+        if(sets.at(i).map == map) {
+            current = i;
+            return;
+        }
+    }
+
+    if(sets.count() >= MAXMACROSETS) sets.removeFirst();
+
+    MacroSet set;
+    set.map = map;
+    QMap<QString, QString>::const_iterator i;
+    for(i = map.constBegin(); i != map.constEnd(); ++i) set.values.insert(i.key(), i.value());
+    sets.append(set);
+    current = sets.count() - 1;
+}
+
+QString MacroEngine::expand(const QString &text, QList<Message> *messages)
+{
+    if(current < 0 || !text.contains("$(")) return text;
+
+    QHash<QString, QString>::const_iterator it = sets.at(current).results.constFind(text);
+    if(it != sets.at(current).results.constEnd()) return it.value();
+
+    QStringList active;
+    QString result = expandText(text, active, messages);
+    sets[current].results.insert(text, result);
+    return result;
+}
+
+/**
+ * split a text in literal and macro segments, the segments of a text are kept
+ */
+const MacroEngine::Template &MacroEngine::tokenize(const QString &text)
+{
+    QHash<QString, Template>::const_iterator it = templates.constFind(text);
+    if(it != templates.constEnd()) return it.value();
+
+    Template segments;
+    QString literal;
+    int pos = 0;
+    while(pos < text.length()) {
+        Segment segment;
+        int end;
+        int start = text.indexOf("$(", pos);
+        if(start < 0) {
+            literal.append(text.mid(pos));
+            break;
+        }
+        literal.append(text.mid(pos, start - pos));
+
+        // an unterminated macro is only text
+        if(!parseMacro(text, start, segment, end)) {
+            literal.append(text.mid(start));
+            break;
+        }
+        if(!literal.isEmpty()) {
+            Segment literalSegment;
+            literalSegment.text = literal;
+            segments.append(literalSegment);
+            literal.clear();
+        }
+        segments.append(segment);
+        pos = end;
+    }
+    if(!literal.isEmpty()) {
+        Segment literalSegment;
+        literalSegment.text = literal;
+        segments.append(literalSegment);
+    }
+
+    return templates.insert(text, segments).value();
+}
+
+/**
+ * parse the macro starting at start, end is set behind the macro
+ */
+bool MacroEngine::parseMacro(const QString &text, int start, Segment &segment, int &end) const
+{
+    int depth = 0;
+    for(int i = start + 2; i < text.length(); i++) {
+        QChar c = text.at(i);
+        if(c == QChar('$') && (i + 1) < text.length() && text.at(i + 1) == QChar('(')) {
+            segment.nested = true;
+            depth++;
+            i++;
+        } else if(c == QChar(')')) {
+            if(depth == 0) {
+                segment.macro = true;
+                segment.text = text.mid(start + 2, i - start - 2);
+                end = i + 1;
+                return true;
+            }
+            depth--;
+        } else if(c == QChar('{') && depth == 0) {
+            // the regular expression may contain parentheses, it ends with })
+            int close = text.indexOf("})", i);
+            if(close < 0) return false;
+            segment.macro = true;
+            segment.text = text.mid(start + 2, i - start - 2);
+            segment.json = text.mid(i, close - i + 1);
+            end = close + 2;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * expand a text, active contains the macros being expanded for detecting cycles
+ */
+QString MacroEngine::expandText(const QString &text, QStringList &active, QList<Message> *messages)
+{
+    if(!text.contains("$(")) return text;
+
+    // copied, the template hash may grow while expanding
+    const Template segments = tokenize(text);
+    const QHash<QString, QString> &values = sets.at(current).values;
+
+    QString result;
+    for(int i = 0; i < segments.count(); i++) {
+        const Segment &segment = segments.at(i);
+        if(!segment.macro) {
+            result.append(segment.text);
+            continue;
+        }
+
+        QString name = segment.text;
+        if(segment.nested) name = expandText(name, active, messages);
+
+        QHash<QString, QString>::const_iterator it = values.constFind(name);
+        if(it == values.constEnd() || active.contains(name)) {
+            if(it != values.constEnd() && messages != (QList<Message> *) 0) {
+                messages->append(Message(QtWarningMsg, QString("macro %1 is defined by itsself (%2)").arg(name).arg(active.join("->"))));
+            }
+            result.append("$(" + name + segment.json + ")");
+            continue;
+        }
+
+        active.append(name);
+        QString value = expandText(it.value(), active, messages);
+        active.removeLast();
+
+        if(segment.json.isEmpty()) result.append(value);
+        else result.append(applyRegex(name, value, segment.json, messages));
+    }
+    return result;
+}
+
+/**
+ * replace in a macro value the parts matching the regular expression of the macro
+ */
+QString MacroEngine::applyRegex(const QString &name, const QString &value, const QString &json, QList<Message> *messages) const
+{
+    QString macro_regex = "";
+    QString macro_value = "Parsing Error";
+    bool macro_value_found = false;
+
+    JSONObject jsonobj;
+    JSONValue *MacroDataJ = JSON::Parse(json.toStdString().c_str());
+    if(MacroDataJ != NULL) {
+        if(MacroDataJ->IsObject()) {
+            jsonobj = MacroDataJ->AsObject();
+            if(jsonobj.find(L"regex") != jsonobj.end() && jsonobj[L"regex"]->IsString()) {
+                macro_regex = QString::fromWCharArray(jsonobj[L"regex"]->AsString().c_str());
+            }
+            if(jsonobj.find(L"value") != jsonobj.end() && jsonobj[L"value"]->IsString()) {
+                macro_value = QString::fromWCharArray(jsonobj[L"value"]->AsString().c_str());
+                macro_value_found = true;
+            }
+        }
+        delete(MacroDataJ);
+    } else if(messages != (QList<Message> *) 0) {
+        messages->append(Message(QtWarningMsg, QString("JSON Error in (%1)").arg(json)));
+    }
+
+    QRegExp rx_json;
+    rx_json.setPattern(macro_regex);
+    if(!rx_json.isValid()) return "$(" + name + json + ")";
+
+    if(!macro_value_found) {
+        if(messages != (QList<Message> *) 0) {
+            messages->append(Message(QtWarningMsg, QString("No Replacement found do simple(%1) (%2) macro resolution").arg(name).arg(value)));
+        }
+        return value;
+    }
+
+    QString replaceWith = value;
+    replaceWith.replace(rx_json, macro_value);
+    if(messages != (QList<Message> *) 0) {
+        messages->append(Message(QtDebugMsg, QString("Replace (%1) (%2) with (%3) Regex:(%4)").arg(name).arg(value).arg(macro_value).arg(macro_regex)));
+    }
+    return replaceWith;
+}
@@ -0,0 +1,91 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2014
+ *
+ *  Author:
+ *    Anton Mezger
+ *  Contact details:
+ *    anton.mezger@psi.ch
+ */
+
+
+#ifndef MACROENGINE_H
+#define MACROENGINE_H
+
+#include <QString>
+#include <QMap>
+#include <QHash>
+#include <QList>
+#include <QVector>
+#include <QStringList>
+
+// substitution of macros $(NAME) in a text with the values of a macro map
+// a text is split only once into literal and macro segments; the names are looked up in a hash
+// and the values are expanded recursively (a value may contain macros and also the name of a
+// macro may be composed of macros), a macro depending on itself is left unresolved.
+// macros with a regular expression $(NAME{"regex":"...","value":"..."}) replace with value the
+// parts of the macro value matching regex.
+// the results are kept for every macro map and text, a map equal to the last one used is found
+// without comparing its content when it is shared with it.
+
+class MacroEngine
+{
+public:
+    struct Message {
+        Message(QtMsgType t, const QString &s) : type(t), text(s) {}
+        QtMsgType type;
+        QString text;
+    };
+
+    MacroEngine();
+
+    // macro map used for the following expansions
+    void setMacros(const QMap<QString, QString> &map);
+
+    // text with its macros replaced, unresolved macros are left in the text
+    QString expand(const QString &text, QList<Message> *messages);
+
+    void clear();
+
+private:
+    struct Segment {
+        Segment() : macro(false), nested(false) {}
+        bool macro;
+        bool nested;   // name contains macros
+        QString text;  // literal text or name of the macro
+        QString json;  // regular expression specification of the macro
+    };
+    typedef QVector<Segment> Template;
+
+    struct MacroSet {
+        QMap<QString, QString> map;
+        QHash<QString, QString> values;
+        QHash<QString, QString> results;
+    };
+
+    const Template &tokenize(const QString &text);
+    bool parseMacro(const QString &text, int start, Segment &segment, int &end) const;
+    QString expandText(const QString &text, QStringList &active, QList<Message> *messages);
+    QString applyRegex(const QString &name, const QString &value, const QString &json, QList<Message> *messages) const;
+
+    QHash<QString, Template> templates;
+    QList<MacroSet> sets;
+    int current;
+};
+
+#endif // MACROENGINE_H
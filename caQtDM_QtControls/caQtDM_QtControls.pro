@@ -60,6 +60,10 @@ SOURCES	+= \
     src/cagraphics.cpp \
     src/capolyline.cpp \
     src/searchfile.cpp \
+    src/uifilecache.cpp \
+    src/displayimage.cpp \
+    src/displayimagebuilder.cpp \
+    src/displaypathindex.cpp \
     src/elabel.cpp \
     src/esimplelabel.cpp \
     src/fontscalingwidget.cpp \
@@ -104,10 +108,11 @@ SOURCES	+= \
     src/cascriptbutton.cpp \
     src/cadoubletabwidget.cpp \
     src/stripplotthread.cpp \
+    src/stripplotcurves.cpp \
+    src/accumulatedseries.cpp \
     src/cawaterfallplot.cpp \
     src/snumeric.cpp \
     src/caspinbox.cpp \
-    src/qwtplotcurvenan.cpp \
     src/cawavetable.cpp \
     src/specialFunctions.cpp \
     src/caclock.cpp \
@@ -138,11 +143,11 @@ XDR_HACK {
 }
 
 QT += network
-HEADERS += src/networkaccess.h src/fileFunctions.h \
+HEADERS += src/fileFunctions.h src/fileprefetcher.h \
     src/calinedraw.h \
     src/wmsignalpropagator.h \
     src/replacemacro.h
-SOURCES += src/networkaccess.cpp src/fileFunctions.cpp
+SOURCES += src/fileFunctions.cpp src/fileprefetcher.cpp
 
 
 contains(QWT_VER_MIN, 0) {
@@ -161,6 +166,9 @@ HEADERS	+= \
     src/cagraphics.h \
     src/capolyline.h \
     src/searchfile.h \
+    src/uifilecache.h \
+    src/displayimage.h \
+    src/displaypathindex.h \
     src/elabel.h \
     src/esimplelabel.h \
     src/fontscalingwidget.h \
@@ -207,10 +215,12 @@ HEADERS	+= \
     src/cascriptbutton.h \
     src/cadoubletabwidget.h \
     src/stripplotthread.h \
+    src/ringbuffer.h \
+    src/stripplotcurves.h \
+    src/accumulatedseries.h \
     src/cawaterfallplot.h \
     src/snumeric.h \
     src/caspinbox.h \
-    src/qwtplotcurvenan.h \
     src/cawavetable.h \
     src/capolylinedialog.h \
     src/specialFunctions.h \
@@ -0,0 +1,156 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2014
+ *
+ *  Author:
+ *    Anton Mezger
+ *  Contact details:
+ *    anton.mezger@psi.ch
+ */
+
+#if defined(_MSC_VER)
+#define NOMINMAX
+#include <float.h>
+#define QWT_DLL
+#if (_MSC_VER == 1600)
+  #define INFINITY (DBL_MAX+DBL_MAX)
+  #define NAN (INFINITY-INFINITY)
+#endif
+#endif
+
+#include <math.h>
+#include "accumulatedseries.h"
+
+AccumulationStore::AccumulationStore()
+{
+    PointMode = BothValues;
+    Seq = 0;
+    Xs.reset(1, 0.0);
+    Ys.reset(1, 0.0);
+}
+
+void AccumulationStore::clear()
+{
+    Xs.clear(0.0);
+    Ys.clear(0.0);
+    AxisX.values.clear();
+    AxisX.positives.clear();
+    AxisY.values.clear();
+    AxisY.positives.clear();
+}
+
+void AccumulationStore::setCapacity(int capacity)
+{
+    capacity = qMax(capacity, 1);
+    if(capacity == Xs.capacity()) return;
+
+    if(capacity < Xs.count()) {
+        Xs.reset(capacity, 0.0);
+        Ys.reset(capacity, 0.0);
+        clear();
+        return;
+    }
+
+    // the sequence numbers of the extrema stay valid, only the rings are copied
+    RingBuffer<double> xs(Xs), ys(Ys);
+    Xs.reset(capacity, 0.0);
+    Ys.reset(capacity, 0.0);
+    for(int i = xs.count() - 1; i >= 0; i--) {
+        Xs.push(xs.at(i));
+        Ys.push(ys.at(i));
+    }
+}
+
+void AccumulationStore::setAxes(bool xLog, bool xAuto, bool yLog, bool yAuto)
+{
+    AxisX.log = xLog;
+    AxisX.autoscale = xAuto;
+    AxisY.log = yLog;
+    AxisY.autoscale = yAuto;
+}
+
+void AccumulationStore::append(double x, double y)
+{
+    Xs.push(x);
+    Ys.push(y);
+
+    Seq++;
+    const qint64 oldest = Seq - Xs.count() + 1;
+    AxisX.values.add(Seq, x, x);
+    AxisX.positives.add(Seq, (x > 0.0) ? x : NAN, NAN);
+    AxisY.values.add(Seq, y, y);
+    AxisY.positives.add(Seq, (y > 0.0) ? y : NAN, NAN);
+    AxisX.values.expire(oldest);
+    AxisX.positives.expire(oldest);
+    AxisY.values.expire(oldest);
+    AxisY.positives.expire(oldest);
+}
+
+// lowest value a logarithmic axis can display
+double AccumulationStore::Axis::floor() const
+{
+    if(!autoscale) return 1.e-20;
+    if(positives.hasMinimum()) return positives.minimum();
+    return 1.0;
+}
+
+// same replacement of invalid values as done for the other plots in setSamplesData
+double AccumulationStore::Axis::map(double value) const
+{
+    if(log) {
+        if(qIsNaN(value) || value <= 0.0) return floor();
+    } else if(qIsNaN(value) && values.hasMinimum()) {
+        return values.minimum();
+    }
+    return value;
+}
+
+QPointF AccumulationStore::point(int i) const
+{
+    const int slot = Xs.count() - 1 - i;
+    double x = (PointMode == IndexAsX) ? (double) i : AxisX.map(Xs.at(slot));
+    double y = (PointMode == IndexAsY) ? (double) i : AxisY.map(Ys.at(slot));
+    return QPointF(x, y);
+}
+
+QRectF AccumulationStore::boundingRect() const
+{
+    double minX, maxX, minY, maxY;
+
+    if(Xs.count() < 1) return QRectF(1.0, 1.0, -2.0, -2.0);
+
+    if(PointMode == IndexAsX) {
+        minX = 0.0;
+        maxX = Xs.count() - 1;
+    } else {
+        if(!AxisX.values.hasMinimum()) return QRectF(1.0, 1.0, -2.0, -2.0);
+        minX = AxisX.log ? AxisX.floor() : AxisX.values.minimum();
+        maxX = qMax(minX, AxisX.values.maximum());
+    }
+
+    if(PointMode == IndexAsY) {
+        minY = 0.0;
+        maxY = Ys.count() - 1;
+    } else {
+        if(!AxisY.values.hasMinimum()) return QRectF(1.0, 1.0, -2.0, -2.0);
+        minY = AxisY.log ? AxisY.floor() : AxisY.values.minimum();
+        maxY = qMax(minY, AxisY.values.maximum());
+    }
+
+    return QRectF(minX, minY, maxX - minX, maxY - minY);
+}
@@ -0,0 +1,94 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2014
+ *
+ *  Author:
+ *    Anton Mezger
+ *  Contact details:
+ *    anton.mezger@psi.ch
+ */
+
+#ifndef ACCUMULATEDSERIES_H
+#define ACCUMULATEDSERIES_H
+
+#include <QPointF>
+#include <QRectF>
+#include <qwt_series_data.h>
+#include <qtcontrols_global.h>
+#include "ringbuffer.h"
+
+// points of a cartesian plot accumulated from scalar monitors, kept in a ring so that
+// adding a point is O(1); the extrema of the window are maintained while adding, so that
+// autoscaling does not have to run over all points at every update
+
+class QTCON_EXPORT AccumulationStore
+{
+public:
+    // x or y may be replaced by the index of the point (x only or y only curves)
+    enum Mode {BothValues = 0, IndexAsX, IndexAsY};
+
+    AccumulationStore();
+
+    void clear();
+    int capacity() const { return Xs.capacity(); }
+    int count() const { return Xs.count(); }
+
+    // a smaller capacity clears the points, a bigger one keeps them
+    void setCapacity(int capacity);
+    void setMode(Mode mode) { PointMode = mode; }
+
+    // logarithmic axes need positive values, the floor is used when not autoscaling
+    void setAxes(bool xLog, bool xAuto, bool yLog, bool yAuto);
+
+    void append(double x, double y);
+
+    // i = 0 gives the oldest point
+    QPointF point(int i) const;
+    QRectF boundingRect() const;
+
+private:
+    struct Axis {
+        Axis() : log(false), autoscale(true) {}
+        double floor() const;
+        double map(double value) const;
+        bool log, autoscale;
+        SlidingExtrema values;
+        SlidingExtrema positives;
+    };
+
+    RingBuffer<double> Xs, Ys;
+    Axis AxisX, AxisY;
+    Mode PointMode;
+    qint64 Seq;
+};
+
+// view of an accumulation store handed to a qwt curve, the store is not owned
+class QTCON_EXPORT AccumulatedSeries : public QwtSeriesData<QPointF>
+{
+public:
+    AccumulatedSeries(const AccumulationStore *store) : Store(store) {}
+
+    virtual size_t size() const { return Store->count(); }
+    virtual QPointF sample(size_t i) const { return Store->point((int) i); }
+    virtual QRectF boundingRect() const { return Store->boundingRect(); }
+
+private:
+    const AccumulationStore *Store;
+};
+
+#endif // ACCUMULATEDSERIES_H
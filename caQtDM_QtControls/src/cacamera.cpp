@@ -1633,6 +1633,15 @@ void caCamera::buf_unpack_12bitpacked_lsb(void* target, void* source, size_t des
     }
 }
 
+// copy of the frame shown, the data of the channel may be released after this update while
+// the intensity under the mouse and the profiles still read it
+char *caCamera::keepFrame(char *data, int datasize)
+{
+    if(savedFrame.size() != datasize) savedFrame.resize(datasize);
+    memcpy(savedFrame.data(), data, (size_t) datasize);
+    return savedFrame.data();
+}
+
 QImage *caCamera::showImageCalc(int datasize, char *data, short datatype)
 {
     QSize resultSize;
@@ -1714,7 +1723,7 @@ QImage *caCamera::showImageCalc(int datasize, char *data, short datatype)
     case RGB1_CA:
     case RGB2_CA:
     case RGB3_CA:
-        savedData = data;
+        savedData = keepFrame(data, datasize);
         CameraDataConvert = &caCamera::CameraDataConvert;
         break;
     case BayerRG_8:
@@ -1818,7 +1827,7 @@ QImage *caCamera::showImageCalc(int datasize, char *data, short datatype)
 
     case YUV421:
     default:
-        savedData = data;
+        savedData = keepFrame(data, datasize);
         //printf("not yet supported colormode = %s\n", qasc(colorModeString.at(thisColormode)));
         QPainter painter(image);
         QBrush brush(QColor(200,200,200,255), Qt::SolidPattern);
@@ -307,6 +307,7 @@ private:
     QVarLengthArray<double> Y;
 
     void buf_unpack_12bitpacked_lsb(void* target, void* source, size_t destcount, size_t targetcount);
+    char *keepFrame(char *data, int datasize);
     void buf_unpack_12bitpacked_msb(void* target, void* source, size_t destcount, size_t targetcount);
 
     template <typename pureData>
@@ -374,6 +375,7 @@ private:
     int savedWidth;
     int savedHeight;
     char *savedData;
+    QByteArray savedFrame;
     int bitsPerElement;
 
     uint minvalue, maxvalue;
@@ -29,9 +29,13 @@
 #define QWT_DLL
 #endif
 
+#include <math.h>
 #include "cacartesianplot.h"
 #include <QtCore>
 
+#define SMALLEST -1.e20
+#define BIGGEST 1.e20
+
 #if QWT_VERSION >= 0x060100
 class PlotScaleDateEngine: public QwtDateScaleEngine
 {
@@ -157,6 +161,7 @@ caCartesianPlot::caCartesianPlot(QWidget *parent) : QwtPlot(parent)
 
     thisToBeTriggered = false;
     thisTriggerNow = true;
+    thisZoomed = false;
     thisCountNumber = 0;
     thisXaxisSyncGroup = 0;
     thisXticks = 5;
@@ -216,9 +221,17 @@ caCartesianPlot::caCartesianPlot(QWidget *parent) : QwtPlot(parent)
    zoomer->setMousePattern(QwtEventPattern::MouseSelect5,Qt:: NoButton);
    zoomer->setMousePattern(QwtEventPattern::MouseSelect6,Qt:: NoButton);
 
+    // large curves are decimated for the visible range, so recompute when zooming or panning
+    connect(zoomer, SIGNAL(zoomed(const QRectF &)), this, SLOT(updateDecimation()));
+    connect(panner, SIGNAL(panned(int, int)), this, SLOT(updateDecimation()));
+    connect(zoomer, SIGNAL(zoomed(const QRectF &)), this, SLOT(zoomChanged()));
+    connect(panner, SIGNAL(panned(int, int)), this, SLOT(zoomChanged()));
+
     // curves
     for(int i=0; i < curveCount; i++) {
         thisPV[i]=QStringList();
+        decimated[i] = false;
+        accumulating[i] = false;
         curve[i].setLegendAttribute(QwtPlotCurve::LegendShowLine, true);
         curve[i].setItemAttribute(QwtPlotItem::Legend, false);
         curve[i].setStyle(QwtPlotCurve::Lines);
@@ -301,10 +314,12 @@ void caCartesianPlot::updateLegendsPV() {
 void caCartesianPlot::resetZoom() {
     double minX, maxX, minY, maxY;
 
+    thisZoomed = false;
     if(getXLimits(minX, maxX)) setScaleX(minX, maxX);
     if(getYLimits(minY, maxY)) setScaleY(minY, maxY);
     if(thisYscaling == Auto) setAxisAutoScale(yLeft, true);
     if(thisXscaling == Auto) setAxisAutoScale(xBottom, true);
+    updateDecimation();
     replot();
 }
 
@@ -356,8 +371,7 @@ void caCartesianPlot::erasePlots()
      for(int i=0; i < curveCount; i++) {
          X[i].clear();
          Y[i].clear();
-         accumulX[i].clear();
-         accumulY[i].clear();
+         accumul[i].clear();
          setSamplesData(i, X[i].data(), Y[i].data(), Y[i].size(), true);
      }
      replot();
@@ -501,69 +515,44 @@ void caCartesianPlot::displayData(int curvIndex, int curvType)
 
             // scalar scalar more than one point specified
             } else {
-                double *dataX, *dataY;
-                if(thisPlotMode == PlotNPointsAndStop) {
-                    //printf("when count reached then we stop plotting\n");
-
-                    if(accumulX[curvIndex].size() >= thisCountNumber) return;
-                } else {
-                    //printf("array size=%d wanted count=%d\n", accumulX[curvIndex].size(), thisCountNumber);
-
-                    if(accumulX[curvIndex].size() > thisCountNumber) {
-                        //printf("it seems that the count number changed and is less than before?\n");
-                        accumulX[curvIndex].clear();
-                        accumulY[curvIndex].clear();
-                    }
-                    //printf("accumulate until count, then shift down and add point\n");
-
-                    if(accumulX[curvIndex].size() >= thisCountNumber) {
-                        dataX = accumulX[curvIndex].data();
-                        dataY = accumulY[curvIndex].data();
-                        //shift and remove last point
-
-                        // shift the X array and remove last point from X array
-                        if(curvType == X_only) {
-                            for(int i=0; i < accumulX[curvIndex].size() -1; i++)  {
-                                dataX[i] = dataX[i+1];
-                            }
-                            accumulX[curvIndex].removeLast();
-
-                        // shift the Y array and remove last point from Y array
-                        } else if (curvType == Y_only) {
-                            for(int i=0; i < accumulX[curvIndex].size() -1; i++)  {
-                                dataY[i] = dataY[i+1];
-                            }
-                            accumulY[curvIndex].removeLast();
-
-                        // shift the two arrays and remove last point from both
-                        } else {
-                            for(int i=0; i < accumulX[curvIndex].size() -1; i++)  {
-                                dataX[i] = dataX[i+1];
-                                dataY[i] = dataY[i+1];
-                            }
-                            accumulX[curvIndex].removeLast();
-                            accumulY[curvIndex].removeLast();
-                        }
-                    }
+                AccumulationStore &store = accumul[curvIndex];
+                double x = X[curvIndex][0];
+                double y = Y[curvIndex][0];
+
+                // a smaller count clears the points, a bigger one keeps them
+                store.setCapacity(thisCountNumber);
+
+                // when count reached then we stop plotting, otherwise the oldest point is replaced
+                if(thisPlotMode == PlotNPointsAndStop && store.count() >= thisCountNumber) return;
+
+                // in case of autoscaling and you have infinite values, things will go wrong
+                if(thisXscaling == Auto && (x < SMALLEST || x > BIGGEST)) {
+                    setXscaling(User); setAxisScale(xBottom, -10.0, 10.0);
+                    x = qBound(SMALLEST, x, BIGGEST);
+                    printf("caCartesianPlot::displayData: infinite x value detected, scale set to -10 to 10\n");
+                    fflush(stdout);
                 }
-                dataX = X[curvIndex].data();
-                dataY = Y[curvIndex].data();
-
-                // add new point
-                if(curvType == X_only) {
-                    if(accumulX[curvIndex].size() < thisCountNumber)
-                        accumulY[curvIndex].append(accumulY[curvIndex].size());
-                    accumulX[curvIndex].append(dataX[0]);
-                } else if (curvType == Y_only) {
-                    if(accumulX[curvIndex].size() < thisCountNumber)
-                        accumulX[curvIndex].append(accumulX[curvIndex].size());
-                    accumulY[curvIndex].append(dataY[0]);
-                } else {
-                    accumulX[curvIndex].append(dataX[0]);
-                    accumulY[curvIndex].append(dataY[0]);
+                if(thisYscaling == Auto && (y < SMALLEST || y > BIGGEST)) {
+                    setYscaling(User); setAxisScale(yLeft, -10.0, 10.0);
+                    y = qBound(SMALLEST, y, BIGGEST);
+                    printf("caCartesianPlot::displayData: infinite y value detected, scale set to -10 to 10\n");
+                    fflush(stdout);
                 }
 
-                setSamplesData(curvIndex, accumulX[curvIndex].data(), accumulY[curvIndex].data(), accumulY[curvIndex].size(), true);
+                if(curvType == X_only) store.setMode(AccumulationStore::IndexAsY);
+                else if(curvType == Y_only) store.setMode(AccumulationStore::IndexAsX);
+                else store.setMode(AccumulationStore::BothValues);
+                store.setAxes(thisXtype == log10, thisXscaling == Auto, thisYtype == log10, thisYscaling == Auto);
+                store.append(x, y);
+
+                // the curve reads the ring directly, log and nan replacement are done while reading
+                if(!accumulating[curvIndex]) {
+                    XSAVE[curvIndex].resize(0);
+                    YSAVE[curvIndex].resize(0);
+                    decimated[curvIndex] = false;
+                    curve[curvIndex].setData(new AccumulatedSeries(&store));
+                    accumulating[curvIndex] = true;
+                }
             }
 
         // x vector, y vector
@@ -580,13 +569,12 @@ void caCartesianPlot::displayData(int curvIndex, int curvType)
     }
 }
 
-#define SMALLEST -1.e20
-#define BIGGEST 1.e20
-
 // this routine will prevent that we have problems with negative values when logarithmic scale
 // and will keep the values in order to switch between log and linear scale
 void caCartesianPlot::setSamplesData(int index, double *x, double *y, int size, bool saveFlag)
 {
+    accumulating[index] = false;
+
     double lowX = BIGGEST;
     double lowY = BIGGEST;
     double lowX1 = BIGGEST;
@@ -666,13 +654,175 @@ void caCartesianPlot::setSamplesData(int index, double *x, double *y, int size,
                  if(qIsNaN(y[i])) YAUX[index][i] = lowY;
             }
         }
-        curve[index].setRawSamples(XAUX[index].data(), YAUX[index].data(), size);
+        setDecimatedSamples(index, XAUX[index].data(), YAUX[index].data(), size);
     }
     else {
         if(nanYpresent) for(int i=0; i< size; i++) if(qIsNaN(y[i])) y[i] = lowY1;
         if(nanXpresent) for(int i=0; i< size; i++) if(qIsNaN(x[i])) x[i] = lowX1;
+        setDecimatedSamples(index, x, y, size);
+    }
+}
+
+// decimation keeps the picture exact only for connected lines without symbols
+bool caCartesianPlot::decimationAllowed(int index)
+{
+    if(thisSymbol[index] != NoSymbol) return false;
+    switch (thisStyle[index]) {
+    case Lines:
+    case ThinLines:
+    case Sticks:
+    case Steps:
+    case FillUnder:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// curves with many more points than pixel columns are reduced to the first, last, minimum and
+// maximum point of every column (M4 aggregation), so that the drawing cost depends on the width
+// of the plot and not on the length of the waveform; the peaks are kept exactly.
+// this is only done for monotonic increasing x values, otherwise all points are given to qwt
+void caCartesianPlot::setDecimatedSamples(int index, double *x, double *y, int size)
+{
+    int columns = canvas()->contentsRect().width();
+    decimated[index] = false;
+
+    if(columns < 1 || size <= 4 * columns || !decimationAllowed(index)) {
         curve[index].setRawSamples(x, y, size);
+        return;
+    }
+
+    // visible x range, with autoscale the data range (x must be monotonic increasing)
+    double lowX, highX;
+    if(axisAutoScale(xBottom)) {
+        lowX = x[0];
+        highX = x[size-1];
+    } else {
+#if QWT_VERSION < 0x060100
+        lowX = axisScaleDiv(xBottom)->lowerBound();
+        highX = axisScaleDiv(xBottom)->upperBound();
+#else
+        lowX = axisScaleDiv(xBottom).lowerBound();
+        highX = axisScaleDiv(xBottom).upperBound();
+#endif
+        if(lowX > highX) qSwap(lowX, highX);
+    }
+
+    bool logarithmic = (thisXtype == log10);
+    if(logarithmic) {
+        if(lowX <= 0.0 || highX <= 0.0) {
+            curve[index].setRawSamples(x, y, size);
+            return;
+        }
+        lowX = ::log10(lowX);
+        highX = ::log10(highX);
+    }
+    if(!(highX > lowX)) {
+        curve[index].setRawSamples(x, y, size);
+        return;
+    }
+    double factor = (double) columns / (highX - lowX);
+
+    XDEC[index].resize(0);
+    YDEC[index].resize(0);
+
+    // points left and right of the visible range are collected in the columns -1 and columns
+    int column = -2;
+    int idx[5];
+    double previous = x[0];
+    for(int i=0; i <= size; i++) {
+        int col = column;
+        if(i < size) {
+            if(qIsNaN(x[i]) || x[i] < previous) {
+                curve[index].setRawSamples(x, y, size);
+                return;
+            }
+            previous = x[i];
+            double pos = logarithmic ? ::log10(x[i]) : x[i];
+            pos = (pos - lowX) * factor;
+            if(pos < 0.0) col = -1;
+            else if(pos >= columns) col = columns;
+            else col = (int) pos;
+
+            if(col == column) {
+                idx[1] = i;                                      // last
+                // minimum and maximum start with the first finite value of the column
+                if(!qIsNaN(y[i])) {
+                    if(qIsNaN(y[idx[2]]) || y[i] < y[idx[2]]) idx[2] = i;
+                    if(qIsNaN(y[idx[3]]) || y[i] > y[idx[3]]) idx[3] = i;
+                } else if(idx[4] < 0) {
+                    idx[4] = i;                                  // first gap
+                }
+                continue;
+            }
+        }
+
+        // column finished, add its points in their original order; a gap inside the column
+        // is kept as one NaN point, so that the line breaks there as without decimation
+        if(column > -2) {
+            int order[5];
+            int count = 0;
+            for(int j=0; j < 5; j++) {
+                if(idx[j] < 0) continue;
+                int k = count++;
+                while(k > 0 && order[k-1] > idx[j]) {
+                    order[k] = order[k-1];
+                    k--;
+                }
+                order[k] = idx[j];
+            }
+            int previousIndex = -1;
+            for(int j=0; j < count; j++) {
+                if(order[j] == previousIndex) continue;
+                XDEC[index].append(x[order[j]]);
+                YDEC[index].append(y[order[j]]);
+                previousIndex = order[j];
+            }
+        }
+        if(i < size) {
+            column = col;
+            idx[0] = idx[1] = idx[2] = idx[3] = i;
+            idx[4] = -1;
+        }
+    }
+
+    decimated[index] = true;
+    curve[index].setRawSamples(XDEC[index].data(), YDEC[index].data(), XDEC[index].size());
+}
+
+// the zoom stack is rebased with every new data, so the zoom is remembered until it gets reset
+void caCartesianPlot::zoomChanged()
+{
+    if(sender() == zoomer) thisZoomed = (zoomer->zoomRectIndex() > 0);
+    else thisZoomed = true;
+}
+
+bool caCartesianPlot::getZoomedX(double &minX, double &maxX)
+{
+    if(!thisZoomed) return false;
+#if QWT_VERSION < 0x060100
+    minX = axisScaleDiv(xBottom)->lowerBound();
+    maxX = axisScaleDiv(xBottom)->upperBound();
+#else
+    minX = axisScaleDiv(xBottom).lowerBound();
+    maxX = axisScaleDiv(xBottom).upperBound();
+#endif
+    return true;
+}
+
+// recompute the decimated curves after zooming, panning or resizing
+void caCartesianPlot::updateDecimation()
+{
+    bool changed = false;
+    int columns = canvas()->contentsRect().width();
+    for(int i=0; i < curveCount; i++) {
+        if(decimated[i] || (columns > 0 && XSAVE[i].size() > 4 * columns)) {
+            setSamplesData(i, XSAVE[i].data(), YSAVE[i].data(), qMin(XSAVE[i].size(), YSAVE[i].size()), false);
+            changed = true;
+        }
     }
+    if(changed) replot();
 }
 
 void caCartesianPlot::setTitlePlot(QString const &titel)
@@ -889,6 +1039,7 @@ void caCartesianPlot::setStyle_6(curvStyle s) { thisStyle[5] = s; setStyle(s, 5)
 void caCartesianPlot::resizeEvent ( QResizeEvent * event )
 {
     QwtPlot::resizeEvent(event);
+    if(event->size().width() != event->oldSize().width()) updateDecimation();
     for(int i=0; i<6; i++) {
         setSymbol(thisSymbol[i], i);
         if((thisStyle[i] != FillUnder) &&  (thisStyle[i] == FatDots)) {
@@ -1098,6 +1249,7 @@ void caCartesianPlot::setXaxisType(axisType s)
 
     for(int i=0; i < curveCount; i++) {
         if(XSAVE[i].size() > 0) setSamplesData(i, XSAVE[i].data(), YSAVE[i].data(), XSAVE[i].size(), false);
+        accumul[i].setAxes(thisXtype == log10, thisXscaling == Auto, thisYtype == log10, thisYscaling == Auto);
     }
     replot();
 }
@@ -1122,6 +1274,7 @@ void caCartesianPlot::setYaxisType(axisType s)
 
     for(int i=0; i < curveCount; i++) {
         if(XSAVE[i].size() > 0) setSamplesData(i, XSAVE[i].data(), YSAVE[i].data(), XSAVE[i].size(), false);
+        accumul[i].setAxes(thisXtype == log10, thisXscaling == Auto, thisYtype == log10, thisYscaling == Auto);
     }
 
     replot();
@@ -57,6 +57,7 @@
 
 #include <stdint.h>
 #include "caPropHandleDefs.h"
+#include "accumulatedseries.h"
 
 class QTCON_EXPORT caCartesianPlot : public QwtPlot
 {
@@ -408,6 +409,9 @@ public:
 
     void resetZoom();
 
+    // the x range shown when zoomed in or panned by the user, false when not zoomed
+    bool getZoomedX(double &minX, double &maxX);
+
     void setLegendAttribute(QColor c, QFont f, LegendAtttribute sw);
 
 public slots:
@@ -422,6 +426,10 @@ public slots:
 signals:
     void ShowContextMenu(const QPoint&);
 
+private slots:
+    void updateDecimation();
+    void zoomChanged();
+
 protected:
 
     void resizeEvent ( QResizeEvent * event);
@@ -454,8 +462,13 @@ private:
     QVarLengthArray<double> Y[curveCount], YSAVE[curveCount];
     QVarLengthArray<double> XAUX[curveCount], YAUX[curveCount];
 
-    QVarLengthArray<double> accumulX[curveCount];
-    QVarLengthArray<double> accumulY[curveCount];
+    // scalar scalar curves with a count accumulate their points in a ring
+    AccumulationStore accumul[curveCount];
+    bool accumulating[curveCount];
+
+    // curves reduced to the first, last, minimum and maximum point of every pixel column
+    QVarLengthArray<double> XDEC[curveCount], YDEC[curveCount];
+    bool decimated[curveCount];
 
     QwtPlotGrid *plotGrid;
     QPen penGrid;
@@ -467,11 +480,14 @@ private:
     void setScalesColor(QColor c);
     void setGridsColor(QColor c);
     void setSamplesData(int index, double *x, double *y, int size, bool saveFlag);
+    void setDecimatedSamples(int index, double *x, double *y, int size);
+    bool decimationAllowed(int index);
     bool eventFilter(QObject *obj, QEvent *event);
 
     QwtPlotZoomer* zoomer;
 
     bool thisTriggerNow;
+    bool thisZoomed;
 
     int thisXaxisSyncGroup;
 
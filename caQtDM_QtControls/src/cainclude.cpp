@@ -32,6 +32,7 @@
 #include "cainclude.h"
 #include "searchfile.h"
 #include "fileFunctions.h"
+#include "uifilecache.h"
 
 caInclude::caInclude(QWidget *parent) : QWidget(parent)
 {
@@ -354,16 +355,9 @@ void caInclude::setFileName(QString const &filename)
             int posY = 0;
             QWidget * loadedWidget = (QWidget *) 0;
             if(!fileName.contains(".prc")) {
-                // load new file
-                QFile *file = new QFile;
-                file->setFileName(fileNameFound);
-                file->open(QFile::ReadOnly);
-
+                // load new file, built from the template compiled only once for all includes
                 printf("effective load of file %s for widget %s\n", qasc(fileNameFound), qasc(this->objectName()));
-                QWidget *tmp = loader.load(file, thisParent);
-
-                file->close();
-                delete file;
+                QWidget *tmp = uiFileCache::instance()->load(&loader, fileNameFound, thisParent);
                 if(tmp == (QWidget*) 0) return;
                 thisLoadedWidgets.append(tmp);
                 loadedWidget = tmp;
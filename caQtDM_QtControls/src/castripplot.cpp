@@ -156,6 +156,11 @@ caStripPlot::caStripPlot(QWidget *parent): QwtPlot(parent)
     RestartPlot2 = false;
     ResizeFactorX = ResizeFactorY = 1.0;
     oldResizeFactorX = oldResizeFactorY = 1.0;
+    curvesType = TimeCurv;
+    curvesInterval = 0.0;
+    xOffset = 0.0;
+    historySeq = 0;
+    dataCount = 0;
 
 #ifdef QWT_USE_OPENGL
     printf("caStripplot uses opengl ?\n");
@@ -186,31 +191,18 @@ caStripPlot::caStripPlot(QWidget *parent): QwtPlot(parent)
     // define xaxis
     setXaxis(thisUnits,thisPeriod);
 
-    // define our curves
+    // one item draws all our curves
+    curvesItem = new StripplotCurvesItem(&history, &mutex);
+    curvesItem->setZ(10);
+    curvesItem->attach(this);
+
+    // define our curves, the first ones can be configured with the designer
+    setCurveCount(MAXCURVES);
     for(int i=0; i< MAXCURVES; i++) {
         curve[i] = new QwtPlotCurve();
-        errorcurve[i] = new QwtPlotIntervalCurveNaN();
-        fillcurve[i] = new QwtPlotCurveNaN();
         curve[i]->setZ(i);
-        fillcurve[i]->setZ(i);
-        errorcurve[i]->setZ(i+10);
-
-#if QWT_VERSION >= 0x060100
-        curve[i]->setRenderThreadCount( 0 ); // 0: use QThread::idealThreadCount()
-        fillcurve[i]->setRenderThreadCount( 0 );
-        errorcurve[i]->setRenderThreadCount( 0 );
-#endif
-        curve[i]->setPaintAttribute(QwtPlotCurve::ClipPolygons, true);
-        fillcurve[i]->setPaintAttribute(QwtPlotCurve::ClipPolygons, true);
-        errorcurve[i]->setPaintAttribute(QwtPlotIntervalCurve::ClipPolygons, true);
-
         curve[i]->attach(this);
-        errorcurve[i]->attach(this);
-        fillcurve[i]->attach(this);
         showCurve(i, false);
-
-        thisYaxisLimitsMax[i] = 100;
-        thisYaxisLimitsMin[i] = 0;
     }
 
     // default colors and styles
@@ -360,38 +352,20 @@ void caStripPlot::RescaleCurves(int width, units unit, double period)
         }
     }
 
-    if(!initCurves) return;
+    // the history must be able to hold all the data points we are going to collect
+    int historySize = qMax(MAXIMUMSIZE, HISTORY + SOMEMORE + 5);
+
+    if(!initCurves && historySize <= history.capacity() && history.curveCount() == getCurveCount()) return;
     initCurves = false;
 
     mutex.lock();
 
-    // initialize the arrays, with nan data
-    for(int i=0; i < MAXCURVES; i++) {
-        // define interval data for error and fill curves
-        rangeData[i].clear();
-        rangeData[i].reserve(MAXIMUMSIZE+5);
-        fillData[i].clear();
-        fillData[i].reserve(MAXIMUMSIZE+5);
-        if(i==0)  {
-            base.clear();
-            base.reserve(MAXIMUMSIZE+5);
-        }
-        for ( int j = 0; j <  MAXIMUMSIZE; j++ ) {
-            rangeData[i].append(QwtIntervalSample(0, QwtInterval(NAN, NAN)));
-            fillData[i].append(QPointF(NAN,NAN));
-            if(i==0) base.append(QwtIntervalSample(0, QwtInterval(NAN, NAN)));
-        }
-    }
-
-    // set the data to the curves
-    for(int i=0; i < NumberOfCurves; i++) {
-        if(thisStyle[i] == FillUnder) {
-            fillcurve[i]->setSamplesList(fillData[i]);
-            fillcurve[i]->setSamples(fillData[i]);
-        }
-        errorcurve[i]->setSamplesList(rangeData[i]);
-        errorcurve[i]->setSamples(rangeData[i]);
+    // initialize the history with nan data
+    history.reset(historySize, getCurveCount());
+    for(int i=0; i < extrema.size(); i++) {
+        extrema[i].clear();
     }
+    historySeq = 0;
 
     mutex.unlock();
 
@@ -477,28 +451,20 @@ QString caStripPlot::legendText(int i)
 void caStripPlot::defineCurves(QStringList titres, units unit, double period, int width, int nbCurves)
 {
     int min, max;
+    setCurveCount(nbCurves);
+    mutex.lock();
     NumberOfCurves = nbCurves;
+    mutex.unlock();
     scaleWidget->getBorderDistHint(min, max);
     savedTitres = titres;
 
     defineXaxis(unit, period);
 
-    // define curves
-    for(int i=0; i < MAXCURVES; i++) {
-        curvStyle s = Lines;
-        QColor c;
-
+    // define curves, the legend curves of unused curves are removed
+    for(int i=0; i < curve.size(); i++) {
         if(curve[i] != (QwtPlotCurve*) 0) {
-            s = getStyle(i);
-            c = getColor(i);
             delete curve[i];
-        }
-
-        if(errorcurve[i] != (QwtPlotIntervalCurveNaN*) 0) {
-            delete errorcurve[i];
-        }
-        if(fillcurve[i] != (QwtPlotCurve*) 0) {
-            delete fillcurve[i];
+            curve[i] = (QwtPlotCurve*) 0;
         }
 
         if(i < NumberOfCurves) {
@@ -506,18 +472,10 @@ void caStripPlot::defineCurves(QStringList titres, units unit, double period, in
             QString titre = legendText(i);
 
             curve[i] = new QwtPlotCurve(titre);
-            errorcurve[i] = new QwtPlotIntervalCurveNaN(titre+"?error?");
-            fillcurve[i] = new QwtPlotCurveNaN(titre+"?fill?");
-            setStyle(s, i);
+            setStyle(getStyle(i), i);
 
             curve[i]->setZ(i);
             curve[i]->attach(this);
-            fillcurve[i]->setZ(i);
-            fillcurve[i]->attach(this);
-            fillcurve[i]->setItemAttribute(QwtPlotItem::Legend, false);
-            errorcurve[i]->setZ(i+10);
-            errorcurve[i]->attach(this);
-            errorcurve[i]->setItemAttribute(QwtPlotItem::Legend, false);
 
             showCurve(i, false);
 
@@ -565,11 +523,8 @@ void caStripPlot::addText(double x, double y, char* text, QColor c, int fontsize
 // data collection done by timerthread
 void caStripPlot::TimeOutThread()
 {
-    int c, i;
+    int c;
     double elapsedTime = 0.0;
-    QwtIntervalSample tmp;
-    QPointF tmpP;
-    double value = 0.0;
     double interval=0.0;
 
     if(!timerID) return;
@@ -593,7 +548,7 @@ void caStripPlot::TimeOutThread()
     interval = INTERVAL;
 /*
     printf("dataCountLimit = %d datacount=%d history=%d interval=%f elapsed=%f siz=%d\n",
-           dataCountLimit, dataCount, HISTORY, interval, elapsedTime,  rangeData[0].size());
+           dataCountLimit, dataCount, HISTORY, interval, elapsedTime,  history.capacity());
 */
     // correct value to fit again inside the interval (only for the fixed scale)
     if(thisXaxisType == ValueScale) {
@@ -608,57 +563,27 @@ void caStripPlot::TimeOutThread()
         }
     }
 
-    // tell interval to base class nan
-    for (c = 0; c < NumberOfCurves; c++ ) {
-        if(thisXaxisType == ValueScale) {
-            fillcurve[c]->setInterval(ValueCurv, interval);
-            errorcurve[c]->setInterval(ValueCurv, interval);
-        } else {
-            fillcurve[c]->setInterval(TimeCurv, interval);
-            errorcurve[c]->setInterval(TimeCurv, interval);
-        }
+    // interval for the curves, given to them by the gui thread; for the fixed scale the curves are drawn
+    // relative to the actual time
+    curvesInterval = interval;
+    if(thisXaxisType == ValueScale) {
+        curvesType = ValueCurv;
+        xOffset = timeData;
+    } else {
+        curvesType = TimeCurv;
+        xOffset = 0.0;
     }
 
-    // shift data back
+    // advance the history of all curves, the older data stay in place
     if(dataCount > 1) {
-
-        // shift data and our timebase for the fixed scale
-        if(thisXaxisType == ValueScale) {
-            for (c = 0; c < NumberOfCurves; c++ ) {
-                // shift left and cur last
-                rangeData[c].prepend(tmp);
-                rangeData[c].erase(rangeData[c].end() - 1);
-                if(thisStyle[c] == FillUnder) {
-                    fillData[c].prepend(tmpP);
-                    fillData[c].erase(fillData[c].end() - 1);
-                }
-            }
-
-            base.prepend(tmp);
-            base.erase(base.end() - 1);
-
-            for (i = dataCount; i > 0; i-- ) {
-                value = base[i].value - timeData;
-                for (c = 0; c < NumberOfCurves; c++ ) {
-                    rangeData[c][i].value = value;
-                    fillData[c][i].setX(value);
-                }
-            }
-
-            // shift data
-        } else {
-            for (c = 0; c < NumberOfCurves; c++ ) {
-                rangeData[c].prepend(tmp);
-                if(thisStyle[c] == FillUnder) fillData[c].prepend(tmpP);
-                rangeData[c].erase(rangeData[c].end() - 1);
-                if(thisStyle[c] == FillUnder) fillData[c].erase(fillData[c].end() - 1);
-            }
-        }
-
+        history.advance();
+        historySeq++;
     }
 
     // update last point
-    for (c = 0; c < NumberOfCurves; c++ ) {
+    int nbCurves = qMin(NumberOfCurves, history.curveCount());
+    history.setTime(timeData);
+    for (c = 0; c < nbCurves; c++ ) {
         double valueMin = minVal[c];
         double valueMax = maxVal[c];
 
@@ -667,24 +592,18 @@ void caStripPlot::TimeOutThread()
             if(valueMax < 1.e-20) valueMax=1.e-20;
         }
 
-        QwtInterval tmpr;
-        tmpr.setMaxValue( valueMax);
-        tmpr.setMinValue( valueMin);
+        history.setRange(c, QwtInterval(valueMin, valueMax));
 
-        rangeData[c][0] = QwtIntervalSample( timeData, tmpr);
-        if(thisXaxisType == ValueScale) {
-            base[0] = QwtIntervalSample(timeData, tmpr);
-        }
-        if(thisStyle[c] == FillUnder) {
-            fillData[c][0] = QPointF(timeData, (valueMax+valueMin)/2);
-        }
+        // the newest point was overwritten and not added
+        if(dataCount <= 1) extrema[c].clear();
+        extrema[c].add(historySeq, valueMin, valueMax);
     }
 
     // advance data points
     if (dataCount < 2 && dataCount < dataCountLimit) dataCount++;
     else if(dataCount < dataCountLimit) {
         if(thisXaxisType == ValueScale) {
-            if(fillData[0][dataCount-1].x() > -interval) dataCount++;
+            if(history.time(dataCount-1) - xOffset > -interval) dataCount++;
         } else {
             if(elapsedTime < interval) dataCount++;
         }
@@ -701,12 +620,11 @@ void caStripPlot::TimeOutThread()
         AutoscaleMaxY = -INFINITY;
         AutoscaleMinY = INFINITY;
 
-        for (c = 0; c < NumberOfCurves; c++ ) {
-            for (int counter = 0; counter < dataCount; counter++) {
-                QwtIntervalSample P = rangeData[c].at(counter);
-                if(!qIsNaN(P.interval.maxValue()) && P.interval.maxValue() > AutoscaleMaxY) AutoscaleMaxY = P.interval.maxValue();
-                if(!qIsNaN(P.interval.minValue()) && P.interval.minValue() < AutoscaleMinY) AutoscaleMinY = P.interval.minValue();
-            }
+        // only the points inside the history count
+        for (c = 0; c < nbCurves; c++ ) {
+            extrema[c].expire(historySeq - dataCount + 1);
+            if(extrema[c].hasMaximum() && extrema[c].maximum() > AutoscaleMaxY) AutoscaleMaxY = extrema[c].maximum();
+            if(extrema[c].hasMinimum() && extrema[c].minimum() < AutoscaleMinY) AutoscaleMinY = extrema[c].minimum();
         }
 
         if(AutoscaleMaxY == AutoscaleMinY) {
@@ -774,24 +692,7 @@ void caStripPlot::TimeOut()
         setAxisScale(QwtPlot::xBottom, timeData - INTERVAL, timeData, INTERVAL/nbTicks);
     }
 
-    // set data into the curves
-    for (int c = 0; c < NumberOfCurves; c++ ) {
-        if(thisStyle[c] == FillUnder) {
-            fillcurve[c]->setSamplesList(fillData[c]);
-            fillcurve[c]->setSamples(fillData[c]);
-        }
-        errorcurve[c]->setSamplesList(rangeData[c]);
-        errorcurve[c]->setSamples(rangeData[c]);
-/*
-        if(c==0) {
-            printf("-----------------------\n");
-            for(int j=0; j!=rangeData[c].size();j++) {
-                printf("%d %f %f\n", j, rangeData[c][j].value, rangeData[c][j].interval.maxValue());
-                if(qIsNaN(rangeData[c][j].interval.maxValue())) break;
-            }
-        }
-*/
-    }
+    // the curves have a view on our history, so no data has to be set here
 
     // in case of autoscale adjust the vertical scale
     if(thisYaxisScaling == autoScale) {
@@ -811,10 +712,13 @@ void caStripPlot::TimeOut()
         oldResizeFactorY = ResizeFactorY;
     }
 
-    // replot
-    replot();
+    // the curves draw the history itself under the mutex
+    curvesItem->setInterval(curvesType, curvesInterval, xOffset);
 
     mutex.unlock();
+
+    // replot
+    replot();
 }
 
 void caStripPlot::setYscale(double ymin, double ymax) {
@@ -939,7 +843,7 @@ void caStripPlot::setLegendAttribute(QColor c, QFont f, LegendAtttribute SW)
 
 void caStripPlot::setData(struct timeb now, double Y, int curvIndex)
 {
-    if(curvIndex < 0 || curvIndex > (MAXCURVES-1)) return;
+    if(curvIndex < 0 || curvIndex >= getCurveCount()) return;
 
     mutex.lock();
 
@@ -969,10 +873,9 @@ void caStripPlot::setData(struct timeb now, double Y, int curvIndex)
 
 void caStripPlot::showCurve(int number, bool on)
 {
-    if(number < 0 || number > (MAXCURVES-1)) return;
-    curve[number]->setVisible(on);
-    fillcurve[number]->setVisible(on);
-    errorcurve[number]->setVisible(on);
+    if(number < 0 || number >= getCurveCount()) return;
+    if(curve[number] != (QwtPlotCurve *) 0) curve[number]->setVisible(on);
+    curvesItem->setCurveVisible(number, on);
     replot();
 }
 
@@ -1104,38 +1007,76 @@ void caStripPlot::setScaleColor(QColor c)
 
 void caStripPlot::setColor(QColor c, int number)
 {
-    if(number < 0 || number > (MAXCURVES-1)) return;
+    if(number < 0 || number >= getCurveCount()) return;
     thisLineColor[number] = c;
 
     if(curve[number] != (QwtPlotCurve *) 0) {
         curve[number]->setPen(QPen(c, 0));
     }
 
-    if(fillcurve[number] != (QwtPlotCurveNaN *) 0) {
-        fillcurve[number]->setPen(c);
-        fillcurve[number]->setBrush(QBrush(c, Qt::SolidPattern));
-        fillcurve[number]->setRenderHint( QwtPlotItem::RenderAntialiased, true );
-    }
-
-    if(errorcurve[number] != (QwtPlotIntervalCurveNaN *) 0) {
-        if(thisStyle[number] == FillUnder) {
-            errorcurve[number]->setPen(QPen(thisScaleColor,0));
-            errorcurve[number]->setBrush(QBrush(thisScaleColor, Qt::SolidPattern));
-        } else {
-            errorcurve[number]->setPen(QPen(c, 0));
-            errorcurve[number]->setBrush(QBrush(c, Qt::SolidPattern));
-        }
-        errorcurve[number]->setRenderHint( QwtPlotItem::RenderAntialiased, true);
-    }
+    setCurveStyle(number);
 }
 
 void caStripPlot::setStyle(curvStyle s, int number)
 {
-    if(number < 0 || number > (MAXCURVES-1)) return;
+    if(number < 0 || number >= getCurveCount()) return;
     thisStyle[number] = s;
     setColor(thisLineColor[number], number);
 }
 
+// the band between minimum and maximum gets the scale color when the curve is filled
+void caStripPlot::setCurveStyle(int number)
+{
+    if(thisStyle[number] == FillUnder) {
+        curvesItem->setCurveStyle(number, thisLineColor[number], thisScaleColor, true);
+    } else {
+        curvesItem->setCurveStyle(number, thisLineColor[number], thisLineColor[number], false);
+    }
+}
+
+// size the data of the curves, curves beyond the designer ones get distinct colors
+void caStripPlot::setCurveCount(int nbCurves)
+{
+    int oldCount = getCurveCount();
+    if(nbCurves <= oldCount) return;
+
+    mutex.lock();
+
+    curve.resize(nbCurves);
+    extrema.resize(nbCurves);
+    thisYaxisLimitsMax.resize(nbCurves);
+    thisYaxisLimitsMin.resize(nbCurves);
+    thisStyle.resize(nbCurves);
+    thisLineColor.resize(nbCurves);
+    thisYscalingMax.resize(nbCurves);
+    thisYscalingMin.resize(nbCurves);
+    maxVal.resize(nbCurves);
+    minVal.resize(nbCurves);
+    actVal.resize(nbCurves);
+    realVal.resize(nbCurves);
+    realMax.resize(nbCurves);
+    realMin.resize(nbCurves);
+    realTim.resize(nbCurves);
+
+    for(int i = oldCount; i < nbCurves; i++) {
+        curve[i] = (QwtPlotCurve *) 0;
+        thisYaxisLimitsMax[i] = 100;
+        thisYaxisLimitsMin[i] = 0;
+        thisStyle[i] = Lines;
+        thisLineColor[i] = QColor::fromHsv((i * 137) % 360, 255, 255);
+        thisYscalingMax[i] = thisYscalingMin[i] = Channel;
+        realMax[i] = maxVal[i] = -1000000;
+        realMin[i] = minVal[i] =  1000000;
+        actVal[i] = realVal[i] = NAN;
+        memset(&realTim[i], 0, sizeof(struct timeb));
+    }
+
+    curvesItem->setCurveCount(nbCurves);
+    for(int i = oldCount; i < nbCurves; i++) setCurveStyle(i);
+
+    mutex.unlock();
+}
+
 /**
  * eliminate stupid zero in value after the period
  */
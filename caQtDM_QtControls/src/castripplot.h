@@ -57,11 +57,11 @@
 #include <qnumeric.h>
 
 #include <stripplotthread.h>
+#include "ringbuffer.h"
+#include "stripplotcurves.h"
 
 class QwtPlotCurve;
 
-#include "qwtplotcurvenan.h"
-
 #ifdef QWT_USE_OPENGL
 #include <qevent.h>
 #include <qgl.h>
@@ -185,6 +185,7 @@ public:
 
     void noStyle(QString style) {Q_UNUSED(style);}
 
+    // number of curves that can be configured through the designer properties, any number of curves can be plotted
     enum {MAXCURVES = 7};
 
     enum cpuUsage {Low, Medium, High};
@@ -247,24 +248,34 @@ public:
     yAxisScaling getYaxisScaling() const {return thisYaxisScaling;}
     void setYaxisScaling(yAxisScaling s) {thisYaxisScaling = s;}
 
+    int getCurveCount() const {return thisLineColor.size();}
+
     void setColor(QColor c, int number);
-    QColor getColor(int number) const {return thisLineColor[number];}
+    QColor getColor(int number) const {
+      if(number < getCurveCount()) return thisLineColor[number]; else return thisLineColor[0];
+    }
 
     void setStyle(curvStyle s, int number);
-    curvStyle getStyle(int number) const {return thisStyle[number];}
+    curvStyle getStyle(int number) const {
+      if(number < getCurveCount()) return thisStyle[number]; else return thisStyle[0];
+    }
 
-    void setYscalingMax(axisScaling s, int number) {thisYscalingMax[number] = s;}
+    void setYscalingMax(axisScaling s, int number) {if(number < getCurveCount()) thisYscalingMax[number] = s;}
     axisScaling getYscalingMax(int number) const {
-      if(number < MAXCURVES) return thisYscalingMax[number]; else return thisYscalingMax[0];
+      if(number < getCurveCount()) return thisYscalingMax[number]; else return thisYscalingMax[0];
     }
 
-    void setYscalingMin(axisScaling s, int number) {thisYscalingMin[number] = s;}
+    void setYscalingMin(axisScaling s, int number) {if(number < getCurveCount()) thisYscalingMin[number] = s;}
     axisScaling getYscalingMin(int number) const {
-       if(number < MAXCURVES) return thisYscalingMin[number]; else return thisYscalingMin[0];
+       if(number < getCurveCount()) return thisYscalingMin[number]; else return thisYscalingMin[0];
     }
 
-    double getYaxisLimitsMin(int number) const {return thisYaxisLimitsMin[number];}
-    double getYaxisLimitsMax(int number) const {return thisYaxisLimitsMax[number];}
+    double getYaxisLimitsMin(int number) const {
+       if(number < getCurveCount()) return thisYaxisLimitsMin[number]; else return thisYaxisLimitsMin[0];
+    }
+    double getYaxisLimitsMax(int number) const {
+       if(number < getCurveCount()) return thisYaxisLimitsMax[number]; else return thisYaxisLimitsMax[0];
+    }
 
     void setYscale(double ymin, double ymax);
 
@@ -425,11 +436,11 @@ public:
     cpuUsage getUsageCPU() const {return thisUsageCPU;}
     void setUsageCPU(cpuUsage usage) {thisUsageCPU = usage; }
 
-    void setYaxisLimitsMax(int i, double const &newY) {if(i>= MAXCURVES) return; else thisYaxisLimitsMax[i] = newY;}
-    void setYaxisLimitsMin(int i, double const &newY) {if(i>= MAXCURVES) return; else thisYaxisLimitsMin[i] = newY;}
+    void setYaxisLimitsMax(int i, double const &newY) {if(i>= getCurveCount()) return; else thisYaxisLimitsMax[i] = newY;}
+    void setYaxisLimitsMin(int i, double const &newY) {if(i>= getCurveCount()) return; else thisYaxisLimitsMin[i] = newY;}
 
-    void setYscalingMin(int i, axisScaling s) {if(i>= MAXCURVES) return; else setYscalingMin(s, i); }
-    void setYscalingMax(int i, axisScaling s) {if(i>= MAXCURVES) return; else setYscalingMax(s, i); }
+    void setYscalingMin(int i, axisScaling s) {if(i>= getCurveCount()) return; else setYscalingMin(s, i); }
+    void setYscalingMax(int i, axisScaling s) {if(i>= getCurveCount()) return; else setYscalingMax(s, i); }
 
     void showCurve(int number, bool on);
     void addText(double x, double y, char* text, QColor c, int fontsize);
@@ -478,17 +489,24 @@ private:
     void RescaleCurves(int width, units unit, double period);
     void RescaleAxis();
     void TimersStart();
+    void setCurveCount(int nbCurves);
+    void setCurveStyle(int curvIndex);
 
     // curve only used to define nicely the legend
-    QwtPlotCurve *curve[MAXCURVES];
-    // curve for plotting line/point from minimum to maximum value
-    QwtPlotIntervalCurveNaN *errorcurve[MAXCURVES];
-    QwtPlotCurveNaN *fillcurve[MAXCURVES];
+    QVector<QwtPlotCurve *> curve;
+
+    // history of all curves with a common time base, slot 0 is the newest entry
+    StripplotHistory history;
+    // all curves are drawn by this item in one pass over the history, holding the mutex
+    StripplotCurvesItem *curvesItem;
+    // interval and offset computed by the collecting thread, given to the curves by the gui thread
+    curvType curvesType;
+    double curvesInterval;
+    double xOffset;
 
-    // y data for error curve
-    QVector<QwtIntervalSample> base;
-    QVector<QwtIntervalSample> rangeData[MAXCURVES];
-    QVector<QPointF> fillData[MAXCURVES];
+    // minimum and maximum of the history for the autoscale
+    QVector<SlidingExtrema> extrema;
+    qint64 historySeq;
 
     double timeData;
     int dataCount;
@@ -503,16 +521,17 @@ private:
     QString thisTitle, thisTitleX, thisTitleY;
     units thisUnits;
     QStringList	 thisPVS;
-    double thisYaxisLimitsMax[MAXCURVES], thisYaxisLimitsMin[MAXCURVES];
-    curvStyle thisStyle[MAXCURVES];
+    QVector<double> thisYaxisLimitsMax, thisYaxisLimitsMin;
+    QVector<curvStyle> thisStyle;
     QColor thisForeColor;
     QColor thisBackColor;
     QColor thisScaleColor;
-    QColor thisLineColor[MAXCURVES], thisGridColor;
+    QVector<QColor> thisLineColor;
+    QColor thisGridColor;
     double AutoscaleMaxY;
     double AutoscaleMinY;
 
-    axisScaling thisYscalingMax[MAXCURVES], thisYscalingMin[MAXCURVES];
+    QVector<axisScaling> thisYscalingMax, thisYscalingMin;
 
     double thisPeriod;
 
@@ -526,9 +545,9 @@ private:
 
     void ReplaceTrailingZerosByBlancs(char *asc);
 
-    double maxVal[MAXCURVES], minVal[MAXCURVES], actVal[MAXCURVES];
-    double realVal[MAXCURVES], realMax[MAXCURVES], realMin[MAXCURVES];
-    struct timeb realTim[MAXCURVES];
+    QVector<double> maxVal, minVal, actVal;
+    QVector<double> realVal, realMax, realMin;
+    QVector<struct timeb> realTim;
 
     QStringList savedTitres;
     QString legendText(int i);
@@ -29,6 +29,87 @@
 
 #include "cawaterfallplot.h"
 
+WaterfallSpectrogram::WaterfallSpectrogram(const SpectrogramData *data)
+{
+    Data = data;
+    CacheValid = false;
+    CacheGeneration = CacheLayout = 0;
+}
+
+void WaterfallSpectrogram::colorRow(int physical, const QwtInterval &interval) const
+{
+    const QwtColorMap *map = colorMap();
+    const double *values = Data->row(physical);
+    QRgb *line = (QRgb *) Cache.scanLine(physical);
+    for(int col = 0; col < Data->columns(); col++) line[col] = map->rgb(interval, values[col]);
+}
+
+// color all rows after a change of geometry, colormap or intensity, otherwise only the new ones
+void WaterfallSpectrogram::updateCache() const
+{
+    const QwtInterval interval = Data->interval(Qt::ZAxis);
+    const QSize size(Data->columns(), Data->rows());
+    bool complete = !CacheValid || Cache.size() != size || CacheLayout != Data->layout() || !(CacheInterval == interval);
+
+    if(!complete && (Data->generation() - CacheGeneration) >= (quint64) size.height()) complete = true;
+
+    if(complete) {
+        if(Cache.size() != size) Cache = QImage(size, QImage::Format_ARGB32);
+        for(int r = 0; r < size.height(); r++) colorRow(r, interval);
+    } else {
+        for(quint64 g = CacheGeneration; g < Data->generation(); g++) colorRow(Data->generationRow(g), interval);
+    }
+
+    CacheValid = true;
+    CacheGeneration = Data->generation();
+    CacheLayout = Data->layout();
+    CacheInterval = interval;
+}
+
+QImage WaterfallSpectrogram::renderImage(const QwtScaleMap &xMap, const QwtScaleMap &yMap, const QRectF &area, const QSize &imageSize) const
+{
+    const int cols = Data->columns();
+    const int rows = Data->rows();
+    if(cols < 1 || rows < 1 || colorMap() == (QwtColorMap *) 0 || imageSize.isEmpty() || area.isEmpty()) {
+        return QwtPlotSpectrogram::renderImage(xMap, yMap, area, imageSize);
+    }
+
+    updateCache();
+
+    // map plot coordinates of the area to image pixels, the maps tell which side is on top
+    const double sx = imageSize.width() / area.width();
+    const double sy = imageSize.height() / area.height();
+    const bool xInverted = xMap.transform(area.left()) > xMap.transform(area.right());
+    const bool yInverted = yMap.transform(area.top()) > yMap.transform(area.bottom());
+    QTransform transform(xInverted ? -sx : sx, 0.0, 0.0, yInverted ? -sy : sy,
+                         xInverted ? area.right() * sx : -area.left() * sx,
+                         yInverted ? area.bottom() * sy : -area.top() * sy);
+
+    QImage image(imageSize, QImage::Format_ARGB32);
+    image.fill(0);
+
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, false);
+    painter.setTransform(transform);
+
+    // the cache is a ring too, draw from the oldest row to the end and then the rest
+    const QwtInterval xInterval = Data->interval(Qt::XAxis);
+    const QwtInterval yInterval = Data->interval(Qt::YAxis);
+    const double rowHeight = yInterval.width() / rows;
+    const int oldest = Data->oldestRow();
+    const int firstPart = rows - oldest;
+
+    painter.drawImage(QRectF(xInterval.minValue(), yInterval.minValue(), xInterval.width(), firstPart * rowHeight),
+                      Cache, QRectF(0, oldest, cols, firstPart));
+    if(oldest > 0) {
+        painter.drawImage(QRectF(xInterval.minValue(), yInterval.minValue() + firstPart * rowHeight, xInterval.width(), oldest * rowHeight),
+                          Cache, QRectF(0, 0, cols, oldest));
+    }
+    painter.end();
+
+    return image;
+}
+
 __inline double gauss(double x)
 {
     return exp(-0.5*x*x);
@@ -51,21 +132,20 @@ caWaterfallPlot::caWaterfallPlot(QWidget *parent): QWidget(parent)
     // add it to layout
     hboxLayout->addWidget(plot);
 
+    // define data
+    m_data = new SpectrogramData();
+
     // define spectrogram
-    d_spectrogram = new QwtPlotSpectrogram();
+    d_spectrogram = new WaterfallSpectrogram(m_data);
     d_spectrogram->setRenderThreadCount(0); // use system specific thread count
 
     d_spectrogram->setColorMap(new ColorMap_Wavelength());
 
-    // define data
-    m_data = new SpectrogramData();
-
     // set 200 rows ( NumberofColumns columns for demo
     setRows(nbRows);
     setCols(nbCols);
     ActualNumberOfColumns = NumberOfColumns = nbCols;
-    reducedArray = (double*) malloc(ActualNumberOfColumns * sizeof(double));
-    memset(reducedArray, 0, ActualNumberOfColumns *sizeof(double));
+    reducedArray.fill(0.0, ActualNumberOfColumns);
 
     // initialize data
     m_data->initData(NumberOfColumns, getRows());
@@ -180,10 +260,7 @@ void caWaterfallPlot::setCountNumber(int number) {
 void caWaterfallPlot::InitData(int numCols)
 {
     disableDemo = true;
-    if(reducedArray != (double *) 0) {
-        free(reducedArray);
-        reducedArray = (double *) 0;
-    }
+    reducedArray.clear();
 
     countRows = 0;
     setCols(numCols);
@@ -224,13 +301,9 @@ template <typename pureData> void caWaterfallPlot::CompressAndkeepArray(pureData
 {
     datamutex->lock();
     int ratio = m_data->getRatio(NumberOfColumns, ActualNumberOfColumns);
-    if(reducedArray != (double *) 0) {
-        free(reducedArray);
-        reducedArray = (double *) 0;
-    }
-    reducedArray = (double*) malloc(ActualNumberOfColumns * sizeof(double));
-    memset(reducedArray, 0, ActualNumberOfColumns *sizeof(double));
-    AverageArray(vec, size, arraySize, reducedArray, ratio);
+    // only reallocated when the number of columns changes
+    reducedArray.fill(0.0, ActualNumberOfColumns);
+    AverageArray(vec, size, arraySize, reducedArray.data(), ratio);
     datamutex->unlock();
 }
 
@@ -364,7 +437,7 @@ void caWaterfallPlot::TimeOut()
         if(!disableDemo) {
             datamutex->lock();
             GausCurv(position);
-            m_data->setData(reducedArray, countRows, ActualNumberOfColumns, getRows(), ActualNumberOfColumns);
+            m_data->setData(reducedArray.data(), countRows, ActualNumberOfColumns, getRows(), ActualNumberOfColumns);
             setCols(ActualNumberOfColumns);
 
             if(firstDemoPlot) {
@@ -378,9 +451,9 @@ void caWaterfallPlot::TimeOut()
             if(drift < 0 && position <= 0)  drift = 1;
             position += drift;
         } else {
-            if(reducedArray != (double*) 0) {
+            if(!reducedArray.isEmpty()) {
                 datamutex->lock();
-                m_data->setData(reducedArray, countRows, ActualNumberOfColumns, getRows(),  ActualNumberOfColumns);
+                m_data->setData(reducedArray.data(), countRows, ActualNumberOfColumns, getRows(),  ActualNumberOfColumns);
                 if(firstTimerPlot) {
                     updatePlot();
                     m_data->setLimits(0., getCols(), 0., getRows(), thisIntensityMin, thisIntensityMax);
@@ -406,6 +479,8 @@ void caWaterfallPlot::setColormap(colormap const &map)
     plot->setAxisScale(QwtPlot::yRight, thisIntensityMin, thisIntensityMax);
     plot->enableAxis(QwtPlot::yRight);
 
+    d_spectrogram->invalidateCache();
+
     switch (map) {
 
     case grey:
@@ -482,7 +557,7 @@ void caWaterfallPlot::GausCurv(double middle) {
     double max = 1000.0;
     double range = max - min;
     double sigma = 100.0;
-    for (int i=0; i<nbCols; i++) {
+    for (int i=0; i<qMin((int) nbCols, reducedArray.size()); i++) {
         reducedArray[i] =  min + range * gauss((i-middle)/sigma);
     }
 }
@@ -39,7 +39,7 @@
 #include <qwt_plot_layout.h>
 #include <qwt_plot_renderer.h>
 #include <qwt_plot_grid.h>
-#include <qwt_matrix_raster_data.h>
+#include <qwt_raster_data.h>
 #include <qwt_point_3d.h>
 #include <qwt_plot_spectrocurve.h>
 #include <sys/timeb.h>
@@ -52,25 +52,45 @@
 
 #define MAXCOLUMNS 500
 
-class SpectrogramData: public QwtMatrixRasterData
+// raster data of the waterfall, the rows are kept in a ring: once all rows are filled,
+// a new row overwrites the oldest one and the row offset moves, instead of shifting the
+// whole matrix up by one row; the first (oldest) row is displayed at the top
+
+class SpectrogramData: public QwtRasterData
 {
 private:
     QVector<double> values;
-    QVector<double> valuesAveraged;
 
     int NumberOfColumns;
     int NumberOfRows;
     int ActualNumberOfColumns;
     int ratio;
 
+    int Head;              // physical row written next
+    int Filled;            // number of rows written since the last reset
+    quint64 Generation;    // number of rows written since the last reset
+    quint64 Layout;        // changes whenever the size of the matrix changes
+
+    void resetRows()
+    {
+        values.fill(0.0, ActualNumberOfColumns * NumberOfRows);
+        Head = Filled = 0;
+        Generation = 0;
+        Layout++;
+    }
+
 public:
     SpectrogramData() {
+        NumberOfColumns = NumberOfRows = ActualNumberOfColumns = 0;
+        ratio = 1;
+        Head = Filled = 0;
+        Generation = Layout = 0;
     }
 
     template <typename pureData>
-    void AverageVector(pureData *vec, int size, QVector<double> &avg, int arraySize)
+    void AverageVector(pureData *vec, int size, double *avg, int arraySize)
     {
-        avg.clear();
+        int counter = 0;
         for (int i=0; i< size-ratio; i+=ratio) {
             double mean = 0;
             for(int j=0; j< ratio; j++) {
@@ -80,8 +100,10 @@ public:
                    mean += vec[i+j];
                 }
             }
-            avg += mean / (double) ratio;
+            if(counter >= ActualNumberOfColumns) break;
+            avg[counter++] = mean / (double) ratio;
         }
+        for(; counter < ActualNumberOfColumns; counter++) avg[counter] = 0.0;
     }
 
     int getRatio(int NumberOfColumns, int &MaximumColumns) {
@@ -100,87 +122,39 @@ public:
         NumberOfRows = numRows;
 
         ratio = getRatio(NumberOfColumns, ActualNumberOfColumns);
-
-        // too many columns, calculate size of reduced data vector
-        if(ratio != 1) {
-            valuesAveraged.resize(ActualNumberOfColumns);
-        }
-        values.clear();
-        valuesAveraged.clear();
+        resetRows();
 
         return ActualNumberOfColumns;
     }
 
     template <typename pureData> int setData(pureData* Array, int &count, int numCols, int numRows, int arraySize)
     {
-        //struct timeb now, last;
-        //ftime(&last);
-        ActualNumberOfColumns = NumberOfColumns = numCols;
-        NumberOfRows = numRows;
-
-        ratio = getRatio(NumberOfColumns, ActualNumberOfColumns);
-
-        // too many columns, calculate size of reduced data vector
-        if(ratio != 1) {
-            valuesAveraged.resize(ActualNumberOfColumns);
+        int actualColumns = NumberOfColumns = numCols;
+        ratio = getRatio(NumberOfColumns, actualColumns);
+
+        // a new geometry starts again from the top
+        if(actualColumns != ActualNumberOfColumns || numRows != NumberOfRows) {
+            ActualNumberOfColumns = actualColumns;
+            NumberOfRows = numRows;
+            count = 0;
+            resetRows();
         }
-        values.resize(ActualNumberOfColumns * NumberOfRows);
+        if(ActualNumberOfColumns < 1 || NumberOfRows < 1) return ActualNumberOfColumns;
 
-        // calculate reduced data vector
+        // write the new row over the oldest one, reduced when too many columns
+        double *row = values.data() + Head * ActualNumberOfColumns;
         if(ratio != 1) {
-            AverageVector(Array, NumberOfColumns, valuesAveraged, arraySize);
-        }
-
-        // in case of a plot down to the bottom, start from the top and go to bottom
-        if(count <  NumberOfRows) {
-            int start = ActualNumberOfColumns * count;
-            int stop = start + ActualNumberOfColumns;
-            if(ratio != 1) {
-                for ( int i = start; i < stop; i++ ) {
-                    values[i] = valuesAveraged[i-start];
-                }
-            } else {
-                for ( int i = start; i < stop; i++ ) {
-                    if((i-start) >= arraySize) {
-                        break;
-                    } else {
-                       values[i] = Array[i-start];
-                    }
-                }
-            }
-            count++;
-            // otherwise shift plot and add to the end
+            AverageVector(Array, NumberOfColumns, row, arraySize);
         } else {
-            // delete first row
-            values.remove(0, ActualNumberOfColumns);
-            // resize to full size
-            values.resize(ActualNumberOfColumns * NumberOfRows);
-
-            // copy array to the end of the array data
-            int start = ActualNumberOfColumns * NumberOfRows - ActualNumberOfColumns;
-            int stop = ActualNumberOfColumns * NumberOfRows;
-            if(ratio != 1) {
-                for ( int i = start; i < stop; i++ ) {
-                    values[i] = valuesAveraged[i-start];
-                }
-            } else {
-                for ( int i = start; i < stop; i++ ) {
-                    if((i-start) >= arraySize) {
-                        break;
-                    } else {
-                       values[i] = Array[i-start];
-                    }
-                }
-            }
+            int n = qMin(ActualNumberOfColumns, arraySize);
+            for(int i = 0; i < n; i++) row[i] = Array[i];
+            for(int i = n; i < ActualNumberOfColumns; i++) row[i] = 0.0;
         }
 
-        //ftime(&now);
-        //double diff = ((double) now.time + (double) now.millitm / (double)1000) -
-        //        ((double) last.time + (double) last.millitm / (double)1000);
-        //printf("%f\n", diff);
-
-        // update the matrix
-        setValueMatrix(values, ActualNumberOfColumns);
+        if(++Head >= NumberOfRows) Head = 0;
+        if(Filled < NumberOfRows) Filled++;
+        Generation++;
+        count = Filled;
 
         return ActualNumberOfColumns;
     }
@@ -192,8 +166,59 @@ public:
         setInterval( Qt::ZAxis, QwtInterval( zmin, zmax+(zmax-zmin)*5.0/1000.0) );
     }
 
+    int columns() const { return ActualNumberOfColumns; }
+    int rows() const { return NumberOfRows; }
+
+    // physical row displayed first, before all rows are filled this is row 0
+    int oldestRow() const { return (Filled < NumberOfRows) ? 0 : Head; }
+
+    // physical row written by the given generation
+    int generationRow(quint64 generation) const { return (int) (generation % (quint64) NumberOfRows); }
+
+    quint64 generation() const { return Generation; }
+    quint64 layout() const { return Layout; }
+    const double *row(int physical) const { return values.constData() + physical * ActualNumberOfColumns; }
+
+    virtual double value(double x, double y) const
+    {
+        const QwtInterval xInterval = interval(Qt::XAxis);
+        const QwtInterval yInterval = interval(Qt::YAxis);
+        if(!xInterval.contains(x) || !yInterval.contains(y)) return qQNaN();
+        if(ActualNumberOfColumns < 1 || NumberOfRows < 1) return qQNaN();
+
+        int col = (int) ((x - xInterval.minValue()) / xInterval.width() * ActualNumberOfColumns);
+        int r = (int) ((y - yInterval.minValue()) / yInterval.width() * NumberOfRows);
+        col = qBound(0, col, ActualNumberOfColumns - 1);
+        r = qBound(0, r, NumberOfRows - 1);
+        return row((oldestRow() + r) % NumberOfRows)[col];
+    }
 };
 
+// spectrogram keeping its image colored in data resolution: only the rows written since the
+// last paint go through the colormap, the image is then scaled to the canvas in two parts
+// (oldest rows first), so that a new row costs O(columns) of colormap lookups
+
+class WaterfallSpectrogram: public QwtPlotSpectrogram
+{
+public:
+    WaterfallSpectrogram(const SpectrogramData *data);
+
+    // to be called when the colormap was replaced
+    void invalidateCache() { CacheValid = false; }
+
+protected:
+    virtual QImage renderImage(const QwtScaleMap &xMap, const QwtScaleMap &yMap, const QRectF &area, const QSize &imageSize) const;
+
+private:
+    void updateCache() const;
+    void colorRow(int physical, const QwtInterval &interval) const;
+
+    const SpectrogramData *Data;
+    mutable QImage Cache;
+    mutable bool CacheValid;
+    mutable quint64 CacheGeneration, CacheLayout;
+    mutable QwtInterval CacheInterval;
+};
 
 class QTCON_EXPORT caWaterfallPlot: public QWidget
 {
@@ -344,12 +369,12 @@ private:
     QMutex *datamutex;
 
     QwtPlot *plot;
-    QwtPlotSpectrogram *d_spectrogram;
+    WaterfallSpectrogram *d_spectrogram;
     QwtPlotGrid * plotGrid;
     QTimer *Timer;
     double position, drift;
 
-    double *reducedArray;
+    QVector<double> reducedArray;
 
     SpectrogramData *m_data;
 
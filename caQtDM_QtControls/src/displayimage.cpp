@@ -0,0 +1,514 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2014
+ *
+ *  Author:
+ *    Anton Mezger
+ *  Contact details:
+ *    anton.mezger@psi.ch
+ */
+
+#include <QFileInfo>
+#include <QDateTime>
+#include <QVector>
+#include <QHash>
+#include <QXmlStreamReader>
+#include <QtEndian>
+#include <string.h>
+#include "displayimage.h"
+
+#define IMAGE_MAGIC 0x49445143    // "CQDI"
+#define IMAGE_VERSION 1
+#define HEADER_WORDS 11
+#define NO_PARENT 0xFFFFFFFF
+
+// everything needed to write an image, filled while reading the ui file
+
+class ImageWriter
+{
+public:
+    struct Property {
+        quint32 name, type;
+        QVector<quint32> data;
+    };
+    struct Widget {
+        quint32 className, name, parent;
+        QVector<Property> properties;
+    };
+
+    QVector<Widget> widgets;
+
+    quint32 intern(const QString &text) {
+        QByteArray utf8 = text.toUtf8();
+        QHash<QByteArray, quint32>::const_iterator it = ids.constFind(utf8);
+        if(it != ids.constEnd()) return it.value();
+        quint32 id = (quint32) offsets.size();
+        offsets.append((quint32) strings.size());
+        strings.append(utf8);
+        ids.insert(utf8, id);
+        return id;
+    }
+
+    static void appendDouble(QVector<quint32> &data, double value) {
+        quint32 words[2];
+        memcpy(words, &value, sizeof(double));
+        data.append(words[0]);
+        data.append(words[1]);
+    }
+
+    QByteArray image(qint64 sourceSize, qint64 sourceTime) const {
+        QVector<quint32> words;
+        quint32 propertyCount = 0, dataCount = 0;
+        foreach(Widget widget, widgets) {
+            propertyCount += widget.properties.size();
+            foreach(Property property, widget.properties) dataCount += property.data.size();
+        }
+
+        words << IMAGE_MAGIC << IMAGE_VERSION
+              << (quint32) (sourceSize & 0xFFFFFFFF) << (quint32) (sourceSize >> 32)
+              << (quint32) (sourceTime & 0xFFFFFFFF) << (quint32) (sourceTime >> 32)
+              << (quint32) offsets.size() << (quint32) widgets.size() << propertyCount << dataCount
+              << (quint32) strings.size();
+
+        // string offsets with the end of the last string
+        words << offsets << (quint32) strings.size();
+
+        quint32 property = 0;
+        foreach(Widget widget, widgets) {
+            words << widget.className << widget.name << widget.parent << property << (quint32) widget.properties.size();
+            property += widget.properties.size();
+        }
+
+        quint32 data = 0;
+        foreach(Widget widget, widgets) {
+            foreach(Property p, widget.properties) {
+                words << p.name << p.type << data << (quint32) p.data.size();
+                data += p.data.size();
+            }
+        }
+        foreach(Widget widget, widgets) {
+            foreach(Property p, widget.properties) words << p.data;
+        }
+
+        QByteArray image;
+        image.resize(words.size() * sizeof(quint32));
+        uchar *dest = (uchar *) image.data();
+        for(int i = 0; i < words.size(); i++) qToLittleEndian<quint32>(words.at(i), dest + i * sizeof(quint32));
+
+        // strings at the end, padded to a full word
+        QByteArray padded(strings);
+        while(padded.size() % sizeof(quint32)) padded.append('\0');
+        image.append(padded);
+        return image;
+    }
+
+private:
+    QHash<QByteArray, quint32> ids;
+    QVector<quint32> offsets;
+    QByteArray strings;
+};
+
+static bool unsupported(QXmlStreamReader &xml, QString &error, const QString &what)
+{
+    error = QString("%1 at line %2 is not supported").arg(what).arg(xml.lineNumber());
+    return false;
+}
+
+// integer children of a compound value (rect, size, color ...) in the given order
+static bool readNumbers(QXmlStreamReader &xml, const QStringList &names, QVector<quint32> &data, QString &error)
+{
+    QVector<quint32> values(names.size(), 0);
+    while(xml.readNextStartElement()) {
+        int index = names.indexOf(xml.name().toString());
+        if(index < 0) return unsupported(xml, error, QString("<%1>").arg(xml.name().toString()));
+        values[index] = (quint32) xml.readElementText().trimmed().toInt();
+    }
+    data << values;
+    return true;
+}
+
+static bool readFont(QXmlStreamReader &xml, ImageWriter &writer, QVector<quint32> &data, QString &error)
+{
+    QVector<quint32> values(8, 0);
+    while(xml.readNextStartElement()) {
+        QString name = xml.name().toString();
+        QString text = xml.readElementText().trimmed();
+        if(name == "family") {
+            values[0] |= DisplayImage::FontFamily;
+            values[1] = writer.intern(text);
+        } else if(name == "pointsize") {
+            values[0] |= DisplayImage::FontPointSize;
+            values[2] = (quint32) text.toInt();
+        } else if(name == "weight") {
+            values[0] |= DisplayImage::FontWeight;
+            values[3] = (quint32) text.toInt();
+        } else if(name == "italic") {
+            values[0] |= DisplayImage::FontItalic;
+            values[4] = (text == "true");
+        } else if(name == "bold") {
+            values[0] |= DisplayImage::FontBold;
+            values[5] = (text == "true");
+        } else if(name == "underline") {
+            values[0] |= DisplayImage::FontUnderline;
+            values[6] = (text == "true");
+        } else if(name == "strikeout") {
+            values[0] |= DisplayImage::FontStrikeOut;
+            values[7] = (text == "true");
+        } else {
+            return unsupported(xml, error, QString("font attribute <%1>").arg(name));
+        }
+    }
+    data << values;
+    return true;
+}
+
+static bool readColor(QXmlStreamReader &xml, QVector<quint32> &data, QString &error)
+{
+    QVector<quint32> rgb;
+    quint32 alpha = 255;
+    if(xml.attributes().hasAttribute("alpha")) alpha = xml.attributes().value("alpha").toString().toUInt();
+    if(!readNumbers(xml, QStringList() << "red" << "green" << "blue", rgb, error)) return false;
+    data << (((alpha & 0xff) << 24) | ((rgb.at(0) & 0xff) << 16) | ((rgb.at(1) & 0xff) << 8) | (rgb.at(2) & 0xff));
+    return true;
+}
+
+// palette as triples of group, role name and color, only solid brushes
+static bool readPalette(QXmlStreamReader &xml, ImageWriter &writer, QVector<quint32> &data, QString &error)
+{
+    while(xml.readNextStartElement()) {
+        quint32 group;
+        if(xml.name() == "active") group = 0;
+        else if(xml.name() == "disabled") group = 1;
+        else if(xml.name() == "inactive") group = 2;
+        else return unsupported(xml, error, QString("palette group <%1>").arg(xml.name().toString()));
+
+        while(xml.readNextStartElement()) {
+            if(xml.name() != "colorrole") return unsupported(xml, error, "palette without color roles");
+            quint32 role = writer.intern(xml.attributes().value("role").toString());
+            if(!xml.readNextStartElement() || xml.name() != "brush") return unsupported(xml, error, "palette role without brush");
+            QString style = xml.attributes().value("brushstyle").toString();
+            if(!style.isEmpty() && style != "SolidPattern") return unsupported(xml, error, QString("brush style %1").arg(style));
+            if(!xml.readNextStartElement() || xml.name() != "color") return unsupported(xml, error, "brush without color");
+            data << group << role;
+            if(!readColor(xml, data, error)) return false;
+            while(xml.readNextStartElement()) xml.skipCurrentElement();   // rest of brush
+            while(xml.readNextStartElement()) xml.skipCurrentElement();   // rest of color role
+        }
+    }
+    return true;
+}
+
+static bool readProperty(QXmlStreamReader &xml, ImageWriter &writer, ImageWriter::Property &property, QString &error)
+{
+    property.name = writer.intern(xml.attributes().value("name").toString());
+    if(!xml.readNextStartElement()) return unsupported(xml, error, "property without value");
+
+    QString kind = xml.name().toString();
+    bool ok = true;
+    if(kind == "string" || kind == "cstring") {
+        property.type = DisplayImage::String;
+        property.data << writer.intern(xml.readElementText());
+    } else if(kind == "number") {
+        property.type = DisplayImage::Number;
+        property.data << (quint32) xml.readElementText().trimmed().toInt();
+    } else if(kind == "double" || kind == "float") {
+        property.type = DisplayImage::Double;
+        ImageWriter::appendDouble(property.data, xml.readElementText().trimmed().toDouble());
+    } else if(kind == "bool") {
+        property.type = DisplayImage::Bool;
+        property.data << (xml.readElementText().trimmed() == "true");
+    } else if(kind == "enum" || kind == "set") {
+        property.type = DisplayImage::Enum;
+        property.data << writer.intern(xml.readElementText().trimmed());
+    } else if(kind == "stringlist") {
+        property.type = DisplayImage::StringList;
+        while(xml.readNextStartElement()) {
+            if(xml.name() != "string") return unsupported(xml, error, "string list entry");
+            property.data << writer.intern(xml.readElementText());
+        }
+    } else if(kind == "color") {
+        property.type = DisplayImage::Color;
+        ok = readColor(xml, property.data, error);
+    } else if(kind == "font") {
+        property.type = DisplayImage::Font;
+        ok = readFont(xml, writer, property.data, error);
+    } else if(kind == "rect") {
+        property.type = DisplayImage::Rect;
+        ok = readNumbers(xml, QStringList() << "x" << "y" << "width" << "height", property.data, error);
+    } else if(kind == "size") {
+        property.type = DisplayImage::Size;
+        ok = readNumbers(xml, QStringList() << "width" << "height", property.data, error);
+    } else if(kind == "point") {
+        property.type = DisplayImage::Point;
+        ok = readNumbers(xml, QStringList() << "x" << "y", property.data, error);
+    } else if(kind == "sizepolicy") {
+        property.type = DisplayImage::SizePolicy;
+        if(!xml.attributes().hasAttribute("hsizetype") || !xml.attributes().hasAttribute("vsizetype")) {
+            return unsupported(xml, error, "old size policy format");
+        }
+        property.data << writer.intern(xml.attributes().value("hsizetype").toString());
+        property.data << writer.intern(xml.attributes().value("vsizetype").toString());
+        ok = readNumbers(xml, QStringList() << "horstretch" << "verstretch", property.data, error);
+    } else if(kind == "palette") {
+        property.type = DisplayImage::Palette;
+        ok = readPalette(xml, writer, property.data, error);
+    } else {
+        return unsupported(xml, error, QString("property type <%1>").arg(kind));
+    }
+    if(!ok) return false;
+
+    // nothing else expected in a property
+    if(xml.readNextStartElement()) return unsupported(xml, error, QString("<%1> in property").arg(xml.name().toString()));
+    return true;
+}
+
+static bool readWidget(QXmlStreamReader &xml, ImageWriter &writer, quint32 parent, QString &error)
+{
+    int index = writer.widgets.size();
+    ImageWriter::Widget widget;
+    widget.className = writer.intern(xml.attributes().value("class").toString());
+    widget.name = writer.intern(xml.attributes().value("name").toString());
+    widget.parent = parent;
+    writer.widgets.append(widget);
+
+    QVector<quint32> zorder;
+    while(xml.readNextStartElement()) {
+        if(xml.name() == "property") {
+            ImageWriter::Property property;
+            if(!readProperty(xml, writer, property, error)) return false;
+            writer.widgets[index].properties.append(property);
+        } else if(xml.name() == "widget") {
+            if(!readWidget(xml, writer, (quint32) index, error)) return false;
+        } else if(xml.name() == "zorder") {
+            zorder << writer.intern(xml.readElementText().trimmed());
+        } else {
+            return unsupported(xml, error, QString("<%1>").arg(xml.name().toString()));
+        }
+    }
+
+    // raising order of the children, applied when all of them exist
+    if(!zorder.isEmpty()) {
+        ImageWriter::Property property;
+        property.name = writer.intern("zorder");
+        property.type = DisplayImage::ZOrder;
+        property.data = zorder;
+        writer.widgets[index].properties.append(property);
+    }
+    return true;
+}
+
+DisplayImage::DisplayImage()
+{
+    Image = (const uchar *) 0;
+    close();
+}
+
+DisplayImage::~DisplayImage()
+{
+    close();
+}
+
+QString DisplayImage::imageName(const QString &uiFile)
+{
+    int found = uiFile.lastIndexOf(".ui");
+    if(found == -1) return uiFile + ".uib";
+    return uiFile.left(found) + ".uib";
+}
+
+bool DisplayImage::compile(const QString &uiFile, const QString &imageFile, QString &error)
+{
+    QByteArray image;
+    if(!compile(uiFile, image, error)) return false;
+
+    QFile out(imageFile);
+    if(!out.open(QFile::WriteOnly | QFile::Truncate) || out.write(image) != image.size()) {
+        error = QString("can not write %1").arg(imageFile);
+        return false;
+    }
+    out.close();
+    return true;
+}
+
+bool DisplayImage::compile(const QString &uiFile, QByteArray &image, QString &error)
+{
+    QFile file(uiFile);
+    if(!file.open(QFile::ReadOnly)) {
+        error = QString("can not open %1").arg(uiFile);
+        return false;
+    }
+
+    ImageWriter writer;
+    QXmlStreamReader xml(&file);
+    if(!xml.readNextStartElement() || xml.name() != "ui") {
+        error = "not a designer file";
+        return false;
+    }
+
+    while(xml.readNextStartElement()) {
+        if(xml.name() == "widget" && writer.widgets.isEmpty()) {
+            if(!readWidget(xml, writer, NO_PARENT, error)) return false;
+        } else if(xml.name() == "connections") {
+            if(xml.readNextStartElement()) return unsupported(xml, error, "signal/slot connection");
+        } else if(xml.name() == "buttongroups" || xml.name() == "actions" || xml.name() == "widget") {
+            return unsupported(xml, error, QString("<%1>").arg(xml.name().toString()));
+        } else {
+            // class, custom widget declarations, resources, tab stops ... are not needed for building
+            xml.skipCurrentElement();
+        }
+    }
+    if(xml.hasError()) {
+        error = QString("%1 at line %2").arg(xml.errorString()).arg(xml.lineNumber());
+        return false;
+    }
+    if(writer.widgets.isEmpty()) {
+        error = "no widget defined";
+        return false;
+    }
+
+    QFileInfo fi(uiFile);
+    image = writer.image(fi.size(), (qint64) fi.lastModified().toTime_t());
+    file.close();
+    return true;
+}
+
+bool DisplayImage::open(const QString &imageFile, const QString &uiFile)
+{
+    close();
+
+    QFileInfo source(uiFile);
+    QFileInfo fi(imageFile);
+    if(!source.exists() || !fi.exists() || fi.size() < (qint64) (HEADER_WORDS * sizeof(quint32))) return false;
+
+    File.setFileName(imageFile);
+    if(!File.open(QFile::ReadOnly)) return false;
+    Image = File.map(0, File.size());
+    if(Image == (const uchar *) 0) {
+        close();
+        return false;
+    }
+    WordCount = (quint32) (File.size() / sizeof(quint32));
+
+    // stale images are not used
+    qint64 size = ((qint64) word(3) << 32) | word(2);
+    qint64 time = ((qint64) word(5) << 32) | word(4);
+    if(size != source.size() || time != (qint64) source.lastModified().toTime_t() || !readHeader()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool DisplayImage::open(const QByteArray &image)
+{
+    close();
+    if(image.size() < (int) (HEADER_WORDS * sizeof(quint32))) return false;
+
+    // the image is kept shared as long as it is open
+    Data = image;
+    Image = (const uchar *) Data.constData();
+    WordCount = (quint32) (Data.size() / sizeof(quint32));
+    if(!readHeader()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool DisplayImage::readHeader()
+{
+    if(word(0) != IMAGE_MAGIC || word(1) != IMAGE_VERSION) return false;
+
+    StringCount = word(6);
+    WidgetCount = word(7);
+    PropertyCount = word(8);
+    DataCount = word(9);
+    StringBytes = word(10);
+
+    OffsetsStart = HEADER_WORDS;
+    WidgetsStart = OffsetsStart + StringCount + 1;
+    PropertiesStart = WidgetsStart + 5 * WidgetCount;
+    DataStart = PropertiesStart + 4 * PropertyCount;
+    StringsStart = DataStart + DataCount;
+
+    // the tables and the strings must fit into the image
+    if((quint64) StringsStart * sizeof(quint32) + StringBytes > (quint64) WordCount * sizeof(quint32) || WidgetCount < 1 ||
+       word(OffsetsStart + StringCount) != StringBytes) return false;
+    return true;
+}
+
+void DisplayImage::close()
+{
+    if(Image != (const uchar *) 0 && File.isOpen()) File.unmap((uchar *) Image);
+    if(File.isOpen()) File.close();
+    Data.clear();
+    Image = (const uchar *) 0;
+    WordCount = 0;
+    StringCount = WidgetCount = PropertyCount = DataCount = StringBytes = 0;
+    OffsetsStart = WidgetsStart = PropertiesStart = DataStart = StringsStart = 0;
+}
+
+quint32 DisplayImage::word(quint32 index) const
+{
+    if(index >= WordCount) return 0;
+    return qFromLittleEndian<quint32>(Image + index * sizeof(quint32));
+}
+
+quint32 DisplayImage::widgetWord(int widget, int i) const
+{
+    if(widget < 0 || (quint32) widget >= WidgetCount) return 0;
+    return word(WidgetsStart + 5 * widget + i);
+}
+
+quint32 DisplayImage::propertyWord(int property, int i) const
+{
+    if(property < 0 || (quint32) property >= PropertyCount) return 0;
+    return word(PropertiesStart + 4 * property + i);
+}
+
+quint32 DisplayImage::dataWord(int property, int i) const
+{
+    if(i < 0 || i >= dataCount(property)) return 0;
+    quint32 index = propertyWord(property, 2) + i;
+    if(index >= DataCount) return 0;
+    return word(DataStart + index);
+}
+
+double DisplayImage::dataDouble(int property, int i) const
+{
+    quint32 words[2];
+    double value;
+    words[0] = dataWord(property, i);
+    words[1] = dataWord(property, i + 1);
+    memcpy(&value, words, sizeof(double));
+    return value;
+}
+
+QByteArray DisplayImage::utf8(quint32 id) const
+{
+    if(id >= StringCount) return QByteArray();
+    quint32 start = word(OffsetsStart + id);
+    quint32 end = word(OffsetsStart + id + 1);
+    if(start > end || end > StringBytes) return QByteArray();
+    return QByteArray::fromRawData((const char *) Image + StringsStart * sizeof(quint32) + start, end - start);
+}
+
+QString DisplayImage::string(quint32 id) const
+{
+    QByteArray bytes = utf8(id);
+    return QString::fromUtf8(bytes.constData(), bytes.size());
+}
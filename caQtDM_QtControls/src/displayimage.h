@@ -0,0 +1,117 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2014
+ *
+ *  Author:
+ *    Anton Mezger
+ *  Contact details:
+ *    anton.mezger@psi.ch
+ */
+
+#ifndef DISPLAYIMAGE_H
+#define DISPLAYIMAGE_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QFile>
+
+// the display compiler ui2uib builds the image code into its own program
+#ifdef DISPLAYIMAGE_STANDALONE
+  #define DISPLAYIMAGE_EXPORT
+#else
+  #include <qtcontrols_global.h>
+  #define DISPLAYIMAGE_EXPORT QTCON_EXPORT
+#endif
+
+class QWidget;
+class QUiLoader;
+
+// binary image of a designer display file (.uib) made offline by the display compiler ui2uib:
+// a flat table of widgets (parents before children), a table of properties with their values
+// already decoded and a table of interned utf8 strings, all in little endian 32 bit words.
+// the image keeps the size and time stamp of its ui file and is only used as long as they
+// match; displays using something the builder does not handle (layouts, pixmaps, connections,
+// tab pages ...) are refused by the compiler, for those the ui file is always loaded.
+// the same image compiled in memory is the template the include cache builds from.
+
+class DISPLAYIMAGE_EXPORT DisplayImage
+{
+public:
+    enum PropertyType {String = 0, StringList, Number, Double, Bool, Enum, Color, Font, Rect, Size, Point,
+                       SizePolicy, Palette, ZOrder};
+
+    // bits of the first data word of a font
+    enum FontAttribute {FontFamily = 0x01, FontPointSize = 0x02, FontWeight = 0x04, FontItalic = 0x08,
+                        FontBold = 0x10, FontUnderline = 0x20, FontStrikeOut = 0x40};
+
+    DisplayImage();
+    ~DisplayImage();
+
+    // name of the image belonging to a ui file
+    static QString imageName(const QString &uiFile);
+
+    // translate the ui file into an image, false with the reason when it can not be compiled
+    static bool compile(const QString &uiFile, const QString &imageFile, QString &error);
+    static bool compile(const QString &uiFile, QByteArray &image, QString &error);
+
+    // load a display from its image when there is an up to date one, otherwise 0 is returned
+    static QWidget *load(QUiLoader *loader, const QString &uiFile, QWidget *parent);
+
+    // map an image, false when missing, damaged or older than its ui file
+    bool open(const QString &imageFile, const QString &uiFile);
+
+    // use an image compiled in memory, false when damaged
+    bool open(const QByteArray &image);
+    void close();
+
+    // create the widgets of the opened image
+    QWidget *build(QUiLoader *loader, QWidget *parent) const;
+
+    int widgetCount() const { return WidgetCount; }
+    QString widgetClass(int widget) const { return string(widgetWord(widget, 0)); }
+    QString widgetName(int widget) const { return string(widgetWord(widget, 1)); }
+    int widgetParent(int widget) const { return (int) widgetWord(widget, 2); }
+    int firstProperty(int widget) const { return (int) widgetWord(widget, 3); }
+    int propertyCount(int widget) const { return (int) widgetWord(widget, 4); }
+
+    quint32 propertyName(int property) const { return propertyWord(property, 0); }
+    int propertyType(int property) const { return (int) propertyWord(property, 1); }
+    int dataCount(int property) const { return (int) propertyWord(property, 3); }
+    quint32 dataWord(int property, int i) const;
+    double dataDouble(int property, int i) const;
+
+    int stringCount() const { return StringCount; }
+    QString string(quint32 id) const;
+    QByteArray utf8(quint32 id) const;
+
+private:
+    bool readHeader();
+    quint32 word(quint32 index) const;
+    quint32 widgetWord(int widget, int i) const;
+    quint32 propertyWord(int property, int i) const;
+
+    QFile File;
+    QByteArray Data;
+    const uchar *Image;
+    quint32 WordCount;
+    quint32 StringCount, WidgetCount, PropertyCount, DataCount, StringBytes;
+    quint32 OffsetsStart, WidgetsStart, PropertiesStart, DataStart, StringsStart;
+};
+
+#endif // DISPLAYIMAGE_H
@@ -0,0 +1,238 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2014
+ *
+ *  Author:
+ *    Anton Mezger
+ *  Contact details:
+ *    anton.mezger@psi.ch
+ */
+
+#include <QWidget>
+#include <QMainWindow>
+#include <QMenuBar>
+#include <QStatusBar>
+#include <QUiLoader>
+#include <QMetaObject>
+#include <QMetaProperty>
+#include <QVariant>
+#include <QVector>
+#include <QHash>
+#include <QPair>
+#include <QColor>
+#include <QFont>
+#include <QPalette>
+#include <QSizePolicy>
+#include <QRect>
+#include "displayimage.h"
+
+// building of widgets from a display image, part of caQtDM_QtControls only, the compiler
+// does not need the widget classes
+
+static int sizePolicyValue(const QString &name)
+{
+    if(name == "Fixed") return QSizePolicy::Fixed;
+    if(name == "Minimum") return QSizePolicy::Minimum;
+    if(name == "Maximum") return QSizePolicy::Maximum;
+    if(name == "Expanding") return QSizePolicy::Expanding;
+    if(name == "MinimumExpanding") return QSizePolicy::MinimumExpanding;
+    if(name == "Ignored") return QSizePolicy::Ignored;
+    return QSizePolicy::Preferred;
+}
+
+static int paletteRole(const QString &name)
+{
+    static const char *roles[] = {"WindowText", "Button", "Light", "Midlight", "Dark", "Mid", "Text", "BrightText",
+                                  "ButtonText", "Base", "Window", "Shadow", "Highlight", "HighlightedText", "Link",
+                                  "LinkVisited", "AlternateBase", "NoRole", "ToolTipBase", "ToolTipText"};
+    for(int i = 0; i < (int) (sizeof(roles) / sizeof(roles[0])); i++) {
+        if(name == roles[i]) return i;
+    }
+    if(name == "Foreground") return QPalette::WindowText;
+    if(name == "Background") return QPalette::Window;
+    return -1;
+}
+
+// children of these are pages or need a container extension, the ui loader has to do that
+static bool isPageContainer(QWidget *widget)
+{
+    return widget->inherits("QTabWidget") || widget->inherits("QStackedWidget") || widget->inherits("QToolBox") ||
+           widget->inherits("QScrollArea") || widget->inherits("QDockWidget") ||
+           widget->inherits("QSplitter") || widget->inherits("QMdiArea") || widget->inherits("QWizard") ||
+           widget->inherits("caDoubleTabWidget");
+}
+
+QWidget *DisplayImage::load(QUiLoader *loader, const QString &uiFile, QWidget *parent)
+{
+    DisplayImage image;
+    if(!image.open(imageName(uiFile), uiFile)) return (QWidget *) 0;
+    return image.build(loader, parent);
+}
+
+QWidget *DisplayImage::build(QUiLoader *loader, QWidget *parent) const
+{
+    QVector<QWidget *> widgets(widgetCount(), (QWidget *) 0);
+
+    // property indexes resolved once for every class and property name
+    QHash<QPair<const QMetaObject *, quint32>, int> indexes;
+
+    for(int i = 0; i < widgetCount(); i++) {
+        int parentIndex = widgetParent(i);
+        QWidget *parentWidget = parent;
+        if(parentIndex >= 0) {
+            if(parentIndex >= i || isPageContainer(widgets.at(parentIndex))) break;
+            parentWidget = widgets.at(parentIndex);
+        } else if(i > 0) {
+            break;
+        }
+
+        QWidget *widget = loader->createWidget(widgetClass(i), parentWidget, widgetName(i));
+        if(widget == (QWidget *) 0) break;
+
+        // tool bars and dock widgets need an area the image does not keep
+        QMainWindow *mainWindow = (parentIndex >= 0) ? qobject_cast<QMainWindow *>(parentWidget) : (QMainWindow *) 0;
+        if(mainWindow != (QMainWindow *) 0 && (widget->inherits("QToolBar") || widget->inherits("QDockWidget"))) {
+            delete widget;
+            break;
+        }
+        widgets[i] = widget;
+
+        const QMetaObject *metaObject = widget->metaObject();
+        for(int p = firstProperty(i); p < firstProperty(i) + propertyCount(i); p++) {
+            if(propertyType(p) == ZOrder) continue;
+
+            QPair<const QMetaObject *, quint32> key(metaObject, propertyName(p));
+            QHash<QPair<const QMetaObject *, quint32>, int>::const_iterator it = indexes.constFind(key);
+            int index;
+            if(it != indexes.constEnd()) {
+                index = it.value();
+            } else {
+                index = metaObject->indexOfProperty(utf8(propertyName(p)).constData());
+                indexes.insert(key, index);
+            }
+
+            QVariant value;
+            const int count = dataCount(p);
+            switch(propertyType(p)) {
+            case String:
+                value = string(dataWord(p, 0));
+                break;
+            case StringList: {
+                QStringList list;
+                for(int j = 0; j < count; j++) list.append(string(dataWord(p, j)));
+                value = list;
+                break;
+            }
+            case Number:
+                value = (int) dataWord(p, 0);
+                break;
+            case Double:
+                value = dataDouble(p, 0);
+                break;
+            case Bool:
+                value = (dataWord(p, 0) != 0);
+                break;
+            case Enum:
+                // enumeration keys are translated by the meta property
+                value = string(dataWord(p, 0));
+                break;
+            case Color:
+                value = QColor::fromRgba((QRgb) dataWord(p, 0));
+                break;
+            case Font: {
+                QFont font = widget->font();
+                quint32 mask = dataWord(p, 0);
+                if(mask & FontFamily) font.setFamily(string(dataWord(p, 1)));
+                if(mask & FontPointSize) font.setPointSize((int) dataWord(p, 2));
+                if(mask & FontWeight) font.setWeight((int) dataWord(p, 3));
+                if(mask & FontItalic) font.setItalic(dataWord(p, 4) != 0);
+                if(mask & FontBold) font.setBold(dataWord(p, 5) != 0);
+                if(mask & FontUnderline) font.setUnderline(dataWord(p, 6) != 0);
+                if(mask & FontStrikeOut) font.setStrikeOut(dataWord(p, 7) != 0);
+                value = font;
+                break;
+            }
+            case Rect:
+                value = QRect((int) dataWord(p, 0), (int) dataWord(p, 1), (int) dataWord(p, 2), (int) dataWord(p, 3));
+                break;
+            case Size:
+                value = QSize((int) dataWord(p, 0), (int) dataWord(p, 1));
+                break;
+            case Point:
+                value = QPoint((int) dataWord(p, 0), (int) dataWord(p, 1));
+                break;
+            case SizePolicy: {
+                QSizePolicy policy((QSizePolicy::Policy) sizePolicyValue(string(dataWord(p, 0))),
+                                   (QSizePolicy::Policy) sizePolicyValue(string(dataWord(p, 1))));
+                policy.setHorizontalStretch((int) dataWord(p, 2));
+                policy.setVerticalStretch((int) dataWord(p, 3));
+                value = policy;
+                break;
+            }
+            case Palette: {
+                QPalette palette = widget->palette();
+                for(int j = 0; j + 2 < count; j += 3) {
+                    int role = paletteRole(string(dataWord(p, j+1)));
+                    if(role < 0) continue;
+                    palette.setColor((QPalette::ColorGroup) dataWord(p, j), (QPalette::ColorRole) role,
+                                     QColor::fromRgba((QRgb) dataWord(p, j+2)));
+                }
+                value = palette;
+                break;
+            }
+            default:
+                continue;
+            }
+
+            if(index >= 0) metaObject->property(index).write(widget, value);
+            else widget->setProperty(utf8(propertyName(p)).constData(), value);
+        }
+
+        // children of a main window are put in place like the ui loader does it
+        if(mainWindow != (QMainWindow *) 0) {
+            if(QMenuBar *menuBar = qobject_cast<QMenuBar *>(widget)) mainWindow->setMenuBar(menuBar);
+            else if(QStatusBar *statusBar = qobject_cast<QStatusBar *>(widget)) mainWindow->setStatusBar(statusBar);
+            else mainWindow->setCentralWidget(widget);
+        }
+    }
+
+    // not everything could be built, the ui file has to be used
+    if(widgets.isEmpty() || widgets.last() == (QWidget *) 0) {
+        if(!widgets.isEmpty() && widgets.at(0) != (QWidget *) 0) delete widgets.at(0);
+        return (QWidget *) 0;
+    }
+
+    // stacking order of the children
+    for(int i = 0; i < widgetCount(); i++) {
+        for(int p = firstProperty(i); p < firstProperty(i) + propertyCount(i); p++) {
+            if(propertyType(p) != ZOrder) continue;
+            QList<QWidget *> children = widgets.at(i)->findChildren<QWidget *>();
+            for(int j = 0; j < dataCount(p); j++) {
+                QString name = string(dataWord(p, j));
+                foreach(QWidget *child, children) {
+                    if(child->parentWidget() == widgets.at(i) && child->objectName() == name) {
+                        child->raise();
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    return widgets.at(0);
+}
@@ -0,0 +1,153 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2014
+ *
+ *  Author:
+ *    Anton Mezger
+ *  Contact details:
+ *    anton.mezger@psi.ch
+ */
+
+
+#include <QDir>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include "displaypathindex.h"
+#include "pathdefinitions.h"
+
+// a listing is verified against the modification time of its directory after this time
+#define VERIFYINTERVAL 5000
+
+displayPathIndex::displayPathIndex()
+{
+    _Watcher = new QFileSystemWatcher(this);
+    _ProbesAvoided = _Probes = 0;
+    connect(_Watcher, SIGNAL(directoryChanged(const QString &)), this, SLOT(directoryChanged(const QString &)));
+}
+
+displayPathIndex *displayPathIndex::instance()
+{
+    static displayPathIndex *index = (displayPathIndex *) 0;
+    if(index == (displayPathIndex *) 0) index = new displayPathIndex();
+    return index;
+}
+
+void displayPathIndex::clear()
+{
+    QMutexLocker locker(&_Mutex);
+    _Listings.clear();
+    _Path = QString::null;
+    _Paths.clear();
+}
+
+void displayPathIndex::directoryChanged(const QString &dir)
+{
+    QMutexLocker locker(&_Mutex);
+    _Listings.remove(dir);
+    // a directory removed is no longer watched
+    if(!QFileInfo(dir).exists()) _Watched.remove(dir);
+}
+
+// the file watcher may only be used in the gui thread, while the directories are also listed
+// in the thread of the prefetcher
+void displayPathIndex::watch(const QString &dir)
+{
+    if(!_Watcher->directories().contains(dir)) _Watcher->addPath(dir);
+}
+
+void displayPathIndex::refresh(const QString &dir)
+{
+    QMutexLocker locker(&_Mutex);
+    QString absolute = QFileInfo(dir).absoluteFilePath();
+    QMutableHashIterator<QString, Listing> i(_Listings);
+    while(i.hasNext()) {
+        i.next();
+        if(QFileInfo(i.key()).absoluteFilePath() == absolute) i.remove();
+    }
+}
+
+// file systems of windows and mac are case insensitive
+QString displayPathIndex::key(const QString &name)
+{
+#if defined(Q_OS_WIN) || defined(Q_OS_MAC)
+    return name.toLower();
+#else
+    return name;
+#endif
+}
+
+const displayPathIndex::Listing &displayPathIndex::listing(const QString &dir)
+{
+    QHash<QString, Listing>::iterator it = _Listings.find(dir);
+    if(it != _Listings.end()) {
+        if(it.value().verified.elapsed() < VERIFYINTERVAL) {
+            _ProbesAvoided++;
+            return it.value();
+        }
+        _Probes++;
+        if(QFileInfo(dir).lastModified() == it.value().modified) {
+            it.value().verified.restart();
+            return it.value();
+        }
+    }
+
+    // a missing directory gets an empty listing, verified like the others
+    Listing entry;
+    QDir directory(dir);
+    _Probes++;
+    entry.modified = QFileInfo(dir).lastModified();
+    foreach(QString name, directory.entryList(QDir::Files | QDir::Dirs | QDir::Hidden | QDir::NoDotAndDotDot)) {
+        entry.names.insert(key(name));
+    }
+    entry.verified.start();
+    if(directory.exists() && !_Watched.contains(dir)) {
+        _Watched.insert(dir);
+        QMetaObject::invokeMethod(this, "watch", Qt::QueuedConnection, Q_ARG(QString, dir));
+    }
+
+    return _Listings.insert(dir, entry).value();
+}
+
+QString displayPathIndex::find(const QString &fileName)
+{
+    if(fileName.isNull()) return QString::null;
+
+    // first search in current directory
+    if(QFileInfo(fileName).exists()) return fileName;
+
+    QMutexLocker locker(&_Mutex);
+
+    // the path is split again only when it changed
+    QString path = (QString) qgetenv("CAQTDM_DISPLAY_PATH");
+    if(path != _Path) {
+        _Path = path;
+        _Paths = path.split(pathSeparator);
+    }
+
+    // go through path list
+    for(int i = 0; i < _Paths.count(); i++) {
+        QString FileName = _Paths[i] + "/" + fileName;
+        int pos = FileName.lastIndexOf("/");
+        QString dir = FileName.left(pos);
+        if(dir.isEmpty()) dir = "/";
+
+        const Listing &entry = listing(dir);
+        if(entry.names.contains(key(FileName.mid(pos + 1)))) return FileName;
+    }
+    return QString::null;
+}
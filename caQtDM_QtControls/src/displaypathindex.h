@@ -0,0 +1,92 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2014
+ *
+ *  Author:
+ *    Anton Mezger
+ *  Contact details:
+ *    anton.mezger@psi.ch
+ */
+
+
+#ifndef DISPLAYPATHINDEX_H
+#define DISPLAYPATHINDEX_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QSet>
+#include <QDateTime>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QFileSystemWatcher>
+#include <qtcontrols_global.h>
+
+// process wide index of the directories of CAQTDM_DISPLAY_PATH: a directory is listed once and
+// the lookups of the files are then answered from memory instead of probing every path entry
+// with a stat. a listing is dropped when the file watcher reports a change of its directory and
+// is anyway verified against the modification time of the directory after some seconds (file
+// watchers do not see changes made on other hosts of a network file system).
+
+class QTCON_EXPORT displayPathIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    // to be called first from the gui thread, the file watcher lives there
+    static displayPathIndex *instance();
+
+    // same result as probing the current directory and then every path entry, null when not found
+    QString find(const QString &fileName);
+
+    // drop the listing of a directory, to be used after writing a file into it
+    void refresh(const QString &dir);
+
+    void clear();
+
+    // probes of the file system answered from memory and the ones really made
+    qint64 probesAvoided() const { return _ProbesAvoided; }
+    qint64 probes() const { return _Probes; }
+
+private slots:
+    void directoryChanged(const QString &dir);
+    void watch(const QString &dir);
+
+private:
+    struct Listing {
+        QSet<QString> names;
+        QDateTime modified;
+        QElapsedTimer verified;
+    };
+
+    displayPathIndex();
+    const Listing &listing(const QString &dir);
+    static QString key(const QString &name);
+
+    QMutex _Mutex;
+    QFileSystemWatcher *_Watcher;
+    QString _Path;
+    QStringList _Paths;
+    QHash<QString, Listing> _Listings;
+    QSet<QString> _Watched;
+    qint64 _ProbesAvoided;
+    qint64 _Probes;
+};
+
+#endif // DISPLAYPATHINDEX_H
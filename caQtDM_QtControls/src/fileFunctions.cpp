@@ -24,7 +24,7 @@
  */
 
 #include "fileFunctions.h"
-#include "networkaccess.h"
+#include "fileprefetcher.h"
 #include "searchfile.h"
 #include "specialFunctions.h"
 
@@ -56,13 +56,6 @@ int fileFunctions::checkFileAndDownload(const QString &fileName, const QString &
 
     searchFile *s = new searchFile(fileName);
     QString fileNameFound = s->findFile();
-    if(!fileNameFound.isNull()) {
-        //printf("checkFileAndDownload file <%s> locally found\n", qasc(fileName));
-        s->deleteLater();
-        return true;
-    } else {
-        //printf("checkFileAndDownload file <%s> not locally found\n", qasc(fileName));
-    }
     s->deleteLater();
 
     // use specified url
@@ -73,22 +66,32 @@ int fileFunctions::checkFileAndDownload(const QString &fileName, const QString &
        displayPath = (QString)  qgetenv("CAQTDM_URL_DISPLAY_PATH");
     }
 
+    filePrefetcher *prefetcher = filePrefetcher::instance();
+
+    if(!fileNameFound.isNull()) {
+        //printf("checkFileAndDownload file <%s> locally found\n", qasc(fileName));
+        // a downloaded copy is revalidated in the background and the files referenced by a display
+        // are fetched while it is being opened
+        if(displayPath.length() > 0) {
+            prefetcher->prefetch(QStringList() << fileName, url);
+            if(fileNameFound.endsWith(".ui")) prefetcher->prefetchReferences(fileNameFound, url);
+        }
+        return true;
+    } else {
+        //printf("checkFileAndDownload file <%s> not locally found\n", qasc(fileName));
+    }
+
     if(displayPath.length() < 1) return false;
 
     //printf("filename to download %s\n", qasc(fileName));
 
     displayPath.append("/");
     displayPath.append(fileName);
-    QUrl displayUrl(displayPath);
     infoString = "download file " + displayPath;
 
-    NetworkAccess *displayGet = new NetworkAccess();
-    if(!displayGet->requestUrl(displayUrl, fileName)) {
-        errorString = displayGet->lastError();
-        displayGet->deleteLater();
-        return false;
-    }
-    displayGet->deleteLater();
+    // the file may already be on its way when it was referenced by a display
+    prefetcher->prefetch(QStringList() << fileName, url);
+    if(!prefetcher->waitFor(fileName, 3000, errorString)) return false;
     return true;
 }
 
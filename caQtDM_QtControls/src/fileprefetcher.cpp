@@ -0,0 +1,277 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2014
+ *
+ *  Author:
+ *    Anton Mezger
+ *  Contact details:
+ *    anton.mezger@psi.ch
+ */
+
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QUrl>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QXmlStreamReader>
+#include <QNetworkRequest>
+#include <QSslConfiguration>
+#include "fileprefetcher.h"
+#include "searchfile.h"
+#include "displaypathindex.h"
+#include "specialFunctions.h"
+
+filePrefetcher::filePrefetcher()
+{
+    Specials specials;
+    _CachePath = QFileInfo(specials.getStdPath()).absoluteFilePath();
+    _Manager = (QNetworkAccessManager *) 0;
+    _Index = new QSettings(_CachePath + "/caQtDM_cache.ini", QSettings::IniFormat, this);
+
+    // the index of the display path is also used by the thread, it has to be created here in the gui thread
+    displayPathIndex::instance();
+
+    // requests and replies are handled in the thread, the lists are shared under the mutex
+    _Thread = new QThread();
+    moveToThread(_Thread);
+    _Thread->start();
+}
+
+filePrefetcher *filePrefetcher::instance()
+{
+    static filePrefetcher *prefetcher = (filePrefetcher *) 0;
+    if(prefetcher == (filePrefetcher *) 0) prefetcher = new filePrefetcher();
+    return prefetcher;
+}
+
+bool filePrefetcher::isCached(const QString &fileFound) const
+{
+    return QFileInfo(fileFound).absoluteFilePath().startsWith(_CachePath + "/");
+}
+
+int filePrefetcher::pendingCount()
+{
+    QMutexLocker locker(&_Mutex);
+    return _Pending.count();
+}
+
+void filePrefetcher::prefetch(const QStringList &files, const QString &url)
+{
+    QString displayPath = url;
+    if(displayPath.length() < 1) displayPath = (QString) qgetenv("CAQTDM_URL_DISPLAY_PATH");
+    if(displayPath.length() < 1) return;
+
+    foreach(QString file, files) {
+        // file names with macros are only known when the display is opened
+        if(file.isEmpty() || file.contains("$(")) continue;
+        {
+            QMutexLocker locker(&_Mutex);
+            if(_Pending.contains(file) || _Validated.contains(file)) continue;
+        }
+
+        // files found outside of the cache are not ours
+        searchFile s(file);
+        QString fileFound = s.findFile();
+        if(!fileFound.isNull() && !isCached(fileFound)) continue;
+
+        // pending from now on, so that a caller can wait for it before the request is sent
+        {
+            QMutexLocker locker(&_Mutex);
+            if(_Pending.contains(file)) continue;
+            _Pending.insert(file, QUrl(displayPath + "/" + file));
+            _Errors.remove(file);
+        }
+        QMetaObject::invokeMethod(this, "startRequest", Qt::QueuedConnection, Q_ARG(QString, file), Q_ARG(QString, url));
+    }
+}
+
+void filePrefetcher::prefetchReferences(const QString &uiFile, const QString &url)
+{
+    QString key = QFileInfo(uiFile).absoluteFilePath();
+    {
+        QMutexLocker locker(&_Mutex);
+        if(_Scanned.contains(key)) return;
+        _Scanned.insert(key);
+    }
+    prefetch(referencedFiles(uiFile), url);
+}
+
+void filePrefetcher::startRequest(const QString &file, const QString &url)
+{
+    // created here, so that it belongs to our thread
+    if(_Manager == (QNetworkAccessManager *) 0) {
+        _Manager = new QNetworkAccessManager(this);
+        connect(_Manager, SIGNAL(finished(QNetworkReply*)), this, SLOT(finishReply(QNetworkReply*)));
+    }
+
+    QUrl fileUrl;
+    {
+        QMutexLocker locker(&_Mutex);
+        if(!_Pending.contains(file)) return;
+        fileUrl = _Pending.value(file);
+    }
+    QNetworkRequest request(fileUrl);
+
+    //for https we need some configuration (with no verify socket)
+#ifndef CAQTDM_SSL_IGNORE
+#ifndef QT_NO_SSL
+    if(fileUrl.toString().toUpper().contains("HTTPS")) {
+        QSslConfiguration config = request.sslConfiguration();
+        config.setPeerVerifyMode(QSslSocket::VerifyNone);
+        request.setSslConfiguration(config);
+    }
+#endif
+#endif
+
+    // a cached copy is only transferred again when it changed on the server
+    if(QFileInfo(_CachePath + "/" + file).exists()) {
+        QByteArray etag = _Index->value("files/" + file + "/etag").toByteArray();
+        QByteArray modified = _Index->value("files/" + file + "/modified").toByteArray();
+        if(etag.size() > 0) request.setRawHeader("If-None-Match", etag);
+        if(modified.size() > 0) request.setRawHeader("If-Modified-Since", modified);
+    }
+
+    QNetworkReply *reply = _Manager->get(request);
+    reply->setProperty("file", file);
+    reply->setProperty("url", url);
+}
+
+bool filePrefetcher::waitFor(const QString &file, int timeout, QString &error)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // other files may arrive before
+    QMutexLocker locker(&_Mutex);
+    while(_Pending.contains(file)) {
+        int remaining = timeout - (int) timer.elapsed();
+        if(remaining <= 0) {
+            error = tr("networkaccess: http request timeout for %1").arg(_Pending.value(file).toString());
+            return false;
+        }
+        _Finished.wait(&_Mutex, (unsigned long) remaining);
+    }
+    error = _Errors.value(file);
+    return error.isEmpty();
+}
+
+void filePrefetcher::finish(const QString &file, const QString &error, bool validated)
+{
+    QMutexLocker locker(&_Mutex);
+    _Pending.remove(file);
+    if(!error.isEmpty()) _Errors.insert(file, error);
+    if(validated) _Validated.insert(file);
+    _Finished.wakeAll();
+}
+
+void filePrefetcher::finishReply(QNetworkReply *reply)
+{
+    QString file = reply->property("file").toString();
+    QString url = reply->property("url").toString();
+    QVariant status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute);
+
+    if(reply->error()) {
+        finish(file, tr("networkaccess: http status code %1 [%2] for %3").arg(status.toInt()).arg(reply->attribute(QNetworkRequest::HttpReasonPhraseAttribute).toString()).arg(reply->url().toString()), false);
+
+    // cached copy is still valid
+    } else if(status.toInt() == 304) {
+        finish(file, QString::null, true);
+
+    } else {
+        QString filePath = _CachePath + "/" + file;
+
+        // create directory if not exists
+        QFileInfo fi(filePath);
+        if(!QDir(fi.path()).exists()) QDir().mkpath(fi.path());
+
+        // written aside and renamed, so that a partial file is never found
+        QFile part(filePath + ".part");
+        if(!part.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            finish(file, tr("networkaccess: %1 could not be opened for write").arg(filePath), false);
+        } else {
+            part.write(reply->readAll());
+            part.close();
+            QFile::remove(filePath);
+            if(!part.rename(filePath)) {
+                finish(file, tr("networkaccess: %1 could not be written").arg(filePath), false);
+            } else {
+                _Index->setValue("files/" + file + "/etag", reply->rawHeader("ETag"));
+                _Index->setValue("files/" + file + "/modified", reply->rawHeader("Last-Modified"));
+                displayPathIndex::instance()->refresh(fi.path());
+                finish(file, QString::null, true);
+
+                // the references of a new display are fetched right away
+                if(file.endsWith(".ui")) {
+                    {
+                        QMutexLocker locker(&_Mutex);
+                        _Scanned.remove(fi.absoluteFilePath());
+                    }
+                    prefetchReferences(filePath, url);
+                }
+            }
+        }
+    }
+
+    reply->deleteLater();
+    emit fileFinished(file);
+}
+
+QStringList filePrefetcher::referencedFiles(const QString &uiFile)
+{
+    QStringList files;
+    QFile file(uiFile);
+    if(!file.open(QFile::ReadOnly)) return files;
+
+    QXmlStreamReader xml(&file);
+    QStringList classes;
+    QString property;
+    while(!xml.atEnd()) {
+        xml.readNext();
+        if(xml.isStartElement()) {
+            if(xml.name() == "widget") {
+                classes.append(xml.attributes().value("class").toString());
+            } else if(xml.name() == "property") {
+                property = xml.attributes().value("name").toString();
+            } else if(xml.name() == "string" && !classes.isEmpty() && (property == "filename" || property == "files")) {
+                QString widgetClass = classes.last();
+                QStringList names = xml.readElementText().split(";", QString::SkipEmptyParts);
+                foreach(QString name, names) {
+                    name = name.trimmed();
+                    if(name.isEmpty()) continue;
+
+                    // includes and related displays are loaded as ui files
+                    if((widgetClass == "caInclude" || widgetClass == "caRelatedDisplay") && !name.endsWith(".prc")) {
+                        QFileInfo fi(name);
+                        name = fi.completeBaseName() + ".ui";
+                        if(fi.path() != ".") name.prepend(fi.path() + "/");
+                    } else if(widgetClass != "caImage") {
+                        continue;
+                    }
+                    if(!files.contains(name)) files.append(name);
+                }
+            }
+        } else if(xml.isEndElement()) {
+            if(xml.name() == "widget" && !classes.isEmpty()) classes.removeLast();
+            else if(xml.name() == "property") property.clear();
+        }
+    }
+    file.close();
+    return files;
+}
@@ -0,0 +1,98 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2014
+ *
+ *  Author:
+ *    Anton Mezger
+ *  Contact details:
+ *    anton.mezger@psi.ch
+ */
+
+
+#ifndef FILEPREFETCHER_H
+#define FILEPREFETCHER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QSet>
+#include <QSettings>
+#include <QUrl>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <qtcontrols_global.h>
+
+// process wide downloader of the display files that are not found locally: the files are requested
+// in parallel without blocking, a display is waited for only when it is needed. the downloaded files are
+// kept in the standard path together with their ETag and Last-Modified, so that in a later session a
+// cached copy is only revalidated (in the background, the cached copy is used meanwhile). when a display
+// arrives or is opened, its includes, images and related displays are requested at the same time.
+// the transfers run in a thread of their own, so that waiting for a display does not run the event loop
+// of the caller.
+
+class QTCON_EXPORT filePrefetcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    // to be called first from the gui thread, the index of the display path is created with it
+    static filePrefetcher *instance();
+
+    // request the files missing or only present as cached copy, url defaults to CAQTDM_URL_DISPLAY_PATH
+    void prefetch(const QStringList &files, const QString &url = QString::null);
+
+    // request the files referenced by a display, a display is only scanned once
+    void prefetchReferences(const QString &uiFile, const QString &url = QString::null);
+
+    // wait until a requested file has arrived, false with the reason when it failed or timed out
+    bool waitFor(const QString &file, int timeout, QString &error);
+
+    // includes, images and related displays referenced by a display
+    static QStringList referencedFiles(const QString &uiFile);
+
+    int pendingCount();
+
+signals:
+    void fileFinished(const QString &file);
+
+private slots:
+    void startRequest(const QString &file, const QString &url);
+    void finishReply(QNetworkReply *reply);
+
+private:
+    filePrefetcher();
+    bool isCached(const QString &fileFound) const;
+    void finish(const QString &file, const QString &error, bool validated);
+
+    QThread *_Thread;
+    QNetworkAccessManager *_Manager;
+    QSettings *_Index;
+    QString _CachePath;
+    QMutex _Mutex;
+    QWaitCondition _Finished;
+    QHash<QString, QUrl> _Pending;
+    QHash<QString, QString> _Errors;
+    QSet<QString> _Validated;
+    QSet<QString> _Scanned;
+};
+
+#endif // FILEPREFETCHER_H
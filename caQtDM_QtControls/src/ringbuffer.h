@@ -0,0 +1,138 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2014
+ *
+ *  Author:
+ *    Anton Mezger
+ *  Contact details:
+ *    anton.mezger@psi.ch
+ */
+
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+
+#include <QVector>
+#include <QList>
+#include <qnumeric.h>
+
+// circular buffer with a fixed capacity, index 0 is always the newest entry
+// adding an entry is O(1) and replaces the prepend/erase shifting of a QVector
+
+template <typename T>
+class RingBuffer
+{
+public:
+    RingBuffer() : head(0), filled(0) {}
+
+    // (re)allocate the buffer and fill all slots with the given value
+    void reset(int capacity, const T &fill) {
+        buffer.fill(fill, qMax(capacity, 1));
+        head = 0;
+        filled = 0;
+    }
+
+    // clear without reallocating
+    void clear(const T &fill) {
+        buffer.fill(fill);
+        head = 0;
+        filled = 0;
+    }
+
+    int capacity() const { return buffer.size(); }
+
+    // number of entries pushed since the last reset, limited to the capacity
+    int count() const { return filled; }
+
+    // make a new slot at index 0, the oldest entry gets overwritten
+    void advance() {
+        if(++head >= buffer.size()) head = 0;
+        if(filled < buffer.size()) filled++;
+    }
+
+    void push(const T &value) {
+        advance();
+        buffer[head] = value;
+    }
+
+    T &first() { return buffer[head]; }
+    const T &first() const { return buffer.at(head); }
+
+    // i = 0 gives the newest entry, i = capacity()-1 the oldest one
+    const T &at(int i) const {
+        int index = head - i;
+        if(index < 0) index += buffer.size();
+        return buffer.at(index);
+    }
+
+    T &operator[](int i) {
+        int index = head - i;
+        if(index < 0) index += buffer.size();
+        return buffer[index];
+    }
+
+private:
+    QVector<T> buffer;
+    int head;
+    int filled;
+};
+
+// minimum and maximum over a sliding window of entries, kept in two monotonic queues
+// entries are tagged with a strictly increasing sequence number, expired entries are
+// removed from the front, so that adding an entry and querying is amortized O(1)
+
+class SlidingExtrema
+{
+public:
+    void clear() {
+        minQueue.clear();
+        maxQueue.clear();
+    }
+
+    void add(qint64 seq, double minValue, double maxValue) {
+        if(!qIsNaN(minValue)) {
+            while(!minQueue.isEmpty() && minQueue.last().value >= minValue) minQueue.removeLast();
+            minQueue.append(Entry(seq, minValue));
+        }
+        if(!qIsNaN(maxValue)) {
+            while(!maxQueue.isEmpty() && maxQueue.last().value <= maxValue) maxQueue.removeLast();
+            maxQueue.append(Entry(seq, maxValue));
+        }
+    }
+
+    // remove all entries with a sequence number lower than oldest
+    void expire(qint64 oldest) {
+        while(!minQueue.isEmpty() && minQueue.first().seq < oldest) minQueue.removeFirst();
+        while(!maxQueue.isEmpty() && maxQueue.first().seq < oldest) maxQueue.removeFirst();
+    }
+
+    bool hasMinimum() const { return !minQueue.isEmpty(); }
+    bool hasMaximum() const { return !maxQueue.isEmpty(); }
+    double minimum() const { return minQueue.first().value; }
+    double maximum() const { return maxQueue.first().value; }
+
+private:
+    struct Entry {
+        Entry() : seq(0), value(0.0) {}
+        Entry(qint64 s, double v) : seq(s), value(v) {}
+        qint64 seq;
+        double value;
+    };
+    QList<Entry> minQueue, maxQueue;
+};
+
+#endif // RINGBUFFER_H
@@ -24,7 +24,7 @@
  */
 
 #include "searchfile.h"
-#include "pathdefinitions.h"
+#include "displaypathindex.h"
 
 searchFile::searchFile(QString filename)
 {
@@ -35,36 +35,8 @@ QString searchFile::findFile()
 {
     if(_FileName.isNull()) return NULL;
 
-    QString path = (QString) qgetenv("CAQTDM_DISPLAY_PATH");
-    QStringList paths = path.split(pathSeparator);
-
-    // first search in current directory
-    QString FileName = _FileName;
-    bool fileFound = false;
-    QFileInfo fi(FileName);
-
-    // file was not found, go through path list
-    if(!fi.exists()) {
-       for(int i=0; i< paths.count(); i++) {
-           FileName = paths[i] + "/" + _FileName;
-           QFileInfo fin(FileName);
-           if(fin.exists()) {
-             fileFound = true;
-             break;
-           }
-        }
-
-    // file was found in current directory
-    } else {
-        fileFound = true;
-    }
-
-    // return filename or null
-    if(fileFound) {
-        //printf("searchFile -- %s\n", qasc(FileName));
-        return FileName;
-    }
-    else return NULL;
+    // the current directory and then the path list, answered from the index of the display path
+    return displayPathIndex::instance()->find(_FileName);
 }
 
 QString searchFile::displayPath()
@@ -0,0 +1,202 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2014
+ *
+ *  Author:
+ *    Anton Mezger
+ *  Contact details:
+ *    anton.mezger@psi.ch
+ */
+
+#if defined(_MSC_VER)
+#define NOMINMAX
+#include <float.h>
+#define QWT_DLL
+#if (_MSC_VER == 1600)
+  #define INFINITY (DBL_MAX+DBL_MAX)
+  #define NAN (INFINITY-INFINITY)
+#endif
+#endif
+
+#include <math.h>
+#include <QPainter>
+#include <QPolygonF>
+#include <qnumeric.h>
+#include "stripplotcurves.h"
+
+StripplotHistory::StripplotHistory()
+{
+    Capacity = Curves = Head = 0;
+}
+
+void StripplotHistory::reset(int capacity, int curves)
+{
+    Capacity = qMax(capacity, 1);
+    Curves = qMax(curves, 0);
+    Head = 0;
+    Times.fill(0.0, Capacity);
+    Ranges.fill(QwtInterval(NAN, NAN), Capacity * Curves);
+}
+
+StripplotCurvesItem::StripplotCurvesItem(const StripplotHistory *history, QMutex *mutex)
+{
+    History = history;
+    Mutex = mutex;
+    CurvType = TimeCurv;
+    Interval = 0.0;
+    Offset = 0.0;
+    setItemAttribute(QwtPlotItem::Legend, false);
+    setRenderHint(QwtPlotItem::RenderAntialiased, true);
+}
+
+void StripplotCurvesItem::setCurveCount(int curves)
+{
+    Attributes.resize(curves);
+}
+
+void StripplotCurvesItem::setCurveVisible(int curve, bool visible)
+{
+    if(curve < 0 || curve >= Attributes.size()) return;
+    Attributes[curve].visible = visible;
+}
+
+void StripplotCurvesItem::setCurveStyle(int curve, const QColor &lineColor, const QColor &bandColor, bool fillUnder)
+{
+    if(curve < 0 || curve >= Attributes.size()) return;
+    Attributes[curve].lineColor = lineColor;
+    Attributes[curve].bandColor = bandColor;
+    Attributes[curve].fillUnder = fillUnder;
+}
+
+void StripplotCurvesItem::setInterval(curvType type, double interval, double offset)
+{
+    CurvType = type;
+    Interval = interval;
+    Offset = offset;
+}
+
+void StripplotCurvesItem::draw(QPainter *painter, const QwtScaleMap &xMap, const QwtScaleMap &yMap, const QRectF &canvasRect) const
+{
+    QMutexLocker locker(Mutex);
+    const int curves = qMin(History->curveCount(), Attributes.size());
+    if(curves < 1 || History->capacity() < 2) return;
+
+    // map the common time base once for all curves, stop at the first point outside the interval
+    QVector<double> xs;
+    xs.reserve(History->capacity());
+    const double xStart = History->time(0) - Offset;
+    for(int slot = 0; slot < History->capacity(); slot++) {
+        double x = History->time(slot) - Offset;
+        if(slot > 0) {
+            if((CurvType == ValueCurv) && (x < -Interval)) break;
+            else if((CurvType == TimeCurv) && ((x - xStart) < -Interval)) break;
+        }
+        xs.append(xMap.transform(x));
+    }
+    if(xs.size() < 2) return;
+
+    painter->save();
+    painter->setClipRect(canvasRect, Qt::IntersectClip);
+
+    // fill under is drawn to the zero line or to the bottom when it cannot be mapped
+    double refY = yMap.transform(0.0);
+    if(qIsNaN(refY) || qIsInf(refY)) refY = canvasRect.bottom();
+    refY = qBound(canvasRect.top() - 1.0, refY, canvasRect.bottom() + 1.0);
+
+    // fills first, the bands of all curves have to be on top of them
+    for(int c = 0; c < curves; c++) {
+        if(Attributes.at(c).visible && Attributes.at(c).fillUnder) drawFill(painter, xs, yMap, c, refY);
+    }
+    for(int c = 0; c < curves; c++) {
+        if(Attributes.at(c).visible) drawBand(painter, xs, yMap, c);
+    }
+
+    painter->restore();
+}
+
+// the middle of the minimum and maximum of every point, filled to the reference line
+void StripplotCurvesItem::drawFill(QPainter *painter, const QVector<double> &xs, const QwtScaleMap &yMap, int curve, double refY) const
+{
+    const CurveAttributes &attr = Attributes.at(curve);
+    QPolygonF line;
+    line.reserve(xs.size() + 2);
+
+    for(int slot = 0; slot <= xs.size(); slot++) {
+        bool valid = false;
+        double y = 0.0;
+        if(slot < xs.size()) {
+            const QwtInterval &range = History->range(curve, slot);
+            y = (range.minValue() + range.maxValue()) / 2;
+            valid = !qIsNaN(y);
+        }
+
+        // end of a continuous segment
+        if(!valid) {
+            if(line.size() > 1) {
+                QPolygonF area(line);
+                area << QPointF(line.last().x(), refY) << QPointF(line.first().x(), refY);
+                painter->setPen(Qt::NoPen);
+                painter->setBrush(QBrush(attr.lineColor, Qt::SolidPattern));
+                painter->drawPolygon(area);
+                painter->setPen(QPen(attr.lineColor, 0));
+                painter->setBrush(Qt::NoBrush);
+                painter->drawPolyline(line);
+            }
+            line.clear();
+            continue;
+        }
+        line << QPointF(xs.at(slot), yMap.transform(y));
+    }
+}
+
+// the band between minimum and maximum of every point
+void StripplotCurvesItem::drawBand(QPainter *painter, const QVector<double> &xs, const QwtScaleMap &yMap, int curve) const
+{
+    const CurveAttributes &attr = Attributes.at(curve);
+    QPolygonF minLine, maxLine;
+    minLine.reserve(xs.size());
+    maxLine.reserve(xs.size());
+
+    for(int slot = 0; slot <= xs.size(); slot++) {
+        bool valid = false;
+        if(slot < xs.size()) {
+            const QwtInterval &range = History->range(curve, slot);
+            valid = !qIsNaN(range.minValue()) && !qIsNaN(range.maxValue());
+            if(valid) {
+                minLine << QPointF(xs.at(slot), yMap.transform(range.minValue()));
+                maxLine << QPointF(xs.at(slot), yMap.transform(range.maxValue()));
+                continue;
+            }
+        }
+
+        // end of a continuous segment
+        if(minLine.size() > 1) {
+            QPolygonF tube(minLine);
+            for(int i = maxLine.size() - 1; i >= 0; i--) tube << maxLine.at(i);
+            painter->setPen(Qt::NoPen);
+            painter->setBrush(QBrush(attr.bandColor, Qt::SolidPattern));
+            painter->drawPolygon(tube);
+            painter->setPen(QPen(attr.bandColor, 0));
+            painter->setBrush(Qt::NoBrush);
+            painter->drawPolyline(minLine);
+            painter->drawPolyline(maxLine);
+        }
+        minLine.clear();
+        maxLine.clear();
+    }
+}
@@ -0,0 +1,117 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2014
+ *
+ *  Author:
+ *    Anton Mezger
+ *  Contact details:
+ *    anton.mezger@psi.ch
+ */
+
+#ifndef STRIPPLOTCURVES_H
+#define STRIPPLOTCURVES_H
+
+#include <QVector>
+#include <QColor>
+#include <QMutex>
+#include <qwt_plot_item.h>
+#include <qwt_scale_map.h>
+#include <qwt_interval.h>
+#include <qtcontrols_global.h>
+
+enum curvType {TimeCurv=0, ValueCurv};
+
+// history of all the curves of a stripplot with one common time base
+// the slots are organized as a ring, slot 0 is always the newest one, so that advancing
+// the history is O(1); the data of one curve are contiguous for drawing
+
+class QTCON_EXPORT StripplotHistory
+{
+public:
+    StripplotHistory();
+
+    void reset(int capacity, int curves);
+
+    int capacity() const { return Capacity; }
+    int curveCount() const { return Curves; }
+
+    // make a new slot 0 for all curves, the oldest slot gets overwritten
+    void advance() { if(++Head >= Capacity) Head = 0; }
+
+    double time(int slot) const { return Times.at(index(slot)); }
+    const QwtInterval &range(int curve, int slot) const { return Ranges.at(curve * Capacity + index(slot)); }
+
+    void setTime(double time) { Times[Head] = time; }
+    void setRange(int curve, const QwtInterval &range) { Ranges[curve * Capacity + Head] = range; }
+
+private:
+    int index(int slot) const {
+        int i = Head - slot;
+        if(i < 0) i += Capacity;
+        return i;
+    }
+
+    QVector<double> Times;
+    QVector<QwtInterval> Ranges;
+    int Capacity, Curves, Head;
+};
+
+// one plot item drawing all curves of a stripplot in one pass: the common time base is
+// mapped once and every curve is drawn with one polygon per continuous segment, instead
+// of having two plot items per curve drawing segment by segment; the history is read under
+// the mutex given, which the thread collecting the data holds while writing it
+
+class QTCON_EXPORT StripplotCurvesItem : public QwtPlotItem
+{
+public:
+    enum {Rtti_StripplotCurves = QwtPlotItem::Rtti_PlotUserItem + 1};
+
+    StripplotCurvesItem(const StripplotHistory *history, QMutex *mutex = 0);
+
+    virtual int rtti() const { return Rtti_StripplotCurves; }
+    virtual void draw(QPainter *painter, const QwtScaleMap &xMap, const QwtScaleMap &yMap, const QRectF &canvasRect) const;
+
+    void setCurveCount(int curves);
+    void setCurveVisible(int curve, bool visible);
+    void setCurveStyle(int curve, const QColor &lineColor, const QColor &bandColor, bool fillUnder);
+
+    // curves are drawn until their points get older than the interval; the offset is
+    // subtracted from the time base (actual time for the fixed scale, otherwise 0)
+    void setInterval(curvType type, double interval, double offset);
+
+private:
+    struct CurveAttributes {
+        CurveAttributes() : visible(false), fillUnder(false) {}
+        bool visible;
+        bool fillUnder;
+        QColor lineColor;
+        QColor bandColor;
+    };
+
+    void drawFill(QPainter *painter, const QVector<double> &xs, const QwtScaleMap &yMap, int curve, double refY) const;
+    void drawBand(QPainter *painter, const QVector<double> &xs, const QwtScaleMap &yMap, int curve) const;
+
+    const StripplotHistory *History;
+    QMutex *Mutex;
+    QVector<CurveAttributes> Attributes;
+    curvType CurvType;
+    double Interval;
+    double Offset;
+};
+
+#endif // STRIPPLOTCURVES_H
@@ -0,0 +1,145 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2014
+ *
+ *  Author:
+ *    Anton Mezger
+ *  Contact details:
+ *    anton.mezger@psi.ch
+ */
+
+
+#include <QFile>
+#include <QFileInfo>
+#include <QBuffer>
+#include <QMutexLocker>
+#include "uifilecache.h"
+#include "displayimage.h"
+
+uiFileCache::uiFileCache()
+{
+    _Watcher = new QFileSystemWatcher(this);
+    _Hits = _Misses = 0;
+    connect(_Watcher, SIGNAL(fileChanged(const QString &)), this, SLOT(fileChanged(const QString &)));
+}
+
+uiFileCache *uiFileCache::instance()
+{
+    static uiFileCache *cache = (uiFileCache *) 0;
+    if(cache == (uiFileCache *) 0) cache = new uiFileCache();
+    return cache;
+}
+
+// entry of a file, a new one when the file is not known yet or was changed on disk; the mutex is held
+uiFileCache::Entry &uiFileCache::entry(const QFileInfo &fi)
+{
+    QString key = fi.absoluteFilePath();
+    QMap<QString, Entry>::iterator it = _Entries.find(key);
+    if(it != _Entries.end()) {
+        if(it.value().modified == fi.lastModified() && it.value().size == fi.size()) return it.value();
+        _Entries.erase(it);
+    }
+
+    Entry entry;
+    entry.compiled = false;
+    entry.modified = fi.lastModified();
+    entry.size = fi.size();
+    if(!_Watcher->files().contains(key)) _Watcher->addPath(key);
+    return _Entries.insert(key, entry).value();
+}
+
+QByteArray uiFileCache::content(const QString &fileName)
+{
+    QFileInfo fi(fileName);
+    if(!fi.exists()) return QByteArray();
+    QMutexLocker locker(&_Mutex);
+
+    Entry &cached = entry(fi);
+    if(!cached.data.isEmpty()) {
+        _Hits++;
+        return cached.data;
+    }
+
+    QFile file(fi.absoluteFilePath());
+    if(!file.open(QFile::ReadOnly)) return QByteArray();
+    cached.data = file.readAll();
+    file.close();
+    _Misses++;
+    return cached.data;
+}
+
+QByteArray uiFileCache::image(const QString &fileName)
+{
+    QFileInfo fi(fileName);
+    if(!fi.exists()) return QByteArray();
+    QMutexLocker locker(&_Mutex);
+
+    Entry &cached = entry(fi);
+    if(cached.compiled) {
+        if(!cached.image.isEmpty()) _Hits++;
+        return cached.image;
+    }
+
+    // compiled only once, also when the compiler refuses the file
+    QString error;
+    cached.compiled = true;
+    if(!DisplayImage::compile(fi.absoluteFilePath(), cached.image, error)) cached.image.clear();
+    else _Misses++;
+    return cached.image;
+}
+
+QWidget *uiFileCache::load(QUiLoader *loader, const QString &fileName, QWidget *parent)
+{
+    QByteArray templateImage = image(fileName);
+    if(!templateImage.isEmpty()) {
+        DisplayImage display;
+        if(display.open(templateImage)) {
+            QWidget *widget = display.build(loader, parent);
+            if(widget != (QWidget *) 0) return widget;
+        }
+
+        // the builder can not use it (tool bars, ...), parse the file from now on
+        QMutexLocker locker(&_Mutex);
+        entry(QFileInfo(fileName)).image.clear();
+    }
+
+    QByteArray data = content(fileName);
+    if(data.isEmpty()) return (QWidget *) 0;
+
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::ReadOnly);
+    QWidget *widget = loader->load(&buffer, parent);
+    buffer.close();
+    return widget;
+}
+
+void uiFileCache::clear()
+{
+    QMutexLocker locker(&_Mutex);
+    _Entries.clear();
+    if(!_Watcher->files().isEmpty()) _Watcher->removePaths(_Watcher->files());
+}
+
+void uiFileCache::fileChanged(const QString &fileName)
+{
+    QMutexLocker locker(&_Mutex);
+    _Entries.remove(fileName);
+
+    // editors replacing the file remove it from the watcher
+    if(QFileInfo(fileName).exists() && !_Watcher->files().contains(fileName)) _Watcher->addPath(fileName);
+}
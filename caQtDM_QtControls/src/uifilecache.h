@@ -0,0 +1,89 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2014
+ *
+ *  Author:
+ *    Anton Mezger
+ *  Contact details:
+ *    anton.mezger@psi.ch
+ */
+
+#ifndef UIFILECACHE_H
+#define UIFILECACHE_H
+
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QMap>
+#include <QMutex>
+#include <QFileSystemWatcher>
+#include <QWidget>
+#include <QtUiTools/QUiLoader>
+#include <qtcontrols_global.h>
+
+// process wide cache of the display files loaded by includes, the same file included many
+// times is parsed only once: it is compiled in memory into a display image, the template
+// all further instances are built from. files the image can not describe are read once and
+// parsed by the ui loader from the cached content. an entry is dropped when the file watcher
+// reports a change and it is verified against the modification time and size before being used
+
+class QTCON_EXPORT uiFileCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    static uiFileCache *instance();
+
+    // content of the file, empty when it could not be read
+    QByteArray content(const QString &fileName);
+
+    // compiled template of the file, empty when the file can not be described by an image
+    QByteArray image(const QString &fileName);
+
+    // build the display from its template, otherwise load it with the given loader from the cached content
+    QWidget *load(QUiLoader *loader, const QString &fileName, QWidget *parent);
+
+    void clear();
+    int hits() const { return _Hits; }
+    int misses() const { return _Misses; }
+
+private slots:
+    void fileChanged(const QString &fileName);
+
+private:
+    uiFileCache();
+
+    struct Entry {
+        QByteArray image;
+        QByteArray data;
+        bool compiled;
+        QDateTime modified;
+        qint64 size;
+    };
+
+    Entry &entry(const QFileInfo &fi);
+
+    QMap<QString, Entry> _Entries;
+    QFileSystemWatcher *_Watcher;
+    QMutex _Mutex;
+    int _Hits, _Misses;
+};
+
+#endif // UIFILECACHE_H
@@ -0,0 +1,35 @@
+# opens archivePlots.ui against the data api stub for several time windows and reports the bins asked for:
+# without nrOfBins the bin width is the time of a pixel rounded down to a power of two seconds, so that a
+# window is covered by one to two bins per pixel of the plot (196 pixels wide at most), never by raw data
+#    sh archiveBins.sh [secondsPast ...]
+export CAQTDM_ARCHIVERSF_URL=http://localhost:8766/sf/query
+export CAQTDM_ARCHIVE_CACHE=none
+failed=0
+for secondsPast in ${@:-3600 86400 604800}; do
+    rm -f /tmp/dataApiStub.log
+    python3 dataApiBench/dataApiStub.py -synthetic 10 -log /tmp/dataApiStub.log &
+    server=$!
+    sleep 1
+    caQtDM -noMsg -macro "secondsPast=$secondsPast,secondsUpdate=10" archivePlots &
+    pid=$!
+    sleep 20
+    kill $pid
+    kill $server
+
+    # only the first query of every channel, the later ones are the updates
+    awk -v secondsPast=$secondsPast '
+        !($2 in q) {
+            q[$2] = 1; n++
+            if($5 !~ /^PT[0-9]+S$/) {wrong++; next}
+            width = substr($5, 3) + 0
+            bins = secondsPast / width
+            if(n == 1 || bins < least) least = bins
+            if(n == 1 || bins > most) most = bins
+            if(bins < 32 || bins > 2 * 196) wrong++
+        }
+        END {
+            printf("archiveBins -- %d s: %d channels, %.0f to %.0f bins per window, %d not binned by the pixels\n", secondsPast, n, least, most, wrong)
+            if(n == 0 || wrong > 0) exit 1
+        }' /tmp/dataApiStub.log || failed=1
+done
+exit $failed
@@ -0,0 +1,34 @@
+# opens archivePlots.ui twice against the data api stub with an empty disk cache: the first open has to
+# query the whole day of every plot, the second may only query what is not in the closed chunks of the
+# cache (chunks of an hour, closed 5 minutes after their end), so its ranges start at most 2 hours back
+#    sh archiveCache.sh [secondsPast]
+secondsPast=${1:-86400}
+rm -f /tmp/dataApiStub.log
+rm -rf /tmp/archiveCacheTest
+python3 dataApiBench/dataApiStub.py -synthetic 1 -log /tmp/dataApiStub.log &
+server=$!
+sleep 1
+
+export CAQTDM_ARCHIVERSF_URL=http://localhost:8766/sf/query
+export CAQTDM_ARCHIVE_CACHE=/tmp/archiveCacheTest
+caQtDM -noMsg -macro "secondsPast=$secondsPast,secondsUpdate=10" archivePlots &
+pid=$!
+sleep 30
+kill $pid
+first=$(wc -l < /tmp/dataApiStub.log)
+
+caQtDM -noMsg -macro "secondsPast=$secondsPast,secondsUpdate=10" archivePlots &
+pid=$!
+sleep 30
+kill $pid
+kill $server
+
+# only the first query of every channel in each open, the later ones are the updates
+awk -v first=$first -v secondsPast=$secondsPast '
+    NR <= first && !($2 in q1) {q1[$2] = 1; n1++; span1 += $4 - $3}
+    NR > first  && !($2 in q2) {q2[$2] = 1; n2++; span2 += $4 - $3; if($1 - $3 > 7200) full++}
+    END {
+        printf("archiveCache -- first open: %d channels, %.0f s asked for on average\n", n1, n1 ? span1 / n1 : 0)
+        printf("archiveCache -- second open: %d channels, %.0f s asked for on average, %d asked for more than 2 hours\n", n2, n2 ? span2 / n2 : 0, full)
+        if(n1 == 0 || n2 == 0 || span1 / n1 < 0.9 * secondsPast || full > 0) exit 1
+    }' /tmp/dataApiStub.log
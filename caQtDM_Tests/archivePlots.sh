@@ -0,0 +1,25 @@
+# opens archivePlots.ui (50 plots of an archived channel each) against the data api stub, which
+# answers with synthetic data and holds back every reply by 0.5 s, without the disk cache: the queries
+# may only be answered a few at a time (at most 4 in parallel for the backend), but all have to arrive
+#    sh archivePlots.sh [secondsPast]
+secondsPast=${1:-86400}
+rm -f /tmp/dataApiStub.log
+python3 dataApiBench/dataApiStub.py -synthetic 1 -delay 0.5 -log /tmp/dataApiStub.log &
+server=$!
+sleep 1
+
+export CAQTDM_ARCHIVERSF_URL=http://localhost:8766/sf/query
+export CAQTDM_ARCHIVE_CACHE=none
+caQtDM -noMsg -macro "secondsPast=$secondsPast,secondsUpdate=10" archivePlots &
+pid=$!
+sleep 30
+kill $pid
+kill $server
+
+awk '
+    {n++; channels[$2]++; if($6 > parallel) parallel = $6; ms += $8}
+    END {
+        for(c in channels) distinct++
+        printf("archivePlots -- %d queries for %d channels, at most %d in parallel, %.0f ms per reply\n", n, distinct, parallel, n ? ms / n : 0)
+        if(distinct < 50 || parallel > 4) exit 1
+    }' /tmp/dataApiStub.log
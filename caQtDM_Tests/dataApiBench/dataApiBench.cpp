@@ -0,0 +1,187 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2014
+ *
+ *  Author:
+ *    Anton Mezger
+ *  Contact details:
+ *    anton.mezger@psi.ch
+ */
+
+// benchmark of the decoding of data api replies (archiveSF plugin), replayed by dataApiStub.py:
+// every channel is queried raw and binned as the plugin does, the reply is decoded by sfDecoder
+// and, with -former, by the decoding used before (SimpleJSON document, every sample stringified
+// and parsed again, the numbers read with swscanf)
+//    dataApiBench [-url url] [-former] channel ...     url defaults to http://localhost:8766/sf/query
+
+#include <QCoreApplication>
+#include <QNetworkAccessManager>
+#include <QNetworkRequest>
+#include <QNetworkReply>
+#include <QEventLoop>
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <QStringList>
+#include <QVector>
+#include <stdio.h>
+#include <wchar.h>
+#include "sfDecoder.h"
+#include "JSON.h"
+
+#define qasc(x) x.toLatin1().constData()
+
+// the query of the plugin, with all the samples recorded being newer than the range asked for
+static QByteArray query(const QString &channel, bool binned)
+{
+    QString total = "{'response':{'format':'json'},'range': { 'startSeconds' : '0', 'endSeconds' : '4000000000'},"
+                    "'channels': [ {'name':'" + channel + "' }],'fields':['channel','globalSeconds','value']";
+    if(binned) total += ", 'aggregation': {'aggregationType':'value', 'aggregations':['min','mean','max'], 'nrOfBins' : 1000}";
+    total += "}";
+    return total.replace("'", "\"").toUtf8();
+}
+
+static QByteArray fetch(QNetworkAccessManager &manager, const QUrl &url, const QByteArray &json, QString &error)
+{
+    QNetworkRequest request(url);
+    request.setRawHeader("Content-Type", "application/json");
+    QNetworkReply *reply = manager.post(request, json);
+    QEventLoop loop;
+    QObject::connect(reply, SIGNAL(finished()), &loop, SLOT(quit()));
+    loop.exec();
+
+    QByteArray data;
+    QVariant status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute);
+    if(reply->error() || status.toInt() != 200) error = QString("http status %1 from %2").arg(status.toInt()).arg(url.toString());
+    else data = reply->readAll();
+    reply->deleteLater();
+    return data;
+}
+
+// the data part of sfRetrieval::finishReply before sfDecoder
+static int formerDecode(const QByteArray &reply, bool binned, double seconds, double secondsPast, QVector<double> &X, QVector<double> &Y)
+{
+    int count = 0;
+    QString out = QString(reply);
+    JSONValue *value = JSON::Parse(qasc(out));
+    if(value == NULL) return -1;
+
+    if(value->IsArray()) {
+        JSONArray array = value->AsArray();
+        for(unsigned int i = 0; i < array.size(); i++) {
+            JSONValue *value1 = JSON::Parse(array[i]->Stringify().c_str());
+            if(value1->IsObject()) {
+                JSONObject root = value1->AsObject();
+                if(root.find(L"data") != root.end() && root[L"data"]->IsArray()) {
+                    JSONArray data = root[L"data"]->AsArray();
+                    X.resize(data.size());
+                    Y.resize(data.size());
+                    for(unsigned int j = 0; j < data.size(); j++) {
+                        bool valueFound = false;
+                        bool timeFound = false;
+                        double mean = 0.0;
+                        double archiveTime = 0.0;
+                        JSONObject root1 = data[j]->AsObject();
+                        if(binned) {
+                            if(root1.find(L"value") != root1.end() && root1[L"value"]->IsObject()) {
+                                JSONValue *value2 = JSON::Parse(root1[L"value"]->Stringify().c_str());
+                                JSONObject root2 = value2->AsObject();
+                                if(root2.find(L"mean") != root2.end() && root2[L"mean"]->IsNumber()) {
+                                    swscanf(root2[L"mean"]->Stringify().c_str(), L"%lf", &mean);
+                                    valueFound = true;
+                                }
+                                delete value2;
+                            }
+                        } else if(root1.find(L"value") != root1.end() && root1[L"value"]->IsNumber()) {
+                            swscanf(root1[L"value"]->Stringify().c_str(), L"%lf", &mean);
+                            valueFound = true;
+                        }
+                        if(root1.find(L"globalSeconds") != root1.end() && root1[L"globalSeconds"]->IsString()) {
+                            archiveTime = QString::fromWCharArray(root1[L"globalSeconds"]->AsString().c_str()).toDouble(&timeFound);
+                        }
+                        if(timeFound && valueFound && (seconds - archiveTime) < secondsPast) {
+                            X[count] = -(seconds - archiveTime) / 3600.0;
+                            Y[count] = mean;
+                            count++;
+                        }
+                    }
+                }
+            }
+            delete value1;
+        }
+    }
+    delete value;
+    return count;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QUrl url("http://localhost:8766/sf/query");
+    bool former = false;
+    QStringList channels;
+
+    QStringList args = app.arguments();
+    for(int i = 1; i < args.count(); i++) {
+        if(args.at(i) == "-url" && i + 1 < args.count()) url = QUrl(args.at(++i));
+        else if(args.at(i) == "-former") former = true;
+        else channels.append(args.at(i));
+    }
+    if(channels.isEmpty()) {
+        printf("usage: dataApiBench [-url url] [-former] channel ...\n");
+        return 1;
+    }
+
+    QNetworkAccessManager manager;
+    double seconds = (double) QDateTime::currentMSecsSinceEpoch() / 1000.0;
+    double secondsPast = seconds;
+
+    foreach(QString channel, channels) {
+        for(int binned = 0; binned < 2; binned++) {
+            QString error;
+            QElapsedTimer timer;
+            timer.start();
+            QByteArray reply = fetch(manager, url, query(channel, binned), error);
+            qint64 fetchTime = timer.elapsed();
+            if(!error.isEmpty()) {
+                printf("dataApiBench -- %s: %s\n", qasc(channel), qasc(error));
+                return 1;
+            }
+
+            QVector<double> X, Y;
+            timer.restart();
+            sfDecoder decoder(reply, binned);
+            bool ok = decoder.decode(seconds, secondsPast, X, Y);
+            qint64 decodeTime = timer.elapsed();
+            if(!ok) {
+                printf("dataApiBench -- %s: %s\n", qasc(channel), qasc(decoder.lastError()));
+                return 1;
+            }
+            printf("%s %s -- %d bytes fetched in %lld ms, %d samples decoded in %lld ms",
+                   qasc(channel), binned ? "binned" : "raw", reply.size(), (long long) fetchTime, decoder.count(), (long long) decodeTime);
+
+            if(former) {
+                QVector<double> formerX, formerY;
+                timer.restart();
+                int count = formerDecode(reply, binned, seconds, secondsPast, formerX, formerY);
+                printf(", former decoding %d samples in %lld ms", count, (long long) timer.elapsed());
+            }
+            printf("\n");
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,25 @@
+# benchmark of the decoding of data api replies, not part of the build of caQtDM:
+#    qmake && make
+#    python3 dataApiStub.py -generate TEST:CHANNEL 1000000 ; python3 dataApiStub.py &
+#    ./dataApiBench -former TEST:CHANNEL
+include(../../caQtDM_Viewer/qtdefs.pri)
+
+QT += core network
+QT -= gui
+CONFIG += console
+CONFIG -= app_bundle
+TEMPLATE = app
+INCLUDEPATH += .
+INCLUDEPATH += ../../caQtDM_Lib/caQtDM_Plugins/archive/archiveSF
+INCLUDEPATH += ../../caQtDM_Lib/src
+OBJECTS_DIR = obj
+
+# the decoder of the plugin and, for the comparison, the json parser it replaced
+DEFINES += CAQTDM_LIB_LIBRARY
+HEADERS += ../../caQtDM_Lib/caQtDM_Plugins/archive/archiveSF/sfDecoder.h
+SOURCES += dataApiBench.cpp \
+    ../../caQtDM_Lib/caQtDM_Plugins/archive/archiveSF/sfDecoder.cpp \
+    ../../caQtDM_Lib/src/JSON.cpp \
+    ../../caQtDM_Lib/src/JSONValue.cpp
+
+TARGET = dataApiBench
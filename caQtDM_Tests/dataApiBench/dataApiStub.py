@@ -0,0 +1,187 @@
+#!/usr/bin/env python3
+# local http stub of the data api for the archiveSF plugin and dataApiBench, python 3.7 or later:
+#    python3 dataApiStub.py [-port port] [-dir replies] [-record url] [-log file]
+#    python3 dataApiStub.py [-port port] -synthetic period [-delay seconds] [-log file]
+#    python3 dataApiStub.py [-dir replies] -generate channel samples
+# a query (POST of the json request) is answered with the recorded reply of its channel, from
+# <dir>/<channel>.json for raw data and <dir>/<channel>.binned.json for an aggregation, regardless
+# of the range asked for. with -record the queries are forwarded to the data api at url and the
+# replies are recorded, so that they can be replayed later without the archiver. -generate writes
+# a raw and a binned reply of the given number of samples in the format of the data api, ending now.
+# with -synthetic every query is answered with a sample every period seconds over the range asked for,
+# aggregated into the bins asked for, so that archive displays can be opened without any recording;
+# -delay holds back every reply, as with a loaded archiver.
+# one line per query is logged: time, channel, start and end of the range, the bins asked for
+# (nrOfBins, PT<n>S or raw), the queries answered at the same time, the bytes and the milliseconds taken
+import sys
+import os
+import re
+import json
+import time
+import math
+import threading
+import urllib.request
+from http.server import ThreadingHTTPServer, BaseHTTPRequestHandler
+
+port = 8766
+replies = os.path.join(os.path.dirname(os.path.abspath(__file__)), "replies")
+recordUrl = None
+generate = None
+synthetic = None
+delay = 0.0
+logFile = None
+args = sys.argv[1:]
+while args:
+    arg = args.pop(0)
+    if arg == "-port" and args:
+        port = int(args.pop(0))
+    elif arg == "-dir" and args:
+        replies = os.path.abspath(args.pop(0))
+    elif arg == "-record" and args:
+        recordUrl = args.pop(0).rstrip("/")
+    elif arg == "-generate" and len(args) >= 2:
+        generate = (args.pop(0), int(args.pop(0)))
+    elif arg == "-synthetic" and args:
+        synthetic = float(args.pop(0))
+    elif arg == "-delay" and args:
+        delay = float(args.pop(0))
+    elif arg == "-log" and args:
+        logFile = open(args.pop(0), "w")
+    else:
+        print("usage: dataApiStub.py [-port port] [-dir replies] [-record url] [-log file]")
+        print("       dataApiStub.py [-port port] -synthetic period [-delay seconds] [-log file]")
+        print("       dataApiStub.py [-dir replies] -generate channel samples")
+        sys.exit(1)
+
+def replyFile(channel, binned):
+    name = re.sub(r"[^A-Za-z0-9_.-]", "_", channel)
+    return os.path.join(replies, name + (".binned.json" if binned else ".json"))
+
+def writeGenerated(channel, samples):
+    os.makedirs(replies, exist_ok=True)
+    end = time.time()
+    header = '[{"channel":{"name":"%s","backend":"sf-databuffer"},"data":[' % channel
+    for binned in (False, True):
+        with open(replyFile(channel, binned), "w") as f:
+            f.write(header)
+            for i in range(samples):
+                seconds = end - (samples - i) * 0.01
+                value = math.sin(i * 0.001) * 100.0 + (i % 7) * 0.125
+                if binned:
+                    sample = '{"globalSeconds":"%.9f","value":{"min":%.6f,"mean":%.6f,"max":%.6f}}' % (seconds, value - 1.0, value, value + 1.0)
+                else:
+                    sample = '{"globalSeconds":"%.9f","value":%.6f}' % (seconds, value)
+                f.write(sample if i == 0 else "," + sample)
+            f.write("]}]")
+        print("dataApiStub -- %s written" % replyFile(channel, binned))
+
+lock = threading.Lock()
+active = 0
+
+def log(line):
+    with lock:
+        out = logFile if logFile else sys.stdout
+        out.write(line + "\n")
+        out.flush()
+
+def binsOf(query):
+    aggregation = query.get("aggregation")
+    if aggregation is None:
+        return "raw"
+    if "nrOfBins" in aggregation:
+        return str(aggregation["nrOfBins"])
+    return str(aggregation.get("durationPerBin", "raw"))
+
+# samples every period seconds from begin to end, the mean of a bin is the value at its start
+def syntheticReply(channel, begin, end, bins):
+    end = min(end, time.time())
+    width = 0.0
+    if re.match(r"^PT\d+S$", bins):
+        width = float(bins[2:-1])
+    elif bins != "raw" and int(bins) > 0:
+        width = (end - begin) / int(bins)
+    step = max(width, synthetic)
+    samples = []
+    t = math.ceil(begin / step) * step
+    while t <= end and len(samples) < 2000000:
+        value = math.sin(t / 600.0) * 100.0
+        if bins == "raw":
+            samples.append('{"globalSeconds":"%.9f","value":%.6f}' % (t, value))
+        else:
+            samples.append('{"globalSeconds":"%.9f","value":{"min":%.6f,"mean":%.6f,"max":%.6f}}' % (t, value - 1.0, value, value + 1.0))
+        t += step
+    return ('[{"channel":{"name":"%s","backend":"sf-databuffer"},"data":[' % channel + ",".join(samples) + "]}]").encode("utf-8")
+
+class Stub(BaseHTTPRequestHandler):
+
+    def do_POST(self):
+        global active
+        with lock:
+            active += 1
+            parallel = active
+        try:
+            self.answer(parallel)
+        finally:
+            with lock:
+                active -= 1
+
+    def answer(self, parallel):
+        start = time.time()
+        body = self.rfile.read(int(self.headers.get("Content-Length", 0)))
+        try:
+            query = json.loads(body.decode("utf-8"))
+            channel = query["channels"][0]["name"]
+            begin = float(query["range"]["startSeconds"])
+            end = float(query["range"]["endSeconds"])
+        except (ValueError, KeyError, IndexError, TypeError):
+            self.send_error(400, "not a data api query")
+            return
+        binned = "aggregation" in query
+        bins = binsOf(query)
+        fileName = replyFile(channel, binned)
+
+        time.sleep(delay)
+        if synthetic is not None:
+            data = syntheticReply(channel, begin, end, bins)
+        elif recordUrl is not None:
+            request = urllib.request.Request(recordUrl + self.path, data=body, headers={"Content-Type": "application/json"})
+            try:
+                with urllib.request.urlopen(request) as answer:
+                    data = answer.read()
+            except Exception as e:
+                self.send_error(502, str(e))
+                return
+            os.makedirs(replies, exist_ok=True)
+            with open(fileName, "wb") as f:
+                f.write(data)
+        elif os.path.isfile(fileName):
+            with open(fileName, "rb") as f:
+                data = f.read()
+        else:
+            self.send_error(404, "no reply recorded for " + channel)
+            return
+
+        self.send_response(200)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(data)))
+        self.end_headers()
+        self.wfile.write(data)
+        log("%.3f %s %.0f %.0f %s %d %d %.1f" % (start, channel, begin, end, bins, parallel, len(data), (time.time() - start) * 1000.0))
+
+    def log_message(self, format, *args):
+        pass
+
+if generate is not None:
+    writeGenerated(*generate)
+    sys.exit(0)
+
+server = ThreadingHTTPServer(("localhost", port), Stub)
+if synthetic is not None:
+    print("dataApiStub -- synthetic replies with a sample every %g s on http://localhost:%d" % (synthetic, port))
+else:
+    print("dataApiStub -- replies from %s on http://localhost:%d" % (replies, port))
+sys.stdout.flush()
+try:
+    server.serve_forever()
+except KeyboardInterrupt:
+    pass
@@ -0,0 +1,17 @@
+# compiles displayImage.ui into its display image and opens it with a trace;
+# the display has to be built from the image, the ui file may not be parsed
+rm -f displayImage.uib /tmp/displayImage.json
+ui2uib displayImage.ui
+caQtDM -noMsg -trace /tmp/displayImage.json displayImage &
+pid=$!
+sleep 5
+kill $pid
+if ! grep -q '"name":"display image"' /tmp/displayImage.json; then
+    echo "displayImage -- no trace written"
+    exit 1
+fi
+if grep -q '"name":"ui file"' /tmp/displayImage.json; then
+    echo "displayImage -- the ui file was parsed, the display image was not used"
+    exit 1
+fi
+echo "displayImage -- built from displayImage.uib"
@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+# local stand-in for the http server of the displays (CAQTDM_URL_DISPLAY_PATH), python 3.7 or later:
+#    python3 httpStandIn.py [-port port] [-dir directory] [-delay seconds] [-log file]
+# serves the files of the directory with ETag and Last-Modified and answers a request carrying the
+# matching If-None-Match or If-Modified-Since with 304; every reply is delayed by -delay seconds, as
+# with a slow server. one line per request is logged: time, file, status and the number of requests
+# being answered at the same time, so that it can be seen whether the files were requested in parallel
+import sys
+import os
+import time
+import hashlib
+import threading
+from email.utils import formatdate, parsedate_to_datetime
+from http.server import ThreadingHTTPServer, BaseHTTPRequestHandler
+from urllib.parse import unquote, urlparse
+
+port = 8765
+root = os.path.dirname(os.path.abspath(__file__))
+delay = 0.0
+logFile = None
+args = sys.argv[1:]
+while args:
+    arg = args.pop(0)
+    if arg == "-port" and args:
+        port = int(args.pop(0))
+    elif arg == "-dir" and args:
+        root = os.path.abspath(args.pop(0))
+    elif arg == "-delay" and args:
+        delay = float(args.pop(0))
+    elif arg == "-log" and args:
+        logFile = open(args.pop(0), "w")
+    else:
+        print("usage: httpStandIn.py [-port port] [-dir directory] [-delay seconds] [-log file]")
+        sys.exit(1)
+
+lock = threading.Lock()
+active = 0
+
+def log(path, status, parallel):
+    line = "%.3f %s %d %d" % (time.time(), path, status, parallel)
+    with lock:
+        out = logFile if logFile else sys.stdout
+        out.write(line + "\n")
+        out.flush()
+
+class StandIn(BaseHTTPRequestHandler):
+
+    def do_GET(self):
+        global active
+        with lock:
+            active += 1
+            parallel = active
+        try:
+            time.sleep(delay)
+            status = self.answer()
+        finally:
+            with lock:
+                active -= 1
+        log(urlparse(self.path).path, status, parallel)
+
+    def answer(self):
+        path = os.path.normpath(unquote(urlparse(self.path).path)).lstrip("/")
+        fileName = os.path.join(root, path)
+        if path.startswith("..") or not os.path.isfile(fileName):
+            self.send_error(404)
+            return 404
+
+        with open(fileName, "rb") as f:
+            data = f.read()
+        mtime = int(os.path.getmtime(fileName))
+        etag = '"%s"' % hashlib.md5(data).hexdigest()
+        modified = formatdate(mtime, usegmt=True)
+
+        # cached copy of the client still valid
+        notModified = False
+        if self.headers.get("If-None-Match") is not None:
+            notModified = self.headers.get("If-None-Match") == etag
+        elif self.headers.get("If-Modified-Since") is not None:
+            try:
+                notModified = parsedate_to_datetime(self.headers.get("If-Modified-Since")).timestamp() >= mtime
+            except (TypeError, ValueError):
+                notModified = False
+
+        if notModified:
+            self.send_response(304)
+            self.send_header("ETag", etag)
+            self.end_headers()
+            return 304
+
+        self.send_response(200)
+        self.send_header("Content-Type", "application/octet-stream")
+        self.send_header("Content-Length", str(len(data)))
+        self.send_header("ETag", etag)
+        self.send_header("Last-Modified", modified)
+        self.end_headers()
+        self.wfile.write(data)
+        return 200
+
+    def log_message(self, format, *args):
+        pass
+
+server = ThreadingHTTPServer(("localhost", port), StandIn)
+print("httpStandIn -- serving %s on http://localhost:%d" % (root, port))
+sys.stdout.flush()
+try:
+    server.serve_forever()
+except KeyboardInterrupt:
+    pass
@@ -0,0 +1,11 @@
+# startup benchmark for include heavy displays: includeBench.ui includes the 30 widgets of
+# includeBench_item.ui 400 times; prints the time spent building the included widgets and
+# the time until the display was open, taken from the trace of the display
+rm -f /tmp/includeBench.json
+caQtDM -noMsg -trace /tmp/includeBench.json includeBench &
+pid=$!
+sleep 20
+kill $pid
+awk -F'"dur":' '/"name":"include load"/ {split($2, a, ","); n++; sum += a[1]}
+                /"name":"open"/ {split($2, a, ","); open = a[1]}
+                END {printf("includeBench -- %d includes loaded in %.1f ms, display open in %.1f ms\n", n, sum / 1000.0, open / 1000.0)}' /tmp/includeBench.json
@@ -0,0 +1,41 @@
+#!/usr/bin/env python
+# pv access server of a simulated areaDetector image stream for ndarray.ui, needs p4p and numpy:
+#    python ndarraySim.py [-rate frames/s] [-resize]
+# serves CAQTDM:TEST:NDARRAY, a 16 bit mono NTNDArray with a moving gradient; with -resize the
+# image changes between 640x480 and 320x240 every 5 seconds. keep the mouse pressed on the image
+# of the camera while frames come in: the intensity shown has to follow the image without crash
+import sys
+import time
+import numpy
+from p4p.nt import NTNDArray
+from p4p.server import Server
+from p4p.server.thread import SharedPV
+
+rate = 20.0
+resize = False
+args = sys.argv[1:]
+while args:
+    arg = args.pop(0)
+    if arg == "-rate" and args:
+        rate = float(args.pop(0))
+    elif arg == "-resize":
+        resize = True
+    else:
+        print("usage: ndarraySim.py [-rate frames/s] [-resize]")
+        sys.exit(1)
+
+def frame(count, width, height):
+    x = numpy.arange(width, dtype=numpy.uint32)
+    y = numpy.arange(height, dtype=numpy.uint32)[:, numpy.newaxis]
+    return ((x + y + count * 4) % 4096).astype(numpy.uint16)
+
+pv = SharedPV(nt=NTNDArray(), initial=frame(0, 640, 480))
+with Server(providers=[{"CAQTDM:TEST:NDARRAY": pv}]):
+    print("ndarraySim -- serving CAQTDM:TEST:NDARRAY at %.1f frames/s" % rate)
+    count = 0
+    start = time.time()
+    while True:
+        small = resize and int((time.time() - start) / 5.0) % 2 == 1
+        pv.post(frame(count, 320 if small else 640, 240 if small else 480))
+        count += 1
+        time.sleep(1.0 / rate)
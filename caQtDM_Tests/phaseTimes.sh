@@ -0,0 +1,23 @@
+# time spent in each phase of opening a display, taken from its trace and averaged over several
+# starts of caQtDM: loading the ui file, the widget scan (the includes are loaded during the scan),
+# the soft pvs, the flush of the monitors and the whole open
+#    sh phaseTimes.sh [display] [starts]
+display=${1:-speedTest}
+starts=${2:-5}
+rm -f /tmp/phaseTimes_*.json
+for i in $(seq $starts); do
+    caQtDM -noMsg -trace /tmp/phaseTimes_$i.json $display &
+    pid=$!
+    sleep 10
+    kill $pid
+done
+cat /tmp/phaseTimes_*.json | awk -F'"dur":' -v display=$display -v starts=$starts '
+    {split($1, n, "\""); split($2, a, ","); sum[n[4]] += a[1]}
+    END {
+        printf("%s -- average of %d starts\n", display, starts)
+        split("load scan include_load softpvs flush open", phases, " ")
+        for(i = 1; i <= 6; i++) {
+            phase = phases[i]; gsub("_", " ", phase)
+            printf("   %-13s %8.1f ms\n", phase, sum[phase] / starts / 1000.0)
+        }
+    }'
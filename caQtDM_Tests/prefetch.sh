@@ -0,0 +1,34 @@
+# opens tests.ui from the local http stand-in httpStandIn.py (each reply delayed by 0.5 s) with an
+# empty cache: the includes, related displays and images it references have to be requested in
+# parallel and each only once. opened a second time, the cached copies may only be revalidated (304)
+tests=$(pwd)
+rm -f /tmp/httpStandIn.log
+python3 httpStandIn.py -dir "$tests" -delay 0.5 -log /tmp/httpStandIn.log &
+server=$!
+sleep 1
+
+# started outside of this directory, so that no display is found locally
+mkdir -p /tmp/caQtDM
+cd /tmp/caQtDM
+export CAQTDM_DISPLAY_PATH=/tmp/caQtDM
+caQtDM -emptycache -noMsg -url http://localhost:8765 tests &
+pid=$!
+sleep 15
+kill $pid
+first=$(wc -l < /tmp/httpStandIn.log)
+
+caQtDM -noMsg -url http://localhost:8765 tests &
+pid=$!
+sleep 10
+kill $pid
+kill $server
+
+awk -v first=$first '
+    NR <= first {n1++; if($4 > 1) parallel++; if($3 == 200) files[$2]++}
+    NR > first  {n2++; if($3 == 200) transferred++}
+    END {
+        for(f in files) if(files[f] > 1) twice++
+        printf("prefetch -- first open: %d requests, %d answered in parallel, %d files requested twice\n", n1, parallel, twice)
+        printf("prefetch -- second open: %d requests, %d transferred again\n", n2, transferred)
+        if(parallel == 0 || twice > 0 || transferred > 0) exit 1
+    }' /tmp/httpStandIn.log
@@ -0,0 +1,74 @@
+#!/usr/bin/env python
+# pv access server of simulated scalar and enum channels for the pva test displays, needs p4p:
+#    python pvaSim.py [-rate updates/s] [-channels n] [-restart seconds]
+# serves CAQTDM:TEST:PVA:COUNT, a double counting up with its alarm severity going through no alarm,
+# minor and major every 10 counts, and CAQTDM:TEST:PVA:MODE, an enum stepping through its states every
+# 10 counts. in pvaFields.ui the value, the alarm colors and the time stamp (pv info) have to follow the
+# channels with the fields requested alone, as well as with a queue size and pipelining.
+# -channels serves CAQTDM:TEST:PVA:1 to n as well, counters for pvaChannels.ui; with -restart the server
+# goes away and comes back every given seconds, so that all channels disconnect and connect again while
+# their monitors may still be set up: every field of pvaChannels.ui has to come back each time.
+# pvaShared.ui opens the same channels from many widgets, which share one monitor per request: the
+# fields of a request have to show the same value at the same time, the ones limited to 2 Hz lag behind
+import sys
+import time
+from p4p.nt import NTScalar, NTEnum
+from p4p.server import Server
+from p4p.server.thread import SharedPV
+
+rate = 10.0
+channels = 0
+restart = 0.0
+args = sys.argv[1:]
+while args:
+    arg = args.pop(0)
+    if arg == "-rate" and args:
+        rate = float(args.pop(0))
+    elif arg == "-channels" and args:
+        channels = int(args.pop(0))
+    elif arg == "-restart" and args:
+        restart = float(args.pop(0))
+    else:
+        print("usage: pvaSim.py [-rate updates/s] [-channels n] [-restart seconds]")
+        sys.exit(1)
+
+modes = ["Off", "Standby", "On", "Fault"]
+scalar = NTScalar("d")
+enum = NTEnum()
+
+def counter(count):
+    value = scalar.wrap(float(count), timestamp=time.time())
+    value["alarm.severity"] = (count // 10) % 3
+    return value
+
+def mode(count):
+    return enum.wrap({"index": (count // 10) % len(modes), "choices": modes}, timestamp=time.time())
+
+count = SharedPV(nt=scalar, initial=counter(0))
+state = SharedPV(nt=enum, initial=mode(0))
+pvs = {"CAQTDM:TEST:PVA:COUNT": count, "CAQTDM:TEST:PVA:MODE": state}
+counters = [SharedPV(nt=scalar, initial=0.0) for i in range(channels)]
+for i in range(channels):
+    pvs["CAQTDM:TEST:PVA:%d" % (i + 1)] = counters[i]
+
+print("pvaSim -- serving CAQTDM:TEST:PVA:COUNT, CAQTDM:TEST:PVA:MODE and %d counters at %.1f updates/s" % (channels, rate))
+server = Server(providers=[pvs])
+started = time.time()
+n = 0
+try:
+    while True:
+        n += 1
+        count.post(counter(n))
+        if n % 10 == 0:
+            state.post(mode(n))
+        for i in range(channels):
+            counters[i].post(float(n + i))
+        if restart > 0.0 and time.time() - started > restart:
+            server.stop()
+            print("pvaSim -- restarting the server")
+            time.sleep(1.0)
+            server = Server(providers=[pvs])
+            started = time.time()
+        time.sleep(1.0 / rate)
+except KeyboardInterrupt:
+    server.stop()
@@ -0,0 +1,204 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2014
+ *
+ *  Author:
+ *    Anton Mezger
+ *  Contact details:
+ *    anton.mezger@psi.ch
+ */
+
+// benchmark of the python calcs (%P/) of a display: 500 widgets, each with its own PythonCalc of
+// 4 inputs, are evaluated once per tick. the former evaluation built a module and ran the source
+// of the function on every call, the current one keeps the compiled function and its argument
+// tuple per widget (CaQtDM_Lib::getPythonCalc); the python calls are the ones of CalcVisibility
+//    pythonCalcBench [calcs] [ticks]     defaults 500 calcs, 20 ticks
+
+#include <Python.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <sys/time.h>
+
+#define MAXMONITORS 4
+
+struct pythonCalc {
+    PyObject *module;
+    PyObject *function;
+    PyObject *arguments;
+};
+
+static double sink = 0.0;
+
+static double now()
+{
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+    return (double) tv.tv_sec * 1.0e6 + (double) tv.tv_usec;
+}
+
+static std::string calcSource(int i)
+{
+    char source[256];
+    snprintf(source, sizeof(source), "def PythonCalc(a, b, c, d):\n    return a * %d.0 + b - c / (d + 1.0)\n", i % 17 + 1);
+    return source;
+}
+
+static std::string moduleName(int i)
+{
+    char name[64];
+    snprintf(name, sizeof(name), "myModulecaCalc_%d", i);
+    return name;
+}
+
+static double input(int tick, int calc, int i)
+{
+    return (double) (tick + calc + i);
+}
+
+// the module, the function and the arguments are built for every evaluation
+static bool formerEval(const std::string &source, const std::string &name, int tick, int calc)
+{
+    Py_Initialize();
+    PyObject *pValueA[MAXMONITORS];
+    PyObject *pGlobal = PyDict_New();
+    PyDict_SetItemString(pGlobal, "__builtins__", PyEval_GetBuiltins());
+
+    PyObject *pNewMod = PyModule_New((char*) name.c_str());
+    PyModule_AddStringConstant(pNewMod, "__file__", "");
+    PyObject *pLocal = PyModule_GetDict(pNewMod);
+    PyObject *pValue = PyRun_String(source.c_str(), Py_file_input, pGlobal, pLocal);
+    if(pValue == (PyObject *) 0) return false;
+    Py_DECREF(pValue);
+
+    PyObject *pFunc = PyObject_GetAttrString(pNewMod, "PythonCalc");
+    if((pFunc == (PyObject *) 0) || (!PyCallable_Check(pFunc))) return false;
+
+    // as before, the floats created first and the globals were not released
+    PyObject *pArgs = PyTuple_New(MAXMONITORS);
+    for(int i=0; i< MAXMONITORS; i++) pValueA[i] = PyFloat_FromDouble(0.0);
+    for(int i=0; i< MAXMONITORS; i++) pValueA[i] = PyFloat_FromDouble(input(tick, calc, i));
+    for(int i=0; i < MAXMONITORS; i++)  PyTuple_SetItem(pArgs, i, pValueA[i]);
+
+    pValue = PyObject_CallObject(pFunc, pArgs);
+    if(pValue == (PyObject *) 0) return false;
+    sink += PyFloat_AsDouble(pValue);
+    Py_DECREF(pValue);
+    Py_DECREF(pArgs);
+    Py_XDECREF(pFunc);
+    Py_DECREF(pNewMod);
+    return true;
+}
+
+static bool compile(const std::string &source, const std::string &name, pythonCalc &calc)
+{
+    PyObject *pGlobal = PyDict_New();
+    PyDict_SetItemString(pGlobal, "__builtins__", PyEval_GetBuiltins());
+    PyObject *pNewMod = PyModule_New((char*) name.c_str());
+    PyModule_AddStringConstant(pNewMod, "__file__", "");
+    PyObject *pLocal = PyModule_GetDict(pNewMod);
+    PyObject *pValue = PyRun_String(source.c_str(), Py_file_input, pGlobal, pLocal);
+    Py_DECREF(pGlobal);
+    if(pValue == (PyObject *) 0) return false;
+    Py_DECREF(pValue);
+
+    PyObject *pFunc = PyObject_GetAttrString(pNewMod, "PythonCalc");
+    if((pFunc == (PyObject *) 0) || (!PyCallable_Check(pFunc))) return false;
+
+    calc.module = pNewMod;
+    calc.function = pFunc;
+    calc.arguments = PyTuple_New(MAXMONITORS);
+    for(int i=0; i< MAXMONITORS; i++) PyTuple_SetItem(calc.arguments, i, PyFloat_FromDouble(0.0));
+    return true;
+}
+
+// the kept function is called with its argument tuple
+static bool currentEval(pythonCalc &calc, int tick, int index)
+{
+    if(Py_REFCNT(calc.arguments) > 1) {
+        Py_DECREF(calc.arguments);
+        calc.arguments = PyTuple_New(MAXMONITORS);
+    }
+    for(int i=0; i < MAXMONITORS; i++)  PyTuple_SetItem(calc.arguments, i, PyFloat_FromDouble(input(tick, index, i)));
+
+    PyObject *pValue = PyObject_CallObject(calc.function, calc.arguments);
+    if(pValue == (PyObject *) 0) return false;
+    sink += PyFloat_AsDouble(pValue);
+    Py_DECREF(pValue);
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    int calcs = (argc > 1) ? atoi(argv[1]) : 500;
+    int ticks = (argc > 2) ? atoi(argv[2]) : 20;
+    if(calcs < 1 || ticks < 1) {
+        printf("usage: pythonCalcBench [calcs] [ticks]\n");
+        return 1;
+    }
+
+    Py_Initialize();
+    std::vector<std::string> sources, names;
+    for(int c = 0; c < calcs; c++) {
+        sources.push_back(calcSource(c));
+        names.push_back(moduleName(c));
+    }
+
+    printf("pythonCalcBench -- %d python calcs, %d ticks\n", calcs, ticks);
+
+    double start = now();
+    for(int t = 0; t < ticks; t++) {
+        for(int c = 0; c < calcs; c++) {
+            if(!formerEval(sources[c], names[c], t, c)) {
+                PyErr_Print();
+                return 1;
+            }
+        }
+    }
+    printf("   compiled on every call   %10.1f us/tick\n", (now() - start) / (double) ticks);
+
+    std::vector<pythonCalc> kept(calcs);
+    start = now();
+    for(int c = 0; c < calcs; c++) {
+        if(!compile(sources[c], names[c], kept[c])) {
+            PyErr_Print();
+            return 1;
+        }
+    }
+    printf("   compiled once            %10.1f us\n", now() - start);
+
+    start = now();
+    for(int t = 0; t < ticks; t++) {
+        for(int c = 0; c < calcs; c++) {
+            if(!currentEval(kept[c], t, c)) {
+                PyErr_Print();
+                return 1;
+            }
+        }
+    }
+    printf("   kept function and tuple  %10.1f us/tick\n", (now() - start) / (double) ticks);
+
+    for(int c = 0; c < calcs; c++) {
+        Py_XDECREF(kept[c].arguments);
+        Py_XDECREF(kept[c].function);
+        Py_XDECREF(kept[c].module);
+    }
+    printf("   (%g)\n", sink);
+    return 0;
+}
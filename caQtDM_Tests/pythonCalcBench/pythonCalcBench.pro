@@ -0,0 +1,20 @@
+# benchmark of the python calcs, not part of the build of caQtDM:
+#    qmake && make && ./pythonCalcBench
+# with the python environment of caQtDM_Env (PYTHONINCLUDE, PYTHONLIB, PYTHONVERSION)
+CONFIG += console
+CONFIG -= qt app_bundle
+TEMPLATE = app
+OBJECTS_DIR = obj
+
+unix:!macx {
+  INCLUDEPATH += $(PYTHONINCLUDE)
+  LIBS += -L$(PYTHONLIB) -Wl,-rpath,$(PYTHONLIB) -lpython$(PYTHONVERSION)
+}
+macx {
+  INCLUDEPATH += /System/Library/Frameworks/Python.framework/Versions/$(PYTHONVERSION)/include/python$(PYTHONVERSION)/
+  LIBS += -L/System/Library/Frameworks/Python.framework/Versions/$(PYTHONVERSION)/lib/ -lpython$(PYTHONVERSION)
+}
+
+SOURCES += pythonCalcBench.cpp
+
+TARGET = pythonCalcBench
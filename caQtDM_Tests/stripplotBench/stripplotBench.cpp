@@ -0,0 +1,151 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2014
+ *
+ *  Author:
+ *    Anton Mezger
+ *  Contact details:
+ *    anton.mezger@psi.ch
+ */
+
+// benchmark of one collection tick of caStripPlot: the ring buffer history with the sliding
+// extrema for the autoscale against the former QVector storage, where every tick prepended and
+// erased one point of every curve (for the fixed scale also rewriting every x value) and the
+// autoscale rescanned the whole history; the ring buffer is also measured with the copy of the
+// history formerly taken for drawing at every refresh, which the next write detached
+//    stripplotBench [history] [curves] [ticks]     defaults 100000 points, 7 curves, 500 ticks
+
+#include <QVector>
+#include <QElapsedTimer>
+#include <qwt_series_data.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "ringbuffer.h"
+#include "stripplotcurves.h"
+
+// results are summed up, so that the compiler cannot drop the work
+static double sink = 0.0;
+
+static double valueAt(int curve, qint64 tick)
+{
+    return (curve + 1) * sin(0.001 * (double) tick + curve);
+}
+
+static double formerTick(int history, int curves, int ticks, bool valueScale)
+{
+    QVector< QVector<QwtIntervalSample> > rangeData(curves);
+    QVector<QwtIntervalSample> base(history);
+    for(int c = 0; c < curves; c++) rangeData[c].resize(history);
+    QwtIntervalSample tmp;
+
+    QElapsedTimer timer;
+    timer.start();
+    for(qint64 t = 0; t < ticks; t++) {
+        double timeData = (double) t;
+
+        // shift data back
+        for(int c = 0; c < curves; c++) {
+            rangeData[c].prepend(tmp);
+            rangeData[c].erase(rangeData[c].end() - 1);
+        }
+        if(valueScale) {
+            base.prepend(tmp);
+            base.erase(base.end() - 1);
+            for(int i = history - 1; i > 0; i--) {
+                double value = base[i].value - timeData;
+                for(int c = 0; c < curves; c++) rangeData[c][i].value = value;
+            }
+        }
+
+        // update last point
+        for(int c = 0; c < curves; c++) {
+            double value = valueAt(c, t);
+            rangeData[c][0] = QwtIntervalSample(timeData, QwtInterval(value - 0.1, value + 0.1));
+        }
+        if(valueScale) base[0] = rangeData[0][0];
+
+        // autoscale over the whole history
+        double autoscaleMax = -INFINITY;
+        double autoscaleMin = INFINITY;
+        for(int c = 0; c < curves; c++) {
+            for(int i = 0; i < history; i++) {
+                const QwtInterval &interval = rangeData[c].at(i).interval;
+                if(!qIsNaN(interval.maxValue()) && interval.maxValue() > autoscaleMax) autoscaleMax = interval.maxValue();
+                if(!qIsNaN(interval.minValue()) && interval.minValue() < autoscaleMin) autoscaleMin = interval.minValue();
+            }
+        }
+        sink += autoscaleMax - autoscaleMin;
+    }
+    return (double) timer.nsecsElapsed() / 1000.0 / (double) ticks;
+}
+
+static double ringTick(int history, int curves, int ticks, bool drawnCopy)
+{
+    StripplotHistory data, drawn;
+    QVector<SlidingExtrema> extrema(curves);
+    data.reset(history, curves);
+    qint64 seq = 0;
+
+    // the history is filled first, so that the queues of the extrema are in their steady state
+    QElapsedTimer timer;
+    for(qint64 t = 0; t < history + ticks; t++) {
+        if(t == history) timer.start();
+
+        // copy shared with the history until the next write deep copies it
+        if(drawnCopy) drawn = data;
+
+        data.advance();
+        seq++;
+        data.setTime((double) t);
+        for(int c = 0; c < curves; c++) {
+            double value = valueAt(c, t);
+            data.setRange(c, QwtInterval(value - 0.1, value + 0.1));
+            extrema[c].add(seq, value - 0.1, value + 0.1);
+        }
+
+        double autoscaleMax = -INFINITY;
+        double autoscaleMin = INFINITY;
+        for(int c = 0; c < curves; c++) {
+            extrema[c].expire(seq - history + 1);
+            if(extrema[c].hasMaximum() && extrema[c].maximum() > autoscaleMax) autoscaleMax = extrema[c].maximum();
+            if(extrema[c].hasMinimum() && extrema[c].minimum() < autoscaleMin) autoscaleMin = extrema[c].minimum();
+        }
+        sink += autoscaleMax - autoscaleMin;
+    }
+    return (double) timer.nsecsElapsed() / 1000.0 / (double) ticks;
+}
+
+int main(int argc, char *argv[])
+{
+    int history = (argc > 1) ? atoi(argv[1]) : 100000;
+    int curves = (argc > 2) ? atoi(argv[2]) : 7;
+    int ticks = (argc > 3) ? atoi(argv[3]) : 500;
+    if(history < 1 || curves < 1 || ticks < 1) {
+        printf("usage: stripplotBench [history] [curves] [ticks]\n");
+        return 1;
+    }
+
+    printf("stripplotBench -- history of %d points, %d curves, %d ticks\n", history, curves, ticks);
+    printf("   prepend/erase, time scale   %10.1f us/tick\n", formerTick(history, curves, ticks, false));
+    printf("   prepend/erase, fixed scale  %10.1f us/tick\n", formerTick(history, curves, ticks, true));
+    printf("   ring buffer, drawing copy   %10.1f us/tick\n", ringTick(history, curves, ticks, true));
+    printf("   ring buffer                 %10.1f us/tick\n", ringTick(history, curves, ticks, false));
+    printf("   (%g)\n", sink);
+    return 0;
+}
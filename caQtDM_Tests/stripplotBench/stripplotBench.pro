@@ -0,0 +1,28 @@
+# benchmark of the caStripPlot history, not part of the build of caQtDM:
+#    qmake && make && ./stripplotBench
+# after caQtDM_QtControls was built, with the environment of caQtDM_Env
+include(../../caQtDM_Viewer/qtdefs.pri)
+
+contains(QT_VER_MAJ, 5) {
+  QT       += widgets
+}
+
+CONFIG += console
+TEMPLATE = app
+INCLUDEPATH += .
+INCLUDEPATH += ../../caQtDM_QtControls/src
+INCLUDEPATH += $(QWTINCLUDE)
+OBJECTS_DIR = obj
+
+unix:!macx {
+  LIBS += -L$(CAQTDM_COLLECT) -Wl,-rpath,$(CAQTDM_COLLECT) -lqtcontrols
+  LIBS += -L$(QWTLIB) -Wl,-rpath,$(QWTLIB) -l$$(QWTLIBNAME)
+}
+macx {
+  LIBS += -L$(CAQTDM_COLLECT) -lqtcontrols
+  LIBS += -F$(QWTLIB) -framework $$(QWTLIBNAME)
+}
+
+SOURCES += stripplotBench.cpp
+
+TARGET = stripplotBench
@@ -52,6 +52,11 @@ HEADERS  +=  \
     configDialog.h \
     pipereader.h
 
+!MOBILE {
+    SOURCES += displayconverter.cpp
+    HEADERS += displayconverter.h
+}
+
 FORMS += main.ui
 
 # when epics4 not build, then do not import statically in fileopenwindow.cpp
@@ -0,0 +1,18 @@
+include(../qtdefs.pri)
+CONFIG += caQtDM_xdl2ui
+include(../../caQtDM.pri)
+
+QT -= gui
+
+TEMPLATE = app
+INCLUDEPATH += .
+INCLUDEPATH += ../../caQtDM_QtControls/src
+MOC_DIR = moc
+
+# the image format is shared with the loader of caQtDM_QtControls
+DEFINES += DISPLAYIMAGE_STANDALONE
+HEADERS += ../../caQtDM_QtControls/src/displayimage.h
+SOURCES += ui2uib.cpp \
+    ../../caQtDM_QtControls/src/displayimage.cpp
+
+TARGET = ui2uib
@@ -0,0 +1,111 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2014
+ *
+ *  Author:
+ *    Anton Mezger
+ *  Contact details:
+ *    anton.mezger@psi.ch
+ */
+
+// compiler of display files into display images (.uib) loaded by caQtDM without xml parsing
+// medm (.adl) and edm (.edl) files are first translated with adl2ui and edl2ui
+
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QProcess>
+#include <QStringList>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "displayimage.h"
+
+// the translators are searched beside this program first, then in the path
+static QString translator(const QString &name)
+{
+    QString program = QCoreApplication::applicationDirPath() + "/" + name;
+    if(QFileInfo(program).exists() || QFileInfo(program + ".exe").exists()) return program;
+    return name;
+}
+
+static bool compileFile(const QString &inputFile)
+{
+    QString uiFile = inputFile;
+    QFileInfo fi(inputFile);
+
+    if(!fi.exists()) {
+        printf("ui2uib -- file %s does not exist\n", inputFile.toLatin1().constData());
+        return false;
+    }
+
+    // translated files are generated in the current directory
+    if(fi.suffix() == "adl" || fi.suffix() == "edl") {
+        QString program = translator((fi.suffix() == "adl") ? "adl2ui" : "edl2ui");
+        if(QProcess::execute(program, QStringList() << inputFile) != 0) {
+            printf("ui2uib -- %s could not translate %s\n", program.toLatin1().constData(), inputFile.toLatin1().constData());
+            return false;
+        }
+        uiFile = fi.completeBaseName() + ".ui";
+    } else if(fi.suffix() != "ui") {
+        printf("ui2uib -- %s is not a display file\n", inputFile.toLatin1().constData());
+        return false;
+    }
+
+    QString error;
+    QString imageFile = DisplayImage::imageName(uiFile);
+    if(!DisplayImage::compile(uiFile, imageFile, error)) {
+        printf("ui2uib -- %s not compiled: %s, caQtDM will load the ui file\n", uiFile.toLatin1().constData(), error.toLatin1().constData());
+        return false;
+    }
+    printf("ui2uib -- %s compiled into %s\n", uiFile.toLatin1().constData(), imageFile.toLatin1().constData());
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QStringList files;
+
+    for(int in = 1; in < argc; in++) {
+        if(strcmp(argv[in], "-v") == 0) {
+            printf("ui2uib version %s for %s\n", BUILDVERSION, BUILDARCH);
+            exit(0);
+        }
+        if(!strcmp(argv[in], "-help") || !strcmp(argv[in], "-h") || !strcmp(argv[in], "-?")) {
+            printf("Usage:\n ui2uib [-v] file...\n");
+            printf("files may be .ui, .adl or .edl files, the image is written beside the ui file\n");
+            exit(1);
+        }
+        if(strncmp(argv[in], "-", 1) == 0) {
+            printf("ui2uib -- Argument %d = [%s] is unknown!\n", in, argv[in]);
+            exit(-1);
+        }
+        files.append(QString::fromLocal8Bit(argv[in]));
+    }
+
+    if(files.isEmpty()) {
+        printf("ui2uib -- sorry: no input file\n");
+        exit(-1);
+    }
+
+    int failed = 0;
+    foreach(QString file, files) {
+        if(!compileFile(file)) failed++;
+    }
+    return (failed > 0) ? 1 : 0;
+}
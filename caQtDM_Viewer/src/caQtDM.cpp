@@ -34,9 +34,16 @@
 
 #include "fileopenwindow.h"
 #include "fileFunctions.h"
+#include "displaytrace.h"
+#include "displaypathindex.h"
+#include "fileprefetcher.h"
+#ifndef MOBILE
+#include "displayconverter.h"
+#endif
 #include "QDebug"
 #include <QFileDialog>
 #include <QLocale>
+#include <QThread>
 #include <signal.h>
 #include <iostream>
 #include <stdlib.h>
@@ -165,6 +172,9 @@ int main(int argc, char *argv[])
     bool minimize= false;
     bool printscreen = false;
     bool resizing = true;
+    QString convertDir = "";
+    int convertJobs = QThread::idealThreadCount();
+    bool convertForce = false;
 
     for (numargs = argc, in = 1; in < numargs; in++) {
         qDebug() << argv[in];
@@ -211,13 +221,20 @@ int main(int argc, char *argv[])
                    "  [-cs defaultcontrolsystempluginname]\n"
                    "  [-option \"xxx=aaa,yyy=bbb, ...\"] options for cs plugins,\n"
                    "  \t e.g. -option \"updatetype=direct\" will set the updatetype to Direct\n"
+                   "  \t -option \"activation=lazy\" will create the channels of hidden tab pages and includes when they become visible,\n"
+                   "  \t\t prefetch=n will create them anyway for n pages around the actual one\n"
                    "  \t options for bsread:\n "
                    "  \t\t bsmodulo,bsoffset,\n"
                    "  \t\t bsinconsistency(drop|keep-as-is|adjust-individual|adjust-global),\n"
                    "  \t\t bsmapping(provide-as-is|drop|fill-null)\n"
                    "  \t\t bsstrategy(complete-all|complete-latest)\n"
                    "  [-url url] will look for files on the specified url and download them to a local directory\n"
-                   "  [-emptycache] will empty the local cache used for downloading"
+                   "  [-emptycache] will empty the local cache used for downloading\n"
+                   "  [-convert directory] will convert the adl and edl files of the directory tree to ui files and exit,\n"
+                   "  \t ui files that were not generated by a conversion or were edited afterwards are left untouched\n"
+                   "  [-force] -convert will also replace the ui files left untouched otherwise, when older than their source\n"
+                   "  [-jobs n] number of converters running in parallel for -convert, default the number of cores\n"
+                   "  [-trace filename] will write the timing of the opening of all displays as chrome trace events to the file\n"
                    "  [file]\n"
                    "  [&]\n"
                    "\n"
@@ -246,6 +263,17 @@ int main(int argc, char *argv[])
             path.append("/");
             filefunction.removeFilesInTree(path);
             printf("caQtDM -- cache @ %s with ui & graphic files has been emptied\n", qasc(path));
+        } else if(!strcmp(argv[in], "-trace")) {
+            in++;
+            DisplayTrace::enable(QString(argv[in]));
+        } else if(!strcmp(argv[in], "-convert")) {
+            in++;
+            convertDir = QString(argv[in]);
+        } else if(!strcmp(argv[in], "-force")) {
+            convertForce = true;
+        } else if(!strcmp(argv[in], "-jobs")) {
+            in++;
+            convertJobs = atoi(argv[in]);
         } else if(!strcmp(argv[in], "-cs")) {
             in++;
             options.insert("defaultPlugin", QString(argv[in]));
@@ -255,7 +283,7 @@ int main(int argc, char *argv[])
             createMap(options, QString(argv[in]));
         } else if (strncmp (argv[in], "-" , 1) == 0) {
             /* unknown application argument */
-            printf("caQtDM -- Argument %d = [%s] is unknown!, possible -attach -macro -noMsg -stylefile -dg -x -print -httpconfig -noResize -option\n",in,argv[in]);
+            printf("caQtDM -- Argument %d = [%s] is unknown!, possible -attach -macro -noMsg -stylefile -dg -x -print -httpconfig -noResize -option -trace -convert -force -jobs\n",in,argv[in]);
         } else {
             printf("caQtDM -- file = <%s>\n", argv[in]);
             fileName = QString(argv[in]);
@@ -263,6 +291,15 @@ int main(int argc, char *argv[])
         }
     }
 
+#ifndef MOBILE
+    // batch conversion of legacy displays
+    if(convertDir.length() > 0) {
+        DisplayConverter converter;
+        converter.convertTree(convertDir, convertJobs, convertForce);
+        exit(converter.failed() > 0 ? 1 : 0);
+    }
+#endif
+
     // get data from pipe if any (ui data can be piped to this application, for linux at this time)
     // only when no file is given, attaching is not allowed, in order to get rid of the temporary file when exit
 #if defined linux || defined TARGET_OS_MAC
@@ -336,6 +373,11 @@ int main(int argc, char *argv[])
     }
 #endif
 
+    // the display path index and the prefetcher are shared with the thread of the prefetcher, they are created
+    // here in the gui thread
+    displayPathIndex::instance();
+    filePrefetcher::instance();
+
     FileOpenWindow window (0, fileName, macroString, attach, minimize, geometry, printscreen, resizing, options);
     window.setWindowIcon (QIcon(":/caQtDM.ico"));
     window.show();
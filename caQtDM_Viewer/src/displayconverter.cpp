@@ -0,0 +1,227 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2014
+ *
+ *  Author:
+ *    Anton Mezger
+ *  Contact details:
+ *    anton.mezger@psi.ch
+ */
+
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDirIterator>
+#include <QCryptographicHash>
+#include "displayconverter.h"
+#include "displaypathindex.h"
+
+#define INDEXFILE "caQtDM_conversions.ini"
+
+DisplayConverter::DisplayConverter(QObject *parent) : QObject(parent)
+{
+    Loop = (QEventLoop *) 0;
+    Jobs = 1;
+    Force = false;
+    Converted = Skipped = Untouched = Failed = 0;
+}
+
+DisplayConverter::~DisplayConverter()
+{
+    QHashIterator<QProcess*, QString> i(Running);
+    while (i.hasNext()) {
+        i.next();
+        i.key()->kill();
+        i.key()->waitForFinished(1000);
+        delete i.key();
+    }
+    qDeleteAll(Indexes);
+}
+
+QString DisplayConverter::converterFor(const QString &sourceFile)
+{
+    if(sourceFile.endsWith(".adl")) return "adl2ui";
+    if(sourceFile.endsWith(".edl")) return "edl2ui";
+    return QString();
+}
+
+QString DisplayConverter::outputFor(const QString &sourceFile)
+{
+    QString output = sourceFile;
+    output.chop(4);
+    return output.append(".ui");
+}
+
+QByteArray DisplayConverter::fileHash(const QString &file)
+{
+    QFile f(file);
+    if(!f.open(QIODevice::ReadOnly)) return QByteArray();
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    while(!f.atEnd()) hash.addData(f.read(65536));
+    return hash.result().toHex();
+}
+
+// one index per directory, kept open for the conversion of a whole tree
+QSettings *DisplayConverter::indexFor(const QString &sourceFile)
+{
+    QString dir = QFileInfo(sourceFile).absolutePath();
+    QSettings *index = Indexes.value(dir, (QSettings *) 0);
+    if(index == (QSettings *) 0) {
+        index = new QSettings(dir + "/" + INDEXFILE, QSettings::IniFormat);
+        Indexes.insert(dir, index);
+    }
+    return index;
+}
+
+DisplayConverter::State DisplayConverter::state(const QString &sourceFile)
+{
+    QFileInfo source(sourceFile);
+    QFileInfo output(outputFor(sourceFile));
+    bool writable = QFileInfo(source.absolutePath()).isWritable();
+    if(!output.exists()) return writable ? Missing : ReadOnly;
+    if(output.lastModified() >= source.lastModified()) return UpToDate;
+
+    // only a file the index knows as generated and unchanged since may be replaced
+    QSettings *index = indexFor(sourceFile);
+    QString key = "files/" + source.fileName();
+    QByteArray sourceHash = index->value(key + "/source").toByteArray();
+    QByteArray outputHash = index->value(key + "/output").toByteArray();
+    if(sourceHash.isEmpty() || outputHash.isEmpty()) return Untracked;
+    if(outputHash != fileHash(output.absoluteFilePath())) return Edited;
+    if(sourceHash == fileHash(source.absoluteFilePath())) return UpToDate;
+    return writable ? Stale : ReadOnly;
+}
+
+// the converters write their output into the working directory
+QProcess *DisplayConverter::startConverter(const QString &sourceFile)
+{
+    QFileInfo fi(sourceFile);
+    QProcess *process = new QProcess(this);
+    process->setWorkingDirectory(fi.absolutePath());
+    process->setProcessChannelMode(QProcess::MergedChannels);
+    connect(process, SIGNAL(finished(int, QProcess::ExitStatus)), this, SLOT(converterFinished(int, QProcess::ExitStatus)));
+    connect(process, SIGNAL(error(QProcess::ProcessError)), this, SLOT(converterError(QProcess::ProcessError)));
+    Running.insert(process, fi.absoluteFilePath());
+    process->start(converterFor(sourceFile), QStringList() << fi.fileName());
+    return process;
+}
+
+void DisplayConverter::finishConversion(QProcess *process, bool ok)
+{
+    if(!Running.contains(process)) return;
+    QString sourceFile = Running.take(process);
+    QString output = outputFor(sourceFile);
+
+    // the converters do not always report their errors by the exit code
+    if(ok && !QFileInfo(output).exists()) ok = false;
+
+    if(ok) {
+        QSettings *index = indexFor(sourceFile);
+        QString key = "files/" + QFileInfo(sourceFile).fileName();
+        index->setValue(key + "/source", fileHash(sourceFile));
+        index->setValue(key + "/output", fileHash(output));
+        // a tree writes its indexes at the end
+        if(Loop == (QEventLoop *) 0) index->sync();
+        displayPathIndex::instance()->refresh(QFileInfo(output).absolutePath());
+        Converted++;
+    } else {
+        QString messages = QString::fromLocal8Bit(process->readAll()).trimmed();
+        LastError = QString("%1 could not be converted by %2: %3").arg(sourceFile).arg(converterFor(sourceFile)).arg(messages.isEmpty() ? process->errorString() : messages);
+        printf("caQtDM -- %s\n", qPrintable(LastError));
+        Failed++;
+    }
+    process->deleteLater();
+    emit conversionDone(sourceFile, ok);
+
+    startNext();
+    if(Running.isEmpty() && Pending.isEmpty() && (Loop != (QEventLoop *) 0)) Loop->quit();
+}
+
+void DisplayConverter::converterFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    QProcess *process = qobject_cast<QProcess *>(sender());
+    if(process == (QProcess *) 0) return;
+    finishConversion(process, (exitStatus == QProcess::NormalExit) && (exitCode == 0));
+}
+
+void DisplayConverter::converterError(QProcess::ProcessError error)
+{
+    // a converter that started will still report its end by finished
+    if(error != QProcess::FailedToStart) return;
+    QProcess *process = qobject_cast<QProcess *>(sender());
+    if(process == (QProcess *) 0) return;
+    finishConversion(process, false);
+}
+
+void DisplayConverter::startNext()
+{
+    while((Running.count() < Jobs) && !Pending.isEmpty()) {
+        QString sourceFile = Pending.takeFirst();
+        State current = state(sourceFile);
+        if(needsConversion(current) || (Force && keptOutdated(current))) {
+            startConverter(sourceFile);
+        } else if(current == UpToDate) {
+            Skipped++;
+        } else {
+            static const char *reasons[] = {"", "", "", "was not generated by a conversion", "was edited after its conversion", "is in a read only directory"};
+            printf("caQtDM -- %s left untouched although older than its source, it %s%s\n", qPrintable(outputFor(sourceFile)), reasons[current],
+                   keptOutdated(current) ? " (use -force to convert it anyway)" : "");
+            Untouched++;
+        }
+    }
+}
+
+void DisplayConverter::convertLater(const QString &sourceFile)
+{
+    QString source = QFileInfo(sourceFile).absoluteFilePath();
+    if(converterFor(source).isEmpty() || isConverting(source)) return;
+    startConverter(source);
+}
+
+bool DisplayConverter::isConverting(const QString &sourceFile) const
+{
+    QString source = QFileInfo(sourceFile).absoluteFilePath();
+    QHashIterator<QProcess*, QString> i(Running);
+    while (i.hasNext()) {
+        i.next();
+        if(i.value() == source) return true;
+    }
+    return false;
+}
+
+void DisplayConverter::convertTree(const QString &dir, int jobs, bool force)
+{
+    Jobs = qMax(jobs, 1);
+    Force = force;
+    Pending.clear();
+
+    QDirIterator it(dir, QStringList() << "*.adl" << "*.edl", QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) Pending.append(it.next());
+    printf("caQtDM -- %d legacy displays found in <%s>, converting with %d converters\n", Pending.count(), qPrintable(dir), Jobs);
+
+    startNext();
+    if(!Running.isEmpty()) {
+        QEventLoop loop;
+        Loop = &loop;
+        loop.exec();
+        Loop = (QEventLoop *) 0;
+    }
+
+    foreach(QSettings *index, Indexes) index->sync();
+    printf("caQtDM -- %d displays converted, %d up to date, %d left untouched, %d failed\n", Converted, Skipped, Untouched, Failed);
+}
@@ -0,0 +1,102 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2014
+ *
+ *  Author:
+ *    Anton Mezger
+ *  Contact details:
+ *    anton.mezger@psi.ch
+ */
+
+
+#ifndef DISPLAYCONVERTER_H
+#define DISPLAYCONVERTER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QProcess>
+#include <QEventLoop>
+#include <QSettings>
+
+// conversion of legacy medm (.adl) and edm (.edl) displays to .ui files by the adl2ui and edl2ui converters
+// the .ui file is written next to its source; the hashes of the source and of the generated file are kept in
+// the index caQtDM_conversions.ini of that directory. a display is converted when its .ui file is missing, or
+// when the .ui file is older than a changed source and the index proves it is still the generated one; .ui
+// files made or edited by hand are only overwritten when forced. a tree is converted by a pool of converters,
+// a single display in the background while the viewer goes on.
+
+class DisplayConverter : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum State {Missing = 0, Stale, UpToDate, Untracked, Edited, ReadOnly};
+
+    DisplayConverter(QObject *parent = 0);
+    ~DisplayConverter();
+
+    // converter program for a source file, empty when not a legacy display
+    static QString converterFor(const QString &sourceFile);
+    static QString outputFor(const QString &sourceFile);
+
+    State state(const QString &sourceFile);
+    static bool needsConversion(State state) { return (state == Missing) || (state == Stale); }
+    // a ui file older than its source, that is not replaced unless forced
+    static bool keptOutdated(State state) { return (state == Untracked) || (state == Edited); }
+
+    // start the converter for one display, conversionDone is emitted when it ended
+    void convertLater(const QString &sourceFile);
+    bool isConverting(const QString &sourceFile) const;
+
+    // convert all legacy displays of a directory tree with the given number of concurrent converters,
+    // forced also the ones whose ui file was not generated by a conversion or was edited
+    void convertTree(const QString &dir, int jobs, bool force = false);
+
+    int converted() const { return Converted; }
+    int skipped() const { return Skipped; }
+    int untouched() const { return Untouched; }
+    int failed() const { return Failed; }
+    QString lastError() const { return LastError; }
+
+signals:
+    void conversionDone(const QString &sourceFile, bool ok);
+
+private slots:
+    void converterFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void converterError(QProcess::ProcessError error);
+
+private:
+    void startNext();
+    QProcess *startConverter(const QString &sourceFile);
+    void finishConversion(QProcess *process, bool ok);
+    QSettings *indexFor(const QString &sourceFile);
+    static QByteArray fileHash(const QString &file);
+
+    QStringList Pending;
+    QHash<QProcess*, QString> Running;
+    QHash<QString, QSettings*> Indexes;
+    QEventLoop *Loop;
+    int Jobs;
+    bool Force;
+    int Converted, Skipped, Untouched, Failed;
+    QString LastError;
+};
+
+#endif // DISPLAYCONVERTER_H
@@ -53,6 +53,9 @@ bool HTTPCONFIGURATOR = false;
 #include <QString>
 #include "messagebox.h"
 #include "configDialog.h"
+#ifndef MOBILE
+#include "displayconverter.h"
+#endif
 
 #ifdef linux
 #include <sys/resource.h>
@@ -264,6 +267,14 @@ FileOpenWindow::FileOpenWindow(QMainWindow* parent,  QString filename, QString m
     connect( this->ui.emptycacheAction, SIGNAL( triggered() ), this, SLOT(Callback_EmptyCache()) );
     this->ui.timedAction->setChecked(true);
 
+    // legacy displays are converted in the background when opened
+#ifndef MOBILE
+    converter = new DisplayConverter(this);
+    connect(converter, SIGNAL(conversionDone(const QString&, bool)), this, SLOT(Callback_ConversionDone(const QString&, bool)));
+#else
+    converter = (DisplayConverter *) 0;
+#endif
+
     setWindowTitle(title);
 
     // is updatetype specified on the command line as option, then set action direct and remove it
@@ -966,6 +977,7 @@ void FileOpenWindow::Callback_OpenNewFile(const QString& inputFile, const QStrin
     int found1 = inputFile.lastIndexOf(".ui");
     int found2 = inputFile.lastIndexOf(".adl");
     int found3 = inputFile.lastIndexOf(".prc");
+    int found4 = inputFile.lastIndexOf(".edl");
     QString openFile = inputFile;
     if (found1 != -1) {
         openFile = inputFile.mid(0, found1);
@@ -973,6 +985,9 @@ void FileOpenWindow::Callback_OpenNewFile(const QString& inputFile, const QStrin
     if(found2 != -1) {
         openFile = inputFile.mid(0, found2);
     }
+    if(found4 != -1) {
+        openFile = inputFile.mid(0, found4);
+    }
 
     QString FileName;
     if(found3 == -1)
@@ -1038,6 +1053,41 @@ void FileOpenWindow::Callback_OpenNewFile(const QString& inputFile, const QStrin
         }
     }
 
+#ifndef MOBILE
+    // a legacy display is converted to its ui file when this one is missing or was generated from an older
+    // source; the display is opened when the converter running in the background is done
+    if((found2 != -1) || (found4 != -1)) {
+        searchFile *source = new searchFile(inputFile);
+        QString sourceFound = source->findFile();
+        delete source;
+        if(!sourceFound.isNull()) {
+            QString sourceKey = QFileInfo(sourceFound).absoluteFilePath() + "@" + QString::number(QFileInfo(sourceFound).lastModified().toTime_t());
+            DisplayConverter::State state = converter->state(sourceFound);
+            if(!conversionFailed.contains(sourceKey) && DisplayConverter::keptOutdated(state) && !converter->isConverting(sourceFound)) {
+                QString message = QString("%1 is older than %2 but is not converted again, as it was %3; use caQtDM -convert with -force to replace it")
+                        .arg(DisplayConverter::outputFor(sourceFound)).arg(sourceFound)
+                        .arg(state == DisplayConverter::Untracked ? "not generated by a conversion" : "edited after its conversion");
+                messageWindow->postMsgEvent(QtWarningMsg, (char*) qasc(message));
+            }
+            if(!conversionFailed.contains(sourceKey) &&
+               (converter->isConverting(sourceFound) || DisplayConverter::needsConversion(state))) {
+                WaitingOpen waiting;
+                waiting.file = inputFile;
+                waiting.macro = macroString;
+                waiting.geometry = geometry;
+                waiting.resize = resizeString;
+                conversionWaiting.insert(QFileInfo(sourceFound).absoluteFilePath(), waiting);
+                if(!converter->isConverting(sourceFound)) {
+                    QString message = QString("%1 is being converted to %2").arg(sourceFound).arg(DisplayConverter::outputFor(sourceFound));
+                    messageWindow->postMsgEvent(QtDebugMsg, (char*) qasc(message));
+                    converter->convertLater(sourceFound);
+                }
+                return;
+            }
+        }
+    }
+#endif
+
     // this will check for file existence and when an url is defined, download the file from a http server
     fileFunctions filefunction;
     filefunction.checkFileAndDownload(FileName);
@@ -1063,6 +1113,32 @@ void FileOpenWindow::Callback_OpenNewFile(const QString& inputFile, const QStrin
     delete s;
 }
 
+/**
+ * slot for the end of the conversion of a legacy display, opens the displays waiting for it
+ */
+void FileOpenWindow::Callback_ConversionDone(const QString& sourceFile, bool ok)
+{
+#ifndef MOBILE
+    if(ok) {
+        QString message = QString("%1 converted to %2").arg(sourceFile).arg(DisplayConverter::outputFor(sourceFile));
+        messageWindow->postMsgEvent(QtWarningMsg, (char*) qasc(message));
+    } else {
+        // reported once, not converted again as long as the source does not change
+        conversionFailed.insert(sourceFile + "@" + QString::number(QFileInfo(sourceFile).lastModified().toTime_t()));
+        messageWindow->postMsgEvent(QtCriticalMsg, (char*) qasc(converter->lastError()));
+    }
+
+    QList<WaitingOpen> waiting = conversionWaiting.values(sourceFile);
+    conversionWaiting.remove(sourceFile);
+    for(int i = waiting.count() - 1; i >= 0; i--) {
+        Callback_OpenNewFile(waiting.at(i).file, waiting.at(i).macro, waiting.at(i).geometry, waiting.at(i).resize);
+    }
+#else
+    Q_UNUSED(sourceFile);
+    Q_UNUSED(ok);
+#endif
+}
+
 /**
  * slot for icon signal
  */
@@ -40,6 +40,7 @@
 #include <QTableWidget>
 #include <QScrollBar>
 #include <QFile>
+#include <QSet>
 
 #ifdef MOBILE
 #include <QGuiApplication>
@@ -62,6 +63,8 @@
     int setenv(const char *name, const char *value, int overwrite);
 #endif
 
+class DisplayConverter;
+
 #define RingSize 50
 #define BlopSize 4096
     struct _blop {
@@ -225,6 +228,7 @@
      void Callback_ActionUnconnected();
      void Callback_EmptyCache();
      void Callback_OpenNewFile(const QString&, const QString&, const QString&, const QString&);
+     void Callback_ConversionDone(const QString&, bool);
      void checkForMessage();
      void Callback_PVwindowExit();
 
@@ -293,6 +297,12 @@ private:
 
      QList<Row> reloadList;
 
+     // displays opened when the conversion of their legacy source ended
+     struct WaitingOpen {QString file; QString macro; QString geometry; QString resize;};
+     QMultiMap<QString, WaitingOpen> conversionWaiting;
+     QSet<QString> conversionFailed;
+     DisplayConverter *converter;
+
      double caQtDM_TimeLeft, caQtDM_TimeOut;
      bool caQtDM_TimeOutEnabled;
 